@@ -5,11 +5,9 @@ TARGET = TSAScreen
 TEMPLATE = app
 
 SOURCES += \
-    src/main.cpp \
-    src/diagramwidget.cpp
+    src/main.cpp
 
-HEADERS += \
-    src/diagramwidget.h
+include(src/src.pri)
 
 # Ensure we're using Qt 5.14.0
 QT_VERSION = 5.14.0
@@ -18,4 +16,4 @@ QT_VERSION = 5.14.0
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x050E00
 
 # Keep output tidy
-QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic 
\ No newline at end of file
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic 
@@ -0,0 +1,17 @@
+QT += core gui
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench_arrows
+TEMPLATE = app
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/arrowbatch.cpp
+
+HEADERS += \
+    ../../src/arrowbatch.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic
@@ -0,0 +1,106 @@
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QtMath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "arrowbatch.h"
+
+/**
+ * @brief One leader, as drawn before batching
+ */
+struct Leader
+{
+    QPointF from;
+    double course;
+    qreal length;
+    QColor color;
+};
+
+/**
+ * @brief Per-arrow path: pen, brush, line and polygon for every arrow
+ */
+static void drawImmediate(QPainter &p, const QVector<Leader> &leaders)
+{
+    for (const Leader &l : leaders) {
+        const double c = qDegreesToRadians(l.course);
+        const QPointF to = l.from + QPointF(qSin(c), -qCos(c)) * l.length;
+        p.setPen(QPen(l.color, 1, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        p.drawLine(l.from, to);
+
+        const qreal angle = qAtan2(to.y() - l.from.y(), to.x() - l.from.x());
+        const qreal a1 = angle + qDegreesToRadians(180.0 - 25.0);
+        const qreal a2 = angle - qDegreesToRadians(180.0 - 25.0);
+        QPolygonF head;
+        head << to << QPointF(to.x() + 5 * qCos(a1), to.y() + 5 * qSin(a1))
+             << QPointF(to.x() + 5 * qCos(a2), to.y() + 5 * qSin(a2));
+        p.setBrush(l.color);
+        p.drawPolygon(head);
+    }
+}
+
+/**
+ * @brief Batched path: layout into an ArrowBatch, one draw per style
+ */
+static void drawBatched(QPainter &p, const QVector<Leader> &leaders, ArrowBatch &batch)
+{
+    batch.clear();
+    for (const Leader &l : leaders)
+        batch.addCourse(l.from, l.course, l.length, 5, 25, l.color, 1);
+    batch.draw(p);
+}
+
+/**
+ * @brief Frame-time benchmark for contact velocity leaders
+ *
+ * Draws the same fixed-seed set of leaders (in a few colours) into an
+ * offscreen QImage one arrow at a time and through ArrowBatch, and
+ * reports the mean time per frame.
+ *
+ * Usage: bench_arrows [arrows] [frames] [colours]
+ */
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    const int arrows  = argc > 1 ? std::atoi(argv[1]) : 5000;
+    const int frames  = argc > 2 ? std::atoi(argv[2]) : 100;
+    const int colours = argc > 3 ? qMax(1, std::atoi(argv[3])) : 4;
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> x(0, 1920), y(0, 1080), course(0, 360), length(6, 60);
+    QVector<Leader> leaders(arrows);
+    for (int i = 0; i < arrows; ++i) {
+        const int hue = (i % colours) * 360 / colours;
+        leaders[i] = { QPointF(x(rng), y(rng)), course(rng), length(rng), QColor::fromHsv(hue, 255, 255) };
+    }
+
+    QImage target(1920, 1080, QImage::Format_ARGB32_Premultiplied);
+    ArrowBatch batch;
+    std::printf("arrows=%d frames=%d colours=%d\n", arrows, frames, colours);
+    double immediate_us = 0.0;
+    for (bool batched : { false, true }) {
+        QElapsedTimer clock;
+        clock.start();
+        for (int i = 0; i < frames; ++i) {
+            target.fill(Qt::black);
+            QPainter p(&target);
+            p.setRenderHint(QPainter::Antialiasing);
+            if (batched)
+                drawBatched(p, leaders, batch);
+            else
+                drawImmediate(p, leaders);
+        }
+        const double us = clock.nsecsElapsed() / 1000.0 / frames;
+        if (!batched)
+            immediate_us = us;
+
+        std::printf("%-9s %9.1f us/frame  %6.2fx\n",
+                    batched ? "batched" : "immediate", us, immediate_us / us);
+    }
+    return 0;
+}
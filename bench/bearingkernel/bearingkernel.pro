@@ -0,0 +1,17 @@
+QT -= core gui
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench_bearingkernel
+TEMPLATE = app
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/bearingkernel.cpp
+
+HEADERS += \
+    ../../src/bearingkernel.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic
@@ -0,0 +1,13 @@
+TEMPLATE = subdirs
+
+# Microbenchmarks for the TSA Screen hot paths (not part of the app build)
+SUBDIRS += \
+    arrows \
+    bearingkernel \
+    ekf \
+    geometry \
+    halfplane \
+    render \
+    sensor \
+    spatial \
+    tma
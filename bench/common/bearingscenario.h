@@ -0,0 +1,150 @@
+#ifndef BEARINGSCENARIO_H
+#define BEARINGSCENARIO_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * @file bearingscenario.h
+ * @brief Shared setup of the bearings-only tracker benchmarks (bench_tma, bench_ekf)
+ *
+ * Random constant-velocity contacts observed from an own ship that
+ * zig-zags between north and east every 15 minutes (range is only
+ * observable after a manoeuvre), with optional Gaussian bearing noise.
+ */
+
+/**
+ * @brief Command line of a tracker benchmark: [contacts] [ticks] [step_sec] [bearing_sigma_deg]
+ */
+struct BearingBenchArgs
+{
+    int count;                        ///< Contacts
+    int ticks;                        ///< Bearing scans
+    double step_sec;                  ///< Time between scans (seconds)
+    double sigma_deg;                 ///< Bearing noise (degrees, 1 sigma)
+
+    BearingBenchArgs(int argc, char *argv[], double default_sigma_deg)
+        : count(argc > 1 ? std::atoi(argv[1]) : 500),
+          ticks(argc > 2 ? std::atoi(argv[2]) : 5400),
+          step_sec(argc > 3 ? std::atof(argv[3]) : 2.0),
+          sigma_deg(argc > 4 ? std::atof(argv[4]) : default_sigma_deg) {}
+};
+
+/**
+ * @brief True contacts, own ship and the bearings of the current tick
+ */
+class BearingScenario
+{
+public:
+    static constexpr double kPi = 3.14159265358979323846;
+
+    /**
+     * @brief Places count random contacts (positions within 15 nm, 3-15 knots)
+     */
+    BearingScenario(int count, double step_sec, double sigma_deg)
+        : x(count), y(count), vx(count), vy(count), bearing(count),
+          own_x(0.0), own_y(0.0), step(step_sec), sigma(sigma_deg), rng(42)
+    {
+        std::uniform_real_distribution<double> pos(-15.0, 15.0);
+        std::uniform_real_distribution<double> heading(0.0, 2.0 * kPi);
+        std::uniform_real_distribution<double> knots(3.0, 15.0);
+        for (int i = 0; i < count; ++i) {
+            x[i] = pos(rng);
+            y[i] = pos(rng);
+            const double c = heading(rng), s = knots(rng);
+            vx[i] = s * std::sin(c);
+            vy[i] = s * std::cos(c);
+        }
+    }
+
+    int size() const { return int(x.size()); }
+
+    /**
+     * @brief Moves everything to tick k (k counts up from 0) and measures the bearings
+     * @return Time of the tick (seconds)
+     */
+    double advance(int k)
+    {
+        const double t = k * step;
+        const double dt_h = step / 3600.0;
+        const int count = size();
+        if (k > 0) {
+            const bool north = std::fmod(t / 3600.0, 0.5) < 0.25;
+            own_x += (north ? 0.0 : 10.0) * dt_h;
+            own_y += (north ? 10.0 : 0.0) * dt_h;
+            for (int i = 0; i < count; ++i) {
+                x[i] += vx[i] * dt_h;
+                y[i] += vy[i] * dt_h;
+            }
+        }
+        for (int i = 0; i < count; ++i) {
+            bearing[i] = std::atan2(x[i] - own_x, y[i] - own_y) * 180.0 / kPi;
+            if (sigma > 0.0)
+                bearing[i] += sigma * noise(rng);
+        }
+        return t;
+    }
+
+    double range(int i) const { return std::hypot(x[i] - own_x, y[i] - own_y); } ///< True range (nm)
+    double speed(int i) const { return std::hypot(vx[i], vy[i]); }              ///< True speed (knots)
+
+    /**
+     * @brief True course of a contact (degrees, 0-360)
+     */
+    double course(int i) const
+    {
+        const double c = std::atan2(vx[i], vy[i]) * 180.0 / kPi;
+        return c < 0.0 ? c + 360.0 : c;
+    }
+
+    std::vector<double> x, y;         ///< True contact positions (nm)
+    std::vector<double> vx, vy;       ///< True contact velocities (knots)
+    std::vector<double> bearing;      ///< Measured bearings of the current tick (degrees)
+    double own_x, own_y;              ///< Own ship position (nm)
+
+private:
+    double step;                      ///< Time between ticks (seconds)
+    double sigma;                     ///< Bearing noise (degrees)
+    std::mt19937_64 rng;              ///< Contacts, then the noise of every tick
+    std::normal_distribution<double> noise{0.0, 1.0};
+};
+
+/**
+ * @brief Angle between two courses (degrees, 0-180)
+ */
+inline double courseDifference(double a, double b)
+{
+    const double d = std::fabs(std::fmod(a - b + 720.0, 360.0));
+    return std::min(d, 360.0 - d);
+}
+
+/**
+ * @brief Median of a sample (reorders it), 0 for an empty one
+ */
+inline double median(std::vector<double> &v)
+{
+    if (v.empty())
+        return 0.0;
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    return v[v.size() / 2];
+}
+
+/**
+ * @brief Prints the header and timing lines shared by the tracker benchmarks
+ * @param args Benchmark arguments
+ * @param update_ns Total time of the timed calls (nanoseconds)
+ */
+inline void printTrackerTiming(const BearingBenchArgs &args, double update_ns)
+{
+    const double tick_us = update_ns / args.ticks / 1000.0;
+    std::printf("contacts=%d ticks=%d step=%.1fs sigma=%.2fdeg\n",
+                args.count, args.ticks, args.step_sec, args.sigma_deg);
+    std::printf("update   %8.2f us/tick  %6.1f ns/contact  %5.2f%% of a 10 ms step\n",
+                tick_us, update_ns / (double(args.ticks) * args.count), tick_us / 100.0);
+}
+
+#endif // BEARINGSCENARIO_H
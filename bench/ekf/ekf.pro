@@ -0,0 +1,21 @@
+QT += core
+QT -= gui
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench_ekf
+TEMPLATE = app
+
+INCLUDEPATH += ../../src ../common
+
+SOURCES += \
+    main.cpp \
+    ../../src/ekftracker.cpp \
+    ../../src/bearingkernel.cpp
+
+HEADERS += \
+    ../../src/ekftracker.h \
+    ../../src/bearingkernel.h \
+    ../common/bearingscenario.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic
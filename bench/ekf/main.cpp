@@ -0,0 +1,52 @@
+#include "ekftracker.h"
+#include "bearingscenario.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+/**
+ * @brief Microbenchmark for EkfTracker::predict() and update()
+ *
+ * Runs the same zig-zag scenario as bench_tma (bearingscenario.h), with
+ * Gaussian bearing noise matching the filter's setting. Reports the cost
+ * per tick and per contact and the median position, course and speed
+ * error at the end against the true contacts.
+ *
+ * Usage: bench_ekf [contacts] [ticks] [step_sec] [bearing_sigma_deg]
+ */
+int main(int argc, char *argv[])
+{
+    const BearingBenchArgs args(argc, argv, 0.5);
+    BearingScenario scenario(args.count, args.step_sec, args.sigma_deg);
+
+    EkfTracker tracker;
+    tracker.setBearingSigma(std::max(args.sigma_deg, 0.05));
+    double update_ns = 0.0;
+    for (int k = 0; k < args.ticks; ++k) {
+        const double t = scenario.advance(k);
+
+        auto start = std::chrono::steady_clock::now();
+        tracker.predict(t);
+        tracker.update(scenario.own_x, scenario.own_y, scenario.bearing.data(), nullptr,
+                       args.count);
+        auto stop = std::chrono::steady_clock::now();
+        update_ns += std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+
+    std::vector<double> position_err, course_err, speed_err;
+    for (int i = 0; i < args.count; ++i) {
+        const double evx = tracker.velocityX(i), evy = tracker.velocityY(i);
+        const double est_course = std::atan2(evx, evy) * 180.0 / BearingScenario::kPi;
+        position_err.push_back(std::hypot(tracker.positionX(i) - scenario.x[i],
+                                          tracker.positionY(i) - scenario.y[i]));
+        course_err.push_back(courseDifference(est_course, scenario.course(i)));
+        speed_err.push_back(std::fabs(std::hypot(evx, evy) - scenario.speed(i)));
+    }
+
+    printTrackerTiming(args, update_ns);
+    std::printf("tracked  %d  median |dPos|=%.3g nm  |dCourse|=%.3g deg  |dSpeed|=%.3g kn\n",
+                args.count, median(position_err), median(course_err), median(speed_err));
+    return 0;
+}
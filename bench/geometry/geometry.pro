@@ -0,0 +1,22 @@
+QT += core gui
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench_geometry
+TEMPLATE = app
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/geometry.cpp \
+    ../../src/perfstats.cpp
+
+HEADERS += \
+    ../../src/geometry.h \
+    ../../src/perfstats.h
+
+# Google Benchmark (libbenchmark-dev)
+LIBS += -lbenchmark -lpthread
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic
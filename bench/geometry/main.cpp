@@ -0,0 +1,352 @@
+#include "geometry.h"
+#include <QPair>
+#include <QVector>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+/**
+ * @file main.cpp
+ * @brief Google Benchmark suite for the geometry primitives
+ *
+ * Times sideOfLine(), computeFullLine(), buildHalfSpacePoly() and
+ * buildConvexHull() over fixed-seed random inputs. Time per iteration is
+ * one call (ns/op); the "allocs/op" counter is the number of heap
+ * allocations made per call.
+ *
+ * Usage: bench_geometry [--benchmark_filter=<regex>] [other Google Benchmark flags]
+ */
+
+// ===== ALLOCATION COUNTING =====
+
+// Qt containers allocate with malloc() rather than operator new, so count
+// at the malloc level. glibc exports the real allocator as __libc_*; the
+// definitions below interpose the public symbols for the whole process.
+static std::atomic<long long> allocation_count(0);
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+
+/**
+ * @brief Counts allocations made between construction and report()
+ */
+class AllocationCounter
+{
+public:
+    AllocationCounter() : start(allocation_count.load(std::memory_order_relaxed)) {}
+
+    /**
+     * @brief Publishes the count as an average per iteration
+     */
+    void report(benchmark::State &state) const
+    {
+        const long long n = allocation_count.load(std::memory_order_relaxed) - start;
+        state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(n),
+                                                         benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    const long long start;
+};
+
+// ===== INPUTS =====
+
+static const int kCaseCount = 1024;          ///< Random cases cycled through (power of two)
+
+/**
+ * @brief One randomized line/rectangle pair
+ */
+struct LineCase
+{
+    QPointF a;                        ///< First point of the line
+    QPointF b;                        ///< Second point of the line
+    QPointF p;                        ///< Extra point for sideOfLine()
+    QRectF rect;                      ///< Clip rectangle
+    bool left;                        ///< Side for buildHalfSpacePoly()
+};
+
+/**
+ * @brief Random rectangles with lines through (or near) them
+ *
+ * Rectangles are 100..4000 px on a side; line points lie within the
+ * rectangle grown by half its size, so some lines miss it entirely.
+ * Every 16th case is axis-aligned to cover the degenerate branches.
+ */
+static const std::vector<LineCase> &lineCases()
+{
+    static std::vector<LineCase> cases;
+    if (!cases.empty())
+        return cases;
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> origin(-500.0, 500.0);
+    std::uniform_real_distribution<double> extent(100.0, 4000.0);
+    std::uniform_real_distribution<double> unit(-0.5, 1.5);
+
+    cases.resize(kCaseCount);
+    for (int i = 0; i < kCaseCount; ++i) {
+        LineCase &c = cases[i];
+        c.rect = QRectF(origin(rng), origin(rng), extent(rng), extent(rng));
+        auto inside = [&]() {
+            return QPointF(c.rect.left() + unit(rng) * c.rect.width(),
+                           c.rect.top() + unit(rng) * c.rect.height());
+        };
+        c.a = inside();
+        do {
+            c.b = inside();
+        } while (c.a == c.b);
+        if (i % 16 == 0)
+            c.b.setY(c.a.y());
+        else if (i % 16 == 8)
+            c.b.setX(c.a.x());
+        c.p = inside();
+        c.left = (i & 1) != 0;
+    }
+    return cases;
+}
+
+/**
+ * @brief Point cloud for the hull benchmarks
+ * @param count Number of points
+ * @param onCircle true for points on a circle (all on the hull),
+ *                 false for a uniform square (few on the hull)
+ */
+static QVector<QPointF> hullPoints(int count, bool onCircle)
+{
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> coord(0.0, 1920.0);
+    std::uniform_real_distribution<double> angle(0.0, 2.0 * M_PI);
+
+    QVector<QPointF> points;
+    points.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (onCircle) {
+            const double a = angle(rng);
+            points.append(QPointF(960.0 + 900.0 * std::cos(a), 540.0 + 900.0 * std::sin(a)));
+        } else {
+            points.append(QPointF(coord(rng), coord(rng)));
+        }
+    }
+    return points;
+}
+
+// ===== BASELINES =====
+
+/**
+ * @brief computeFullLine() before Liang–Barsky clipping, kept for comparison
+ *
+ * Intersects all four edges into a QVector, then deduplicates the hits
+ * with a quadratic loop; falls back to {A, B} when fewer than two remain.
+ */
+static QPair<QPointF,QPointF> legacyComputeFullLine(const QPointF &A, const QPointF &B,
+                                                    const QRectF &rect)
+{
+    QVector<QPointF> hits;
+    QPointF d = B - A;
+
+    auto intersect = [&](double x, double yMin, double yMax, bool vertical) {
+        double t = vertical
+            ? (x - A.x()) / d.x()
+            : (x - A.y()) / d.y();
+        QPointF P = A + t * d;
+        double y = vertical ? P.y() : P.x();
+        if (y >= yMin && y <= yMax)
+            hits.append(P);
+    };
+
+    if (!qFuzzyIsNull(d.x()))
+        intersect(rect.left(), rect.top(), rect.bottom(), true);
+    if (!qFuzzyIsNull(d.x()))
+        intersect(rect.right(), rect.top(), rect.bottom(), true);
+    if (!qFuzzyIsNull(d.y()))
+        intersect(rect.top(), rect.left(), rect.right(), false);
+    if (!qFuzzyIsNull(d.y()))
+        intersect(rect.bottom(), rect.left(), rect.right(), false);
+
+    QVector<QPointF> pts;
+    for (const auto &hit : hits) {
+        bool found = false;
+        for (const auto &pt : pts) {
+            if (qAbs(hit.x() - pt.x()) < 1e-6 && qAbs(hit.y() - pt.y()) < 1e-6) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            pts.append(hit);
+            if (pts.size() >= 2) break;
+        }
+    }
+
+    if (pts.size() >= 2)
+        return { pts[0], pts[1] };
+    return { A, B };
+}
+
+/**
+ * @brief buildConvexHull() before the monotone chain, kept for comparison
+ *
+ * Graham scan with two atan2 calls per sort comparison.
+ */
+static QPolygonF legacyBuildConvexHull(const QVector<QPointF> &points)
+{
+    if (points.size() < 3)
+        return QPolygonF(points);
+
+    int lowest = 0;
+    for (int i = 1; i < points.size(); ++i) {
+        if (points[i].y() < points[lowest].y() ||
+            (points[i].y() == points[lowest].y() && points[i].x() < points[lowest].x()))
+            lowest = i;
+    }
+
+    QVector<QPointF> sorted = points;
+    std::swap(sorted[0], sorted[lowest]);
+    std::sort(sorted.begin() + 1, sorted.end(), [&](const QPointF &a, const QPointF &b) {
+        double angleA = std::atan2(a.y() - sorted[0].y(), a.x() - sorted[0].x());
+        double angleB = std::atan2(b.y() - sorted[0].y(), b.x() - sorted[0].x());
+        return angleA < angleB;
+    });
+
+    QVector<QPointF> hull;
+    hull.push_back(sorted[0]);
+    hull.push_back(sorted[1]);
+    for (int i = 2; i < sorted.size(); ++i) {
+        while (hull.size() > 1 &&
+               sideOfLine(hull[hull.size()-2], hull[hull.size()-1], sorted[i]) <= 0)
+            hull.pop_back();
+        hull.push_back(sorted[i]);
+    }
+    return QPolygonF(hull);
+}
+
+// ===== BENCHMARKS =====
+
+static void BM_SideOfLine(benchmark::State &state)
+{
+    const std::vector<LineCase> &cases = lineCases();
+    int i = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        const LineCase &c = cases[i++ & (kCaseCount - 1)];
+        benchmark::DoNotOptimize(sideOfLine(c.a, c.b, c.p));
+    }
+    allocs.report(state);
+}
+BENCHMARK(BM_SideOfLine);
+
+static void BM_ComputeFullLine(benchmark::State &state)
+{
+    const std::vector<LineCase> &cases = lineCases();
+    int i = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        const LineCase &c = cases[i++ & (kCaseCount - 1)];
+        benchmark::DoNotOptimize(computeFullLine(c.a, c.b, c.rect));
+    }
+    allocs.report(state);
+}
+BENCHMARK(BM_ComputeFullLine);
+
+static void BM_ComputeFullLine_Legacy(benchmark::State &state)
+{
+    const std::vector<LineCase> &cases = lineCases();
+    int i = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        const LineCase &c = cases[i++ & (kCaseCount - 1)];
+        benchmark::DoNotOptimize(legacyComputeFullLine(c.a, c.b, c.rect));
+    }
+    allocs.report(state);
+}
+BENCHMARK(BM_ComputeFullLine_Legacy);
+
+static void BM_BuildHalfSpacePoly(benchmark::State &state)
+{
+    const std::vector<LineCase> &cases = lineCases();
+    int i = 0;
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        const LineCase &c = cases[i++ & (kCaseCount - 1)];
+        benchmark::DoNotOptimize(buildHalfSpacePoly(c.a, c.b, c.rect, c.left));
+    }
+    allocs.report(state);
+}
+BENCHMARK(BM_BuildHalfSpacePoly);
+
+/**
+ * @brief Hull variants compared by the hull benchmarks
+ */
+enum class HullImpl {
+    Wrapper,                          ///< buildConvexHull() (fresh buffers per call)
+    Builder,                          ///< Long-lived ConvexHullBuilder
+    BuilderParallel,                  ///< ConvexHullBuilder with parallel sort
+    Legacy                            ///< Graham scan baseline
+};
+
+static void hullBenchmark(benchmark::State &state, bool onCircle, HullImpl impl)
+{
+    const QVector<QPointF> points = hullPoints(static_cast<int>(state.range(0)), onCircle);
+    ConvexHullBuilder builder;
+    builder.setParallelSortEnabled(impl == HullImpl::BuilderParallel);
+    builder.build(points);            // warm the buffers
+
+    AllocationCounter allocs;
+    for (auto _ : state) {
+        switch (impl) {
+        case HullImpl::Wrapper:
+            benchmark::DoNotOptimize(buildConvexHull(points));
+            break;
+        case HullImpl::Builder:
+        case HullImpl::BuilderParallel:
+            benchmark::DoNotOptimize(builder.build(points).constData());
+            break;
+        case HullImpl::Legacy:
+            benchmark::DoNotOptimize(legacyBuildConvexHull(points));
+            break;
+        }
+    }
+    allocs.report(state);
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define HULL_BENCHMARK(name, onCircle, impl) \
+    static void name(benchmark::State &state) { hullBenchmark(state, onCircle, impl); } \
+    BENCHMARK(name)->RangeMultiplier(4)->Range(4, 1 << 20) \
+        ->Unit(benchmark::kMicrosecond)->Complexity(benchmark::oNLogN)
+
+HULL_BENCHMARK(BM_BuildConvexHull_Square, false, HullImpl::Wrapper);
+HULL_BENCHMARK(BM_BuildConvexHull_Circle, true, HullImpl::Wrapper);
+HULL_BENCHMARK(BM_ConvexHullBuilder_Square, false, HullImpl::Builder);
+HULL_BENCHMARK(BM_ConvexHullBuilder_Circle, true, HullImpl::Builder);
+HULL_BENCHMARK(BM_ConvexHullBuilderParallel_Square, false, HullImpl::BuilderParallel);
+HULL_BENCHMARK(BM_BuildConvexHull_Legacy_Square, false, HullImpl::Legacy);
+HULL_BENCHMARK(BM_BuildConvexHull_Legacy_Circle, true, HullImpl::Legacy);
+
+BENCHMARK_MAIN();
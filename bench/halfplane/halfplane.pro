@@ -0,0 +1,20 @@
+QT += core
+QT -= gui
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench_halfplane
+TEMPLATE = app
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/halfplanekernel.cpp \
+    ../../src/bearingkernel.cpp
+
+HEADERS += \
+    ../../src/halfplanekernel.h \
+    ../../src/bearingkernel.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic
@@ -0,0 +1,97 @@
+#include "halfplanekernel.h"
+#include "bearingkernel.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Per-point reference: the side test with a branch per point, as
+ * the display does for its corners, into one flag per point
+ */
+static void classifyPerPoint(const double *x, const double *y, int count,
+                             double ax, double ay, double bx, double by, double gap,
+                             unsigned char *inside)
+{
+    const double dx = bx - ax, dy = by - ay;
+    const double threshold = gap * std::hypot(dx, dy);
+    for (int i = 0; i < count; ++i) {
+        if (dx * (y[i] - ay) - dy * (x[i] - ax) > threshold)
+            inside[i] = 1;
+        else
+            inside[i] = 0;
+    }
+}
+
+/**
+ * @brief Microbenchmark for classifyHalfPlaneBatch()
+ *
+ * Classifies random relative positions against a baffle line through the
+ * origin with every instruction set the CPU supports and with the
+ * per-point loop, reports ns/contact and checks that every path sets the
+ * same bits as the per-point test.
+ *
+ * Usage: bench_halfplane [contacts] [iterations]
+ */
+int main(int argc, char *argv[])
+{
+    const int count = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const int iters = argc > 2 ? std::atoi(argv[2]) : 5000;
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> pos(-40.0, 40.0);
+    std::vector<double> rel_x(count), rel_y(count);
+    for (int i = 0; i < count; ++i) {
+        rel_x[i] = pos(rng);
+        rel_y[i] = pos(rng);
+    }
+    // Direction of the default scenario's sensor line (Y north), 0.5 nm gap
+    const double bx = 640.0, by = 400.0, gap = 0.5;
+
+    std::vector<unsigned char> ref(count);
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iters; ++it)
+        classifyPerPoint(rel_x.data(), rel_y.data(), count, 0.0, 0.0, bx, by, gap, ref.data());
+    auto stop = std::chrono::steady_clock::now();
+    const double per_point_ns = std::chrono::duration<double, std::nano>(stop - start).count()
+                                / (double(iters) * count);
+    int inside = 0;
+    for (int i = 0; i < count; ++i)
+        inside += ref[i];
+
+    std::printf("contacts=%d iterations=%d inside=%d best=%s\n", count, iters, inside,
+                bearingKernelIsaName(bearingKernelBestIsa()));
+    std::printf("%-7s %7.3f ns/contact\n", "branch", per_point_ns);
+
+    const BearingKernelIsa all[] = { BearingKernelIsa::Scalar,
+                                     BearingKernelIsa::SSE2,
+                                     BearingKernelIsa::AVX2 };
+    for (BearingKernelIsa isa : all) {
+        if (static_cast<int>(isa) > static_cast<int>(bearingKernelBestIsa()))
+            continue;
+        setBearingKernelIsa(isa);
+
+        std::vector<quint64> mask(halfPlaneMaskWords(count));
+        classifyHalfPlaneBatch(rel_x.data(), rel_y.data(), count, 0.0, 0.0, bx, by, gap,
+                               mask.data());
+        int mismatches = 0;
+        for (int i = 0; i < count; ++i)
+            mismatches += halfPlaneBit(mask.data(), i) != ref[i];
+        if (count % 64 != 0 && (mask.back() >> (count % 64)) != 0)
+            ++mismatches;
+
+        start = std::chrono::steady_clock::now();
+        for (int it = 0; it < iters; ++it)
+            classifyHalfPlaneBatch(rel_x.data(), rel_y.data(), count, 0.0, 0.0, bx, by, gap,
+                                   mask.data());
+        stop = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(stop - start).count()
+                          / (double(iters) * count);
+
+        std::printf("%-7s %7.3f ns/contact  %6.2fx  %s\n", bearingKernelIsaName(isa), ns,
+                    per_point_ns / ns, mismatches == 0 ? "ok" : "MISMATCH");
+    }
+    return 0;
+}
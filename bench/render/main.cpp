@@ -0,0 +1,83 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QSize>
+#include <QVector>
+#include <cstdio>
+#include <cstdlib>
+#include "diagramwidget.h"
+
+/**
+ * @brief Mean time per frame of TSAWidget::paintEvent() at one size
+ *
+ * Rows: static layer redrawn every frame with the Qt::BDiagPattern brush
+ * and with the hatch tile brush (the per-pixel hatch cost), then the
+ * cached static layer blit for reference. Speed-ups are relative to the
+ * first row.
+ */
+static void benchSize(const QSize &size, int frames)
+{
+    TSAWidget widget;
+    widget.resize(size);
+    QImage target(size, QImage::Format_ARGB32_Premultiplied);
+
+    struct Mode
+    {
+        const char *name;
+        bool cached;
+        HatchStyle::Fill fill;
+    };
+    const Mode modes[] = {
+        { "pattern", false, HatchStyle::Fill::Pattern },
+        { "tile",    false, HatchStyle::Fill::Tile },
+        { "cached",  true,  HatchStyle::Fill::Tile },
+    };
+
+    std::printf("size=%dx%d frames=%d\n", size.width(), size.height(), frames);
+    double baseline_us = 0.0;
+    for (const Mode &mode : modes) {
+        HatchStyle hatch;
+        hatch.fill = mode.fill;
+        widget.setHatchStyle(hatch);
+        widget.setBackgroundCacheEnabled(mode.cached);
+        widget.render(&target);                 // warm-up, builds the cache and tile
+
+        QElapsedTimer clock;
+        clock.start();
+        for (int i = 0; i < frames; ++i)
+            widget.render(&target);
+        const double us = clock.nsecsElapsed() / 1000.0 / frames;
+        if (baseline_us == 0.0)
+            baseline_us = us;
+
+        std::printf("%-9s %9.1f us/frame  %6.2fx\n", mode.name, us, baseline_us / us);
+    }
+}
+
+/**
+ * @brief Frame-time benchmark for TSAWidget::paintEvent()
+ *
+ * Renders the widget into an offscreen QImage with the static layer
+ * redrawn per frame (pattern brush, then hatch tile) and cached, and
+ * reports the mean time per frame. Without a size it runs at 1080p and
+ * at 4K.
+ *
+ * Usage: bench_render [width] [height] [frames]
+ */
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QVector<QSize> sizes;
+    if (argc > 2)
+        sizes << QSize(std::atoi(argv[1]), std::atoi(argv[2]));
+    else
+        sizes << QSize(1920, 1080) << QSize(3840, 2160);
+    const int frames = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    for (const QSize &size : sizes)
+        benchSize(size, frames);
+    return 0;
+}
@@ -0,0 +1,13 @@
+QT += core widgets
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench_render
+TEMPLATE = app
+
+SOURCES += \
+    main.cpp
+
+include(../../src/src.pri)
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic
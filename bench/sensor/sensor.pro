@@ -0,0 +1,36 @@
+QT += core
+QT -= gui
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench_sensor
+TEMPLATE = app
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/measurementgen.cpp \
+    ../../src/simulation.cpp \
+    ../../src/scenario.cpp \
+    ../../src/trackstore.cpp \
+    ../../src/tmaestimator.cpp \
+    ../../src/ekftracker.cpp \
+    ../../src/bearingkernel.cpp \
+    ../../src/halfplanekernel.cpp \
+    ../../src/spatialgrid.cpp \
+    ../../src/perfstats.cpp
+
+HEADERS += \
+    ../../src/measurementgen.h \
+    ../../src/simulation.h \
+    ../../src/scenario.h \
+    ../../src/trackstore.h \
+    ../../src/tmaestimator.h \
+    ../../src/ekftracker.h \
+    ../../src/bearingkernel.h \
+    ../../src/halfplanekernel.h \
+    ../../src/spatialgrid.h \
+    ../../src/perfstats.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic
@@ -0,0 +1,116 @@
+#include "spatialgrid.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Times one callable over a number of repetitions
+ * @return Mean time per call (microseconds)
+ */
+template <typename F>
+static double timeUs(int reps, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r)
+        f(r);
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(stop - start).count() / reps;
+}
+
+/**
+ * @brief Microbenchmark for SpatialGrid against a linear scan
+ *
+ * Contacts are spread uniformly over a square of 2 * extent nm around
+ * own ship. Times the per-tick rebuild, a 0.15 nm pick (6 px at 40 px
+ * per nm), a view rectangle of 20 x 12 nm (an 800 x 480 display) and a
+ * half-plane through own ship, each against the loop the renderer would
+ * otherwise run, and checks both return the same number of contacts.
+ *
+ * Usage: bench_spatial [contacts] [extent_nm] [repetitions]
+ */
+int main(int argc, char *argv[])
+{
+    const int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const double extent = argc > 2 ? std::atof(argv[2]) : 50.0;
+    const int reps = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> pos(-extent, extent);
+    std::vector<double> x(count), y(count);
+    for (int i = 0; i < count; ++i) {
+        x[i] = pos(rng);
+        y[i] = pos(rng);
+    }
+    std::vector<double> qx(reps), qy(reps);
+    for (int r = 0; r < reps; ++r) {
+        qx[r] = pos(rng) * 0.5;
+        qy[r] = pos(rng) * 0.5;
+    }
+
+    SpatialGrid grid;
+    QVector<int> out;
+    std::vector<int> scan;
+    scan.reserve(count);
+    long grid_hits = 0, scan_hits = 0;
+
+    const double build_us = timeUs(reps, [&](int) { grid.build(x.data(), y.data(), count); });
+
+    const double pick = 0.15;
+    const double pick_us = timeUs(reps, [&](int r) {
+        grid_hits += grid.nearest(qx[r], qy[r], pick) >= 0;
+    });
+    const double pick_scan_us = timeUs(reps, [&](int r) {
+        int best = -1;
+        double best_d2 = pick * pick;
+        for (int i = 0; i < count; ++i) {
+            const double dx = x[i] - qx[r], dy = y[i] - qy[r];
+            const double d2 = dx * dx + dy * dy;
+            if (d2 <= best_d2) {
+                best = i;
+                best_d2 = d2;
+            }
+        }
+        scan_hits += best >= 0;
+    });
+    std::printf("contacts=%d extent=%.0fnm cells=%dx%d (%.3g nm)\n",
+                count, extent, grid.columns(), grid.rowCount(), grid.cellSize());
+    std::printf("build    %10.2f us\n", build_us);
+    std::printf("pick     %10.3f us  scan %10.2f us  hits %ld/%ld\n",
+                pick_us, pick_scan_us, grid_hits, scan_hits);
+
+    grid_hits = scan_hits = 0;
+    const double rect_us = timeUs(reps, [&](int r) {
+        grid.queryRect(qx[r] - 10.0, qy[r] - 6.0, qx[r] + 10.0, qy[r] + 6.0, out);
+        grid_hits += out.size();
+    });
+    const double rect_scan_us = timeUs(reps, [&](int r) {
+        scan.clear();
+        for (int i = 0; i < count; ++i) {
+            if (x[i] >= qx[r] - 10.0 && x[i] <= qx[r] + 10.0
+                    && y[i] >= qy[r] - 6.0 && y[i] <= qy[r] + 6.0)
+                scan.push_back(i);
+        }
+        scan_hits += long(scan.size());
+    });
+    std::printf("rect     %10.2f us  scan %10.2f us  hits %ld/%ld\n",
+                rect_us, rect_scan_us, grid_hits, scan_hits);
+
+    grid_hits = scan_hits = 0;
+    const double half_us = timeUs(reps, [&](int r) {
+        grid.queryHalfPlane(0.0, 0.0, qx[r], qy[r], true, out);
+        grid_hits += out.size();
+    });
+    const double half_scan_us = timeUs(reps, [&](int r) {
+        scan.clear();
+        for (int i = 0; i < count; ++i) {
+            if (qx[r] * y[i] - qy[r] * x[i] > 0.0)
+                scan.push_back(i);
+        }
+        scan_hits += long(scan.size());
+    });
+    std::printf("half     %10.2f us  scan %10.2f us  hits %ld/%ld\n",
+                half_us, half_scan_us, grid_hits, scan_hits);
+    return 0;
+}
@@ -0,0 +1,18 @@
+QT += core
+QT -= gui
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench_spatial
+TEMPLATE = app
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/spatialgrid.cpp
+
+HEADERS += \
+    ../../src/spatialgrid.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic
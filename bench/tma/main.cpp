@@ -0,0 +1,49 @@
+#include "tmaestimator.h"
+#include "bearingscenario.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+/**
+ * @brief Microbenchmark for TmaEstimator::update()
+ *
+ * Runs the shared zig-zag scenario (bearingscenario.h). Reports the cost
+ * per tick and per contact, the share of a 10 ms simulation step it
+ * takes, and the median range, course and speed error at the end against
+ * the true contacts.
+ *
+ * Usage: bench_tma [contacts] [ticks] [step_sec] [bearing_sigma_deg]
+ */
+int main(int argc, char *argv[])
+{
+    const BearingBenchArgs args(argc, argv, 0.0);
+    BearingScenario scenario(args.count, args.step_sec, args.sigma_deg);
+
+    TmaEstimator estimator;
+    double update_ns = 0.0;
+    for (int k = 0; k < args.ticks; ++k) {
+        const double t = scenario.advance(k);
+
+        auto start = std::chrono::steady_clock::now();
+        estimator.update(t, scenario.own_x, scenario.own_y, scenario.bearing.data(), args.count);
+        auto stop = std::chrono::steady_clock::now();
+        update_ns += std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+
+    std::vector<double> range_err, course_err, speed_err;
+    for (int i = 0; i < args.count; ++i) {
+        if (!estimator.solved(i))
+            continue;
+        const double range = scenario.range(i);
+        range_err.push_back(std::fabs(estimator.range(i) - range) / range);
+        course_err.push_back(courseDifference(estimator.course(i), scenario.course(i)));
+        speed_err.push_back(std::fabs(estimator.speed(i) - scenario.speed(i)));
+    }
+
+    printTrackerTiming(args, update_ns);
+    std::printf("solved   %d/%d  median |dRange|/R=%.3g  |dCourse|=%.3g deg  |dSpeed|=%.3g kn\n",
+                int(range_err.size()), args.count, median(range_err), median(course_err),
+                median(speed_err));
+    return 0;
+}
@@ -0,0 +1,19 @@
+QT += core
+QT -= gui
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench_tma
+TEMPLATE = app
+
+INCLUDEPATH += ../../src ../common
+
+SOURCES += \
+    main.cpp \
+    ../../src/tmaestimator.cpp
+
+HEADERS += \
+    ../../src/tmaestimator.h \
+    ../common/bearingscenario.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Wpedantic
@@ -0,0 +1,198 @@
+#include "arrowbatch.h"
+#include <QtMath>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Unit vectors of every lookup course, built on first use
+ */
+struct DirectionTable
+{
+    QPointF dir[ArrowBatch::kDirectionSteps];
+
+    DirectionTable()
+    {
+        for (int i = 0; i < ArrowBatch::kDirectionSteps; ++i) {
+            const double rad = qDegreesToRadians(i * 360.0 / ArrowBatch::kDirectionSteps);
+            dir[i] = QPointF(std::sin(rad), -std::cos(rad));
+        }
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Constructor - empty batch
+ */
+ArrowBatch::ArrowBatch()
+    : group_count(0),
+      last_group(-1),
+      count(0),
+      min_x(0), min_y(0),
+      max_x(0), max_y(0),
+      max_margin(0)
+{
+}
+
+/**
+ * @brief Removes every arrow, keeping the group storage
+ */
+void ArrowBatch::clear()
+{
+    for (int i = 0; i < group_count; ++i) {
+        groups[i].shafts.resize(0);
+        groups[i].heads.resize(0);
+        groups[i].head_path.clear();   // keeps the element storage
+    }
+    group_count = 0;
+    last_group = -1;
+    count = 0;
+    max_margin = 0;
+}
+
+/**
+ * @brief Unit vector of a compass course (screen Y points down)
+ * @param courseDeg Course in degrees, clockwise from up; any value
+ * @return Direction looked up at kDirectionSteps resolution
+ */
+QPointF ArrowBatch::courseDirection(double courseDeg)
+{
+    static const DirectionTable table;
+    int i = int(std::lround(courseDeg * (kDirectionSteps / 360.0))) % kDirectionSteps;
+    if (i < 0)
+        i += kDirectionSteps;
+    return table.dir[i];
+}
+
+/**
+ * @brief Group for a style, created on first use
+ *
+ * Consecutive arrows usually share a style, so the previous group is
+ * checked before the (short) list of groups.
+ */
+ArrowBatch::Group &ArrowBatch::groupFor(const QColor &color, int width,
+                                        qreal headLen, qreal headAngleDeg)
+{
+    const QRgb rgba = color.rgba();
+    auto matches = [&](const Group &g) {
+        return g.color == rgba && g.width == width
+               && g.head_len == headLen && g.head_angle_deg == headAngleDeg;
+    };
+    if (last_group >= 0 && matches(groups[last_group]))
+        return groups[last_group];
+    for (int i = 0; i < group_count; ++i) {
+        if (matches(groups[i])) {
+            last_group = i;
+            return groups[i];
+        }
+    }
+
+    if (group_count == groups.size())
+        groups.append(Group());
+    Group &g = groups[group_count];
+    g.color = rgba;
+    g.width = width;
+    g.head_len = headLen;
+    g.head_angle_deg = headAngleDeg;
+    const qreal a = qDegreesToRadians(180.0 - headAngleDeg);
+    g.head_cos = qCos(a);
+    g.head_sin = qSin(a);
+    g.head_path.setFillRule(Qt::WindingFill);
+    max_margin = qMax(max_margin, width * 0.5 + 2.0);
+    last_group = group_count++;
+    return g;
+}
+
+/**
+ * @brief Appends an arrow with a known unit direction to a group
+ *
+ * The head sides are the direction rotated by +-(180 - head angle).
+ */
+void ArrowBatch::append(Group &g, const QPointF &from, const QPointF &to, const QPointF &dir)
+{
+    const qreal c = g.head_cos, s = g.head_sin, L = g.head_len;
+    const QPointF h1(to.x() + L * (dir.x() * c - dir.y() * s),
+                     to.y() + L * (dir.x() * s + dir.y() * c));
+    const QPointF h2(to.x() + L * (dir.x() * c + dir.y() * s),
+                     to.y() + L * (dir.y() * c - dir.x() * s));
+
+    g.shafts.append(QLineF(from, to));
+    g.heads.append(to);
+    g.heads.append(h1);
+    g.heads.append(h2);
+    g.head_path.moveTo(to);
+    g.head_path.lineTo(h1);
+    g.head_path.lineTo(h2);
+    g.head_path.closeSubpath();
+
+    const QPointF pts[4] = { from, to, h1, h2 };
+    int first = 0;
+    if (count == 0) {
+        min_x = max_x = from.x();
+        min_y = max_y = from.y();
+        first = 1;
+    }
+    for (int i = first; i < 4; ++i) {
+        min_x = qMin(min_x, pts[i].x());
+        max_x = qMax(max_x, pts[i].x());
+        min_y = qMin(min_y, pts[i].y());
+        max_y = qMax(max_y, pts[i].y());
+    }
+    ++count;
+}
+
+/**
+ * @brief Adds an arrow from one point to another
+ *
+ * A zero-length arrow points right, as drawn by the unbatched path.
+ */
+void ArrowBatch::add(const QPointF &from, const QPointF &to, qreal headLen, qreal headAngleDeg,
+                     const QColor &color, int width)
+{
+    const QPointF d = to - from;
+    const qreal len = std::sqrt(d.x() * d.x() + d.y() * d.y());
+    const QPointF dir = len > 0 ? d / len : QPointF(1, 0);
+    append(groupFor(color, width, headLen, headAngleDeg), from, to, dir);
+}
+
+/**
+ * @brief Adds an arrow along a compass course (screen Y points down)
+ */
+void ArrowBatch::addCourse(const QPointF &from, double courseDeg, qreal length, qreal headLen,
+                           qreal headAngleDeg, const QColor &color, int width)
+{
+    const QPointF dir = courseDirection(courseDeg);
+    append(groupFor(color, width, headLen, headAngleDeg), from, from + dir * length, dir);
+}
+
+/**
+ * @brief Draws every group: all shafts, then all heads
+ *
+ * The heads of a group form one path of closed triangles, built as the
+ * arrows are added, filled and outlined with the shaft pen in a single
+ * call like the per-arrow polygons were.
+ */
+void ArrowBatch::draw(QPainter &p) const
+{
+    for (int i = 0; i < group_count; ++i) {
+        const Group &g = groups[i];
+        const QColor color = QColor::fromRgba(g.color);
+        p.setPen(QPen(color, g.width, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        p.drawLines(g.shafts);
+        p.setBrush(color);
+        p.drawPath(g.head_path);
+    }
+}
+
+/**
+ * @brief Union of the arrow bounds, including pen and antialiasing
+ * @return Null rectangle for an empty batch
+ */
+QRectF ArrowBatch::bounds() const
+{
+    if (count == 0)
+        return QRectF();
+    return QRectF(QPointF(min_x, min_y), QPointF(max_x, max_y))
+        .adjusted(-max_margin, -max_margin, max_margin, max_margin);
+}
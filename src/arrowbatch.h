@@ -0,0 +1,131 @@
+#ifndef ARROWBATCH_H
+#define ARROWBATCH_H
+
+#include <QColor>
+#include <QLineF>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+/**
+ * @brief ArrowBatch - Collects arrows and draws them grouped by style
+ *
+ * Drawing arrows one by one costs a pen and brush change, a line and a
+ * polygon per arrow. ArrowBatch sorts arrows into groups of equal colour,
+ * width and head shape as they are added and draws each group with one
+ * drawLines() for the shafts and one drawPath() for all head triangles,
+ * so the number of state changes follows the number of styles, not the
+ * number of arrows.
+ *
+ * Head vertices are computed when an arrow is added by rotating its unit
+ * direction with the cosine/sine of the group's head angle, taken once
+ * per group; arrows given as a course use a lookup table for their
+ * direction, so no trigonometric function runs per arrow. Groups keep
+ * their storage across clear(), so a batch reused every frame does not
+ * allocate.
+ */
+class ArrowBatch
+{
+public:
+    static const int kDirectionSteps = 3600;  ///< Course lookup resolution (0.1 degree)
+
+    ArrowBatch();
+
+    /**
+     * @brief Removes every arrow, keeping the group storage
+     */
+    void clear();
+
+    /**
+     * @brief Adds an arrow from one point to another
+     * @param from Tail
+     * @param to Head tip
+     * @param headLen Length of the head
+     * @param headAngleDeg Half-angle of the head in degrees
+     * @param color Shaft and head colour
+     * @param width Shaft width
+     */
+    void add(const QPointF &from, const QPointF &to, qreal headLen, qreal headAngleDeg,
+             const QColor &color, int width);
+
+    /**
+     * @brief Adds an arrow along a compass course (screen Y points down)
+     * @param from Tail
+     * @param courseDeg Course in degrees, clockwise from up
+     * @param length Shaft length
+     * @param headLen Length of the head
+     * @param headAngleDeg Half-angle of the head in degrees
+     * @param color Shaft and head colour
+     * @param width Shaft width
+     */
+    void addCourse(const QPointF &from, double courseDeg, qreal length, qreal headLen,
+                   qreal headAngleDeg, const QColor &color, int width);
+
+    /**
+     * @brief Draws every group: all shafts, then all heads
+     *
+     * Groups are drawn in the order their first arrow was added.
+     */
+    void draw(QPainter &p) const;
+
+    /**
+     * @brief Union of the arrow bounds, including pen and antialiasing
+     */
+    QRectF bounds() const;
+
+    int size() const { return count; }              ///< Number of arrows
+    int groupCount() const { return group_count; }  ///< Number of styles in use
+
+    // ===== GROUP ACCESS (other backends) =====
+
+    QColor groupColor(int group) const { return QColor::fromRgba(groups[group].color); }
+    int groupWidth(int group) const { return groups[group].width; }
+    const QVector<QLineF> &groupShafts(int group) const { return groups[group].shafts; }   ///< One line per arrow
+    const QVector<QPointF> &groupHeads(int group) const { return groups[group].heads; }    ///< Tip, left, right per arrow
+
+    /**
+     * @brief Unit vector of a compass course (screen Y points down)
+     *
+     * Looked up at kDirectionSteps resolution; any course is accepted.
+     */
+    static QPointF courseDirection(double courseDeg);
+
+private:
+    /**
+     * @brief Arrows sharing colour, width and head shape
+     */
+    struct Group
+    {
+        QRgb color;                   ///< Colour (with alpha)
+        int width;                    ///< Shaft width
+        qreal head_len;               ///< Length of the head
+        qreal head_angle_deg;         ///< Half-angle of the head (degrees)
+        qreal head_cos;               ///< cos(180 - head angle)
+        qreal head_sin;               ///< sin(180 - head angle)
+        QVector<QLineF> shafts;       ///< One line per arrow
+        QVector<QPointF> heads;       ///< Three vertices per arrow: tip, left, right
+        QPainterPath head_path;       ///< The heads as closed triangles, drawn in one call
+    };
+
+    /**
+     * @brief Group for a style, created on first use
+     */
+    Group &groupFor(const QColor &color, int width, qreal headLen, qreal headAngleDeg);
+
+    /**
+     * @brief Appends an arrow with a known unit direction to a group
+     */
+    void append(Group &group, const QPointF &from, const QPointF &to, const QPointF &dir);
+
+    QVector<Group> groups;            ///< Groups ever used (only the first group_count are live)
+    int group_count;                  ///< Groups holding arrows in this batch
+    int last_group;                   ///< Group of the previous add(), checked first
+    int count;                        ///< Number of arrows
+    qreal min_x, min_y;               ///< Bounds of all vertices...
+    qreal max_x, max_y;               ///< ...before the pen margin
+    qreal max_margin;                 ///< Largest pen margin of any group
+};
+
+#endif // ARROWBATCH_H
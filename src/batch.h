@@ -0,0 +1,80 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <QString>
+#include <QtGlobal>
+#include "scenario.h"
+
+/**
+ * @brief Options for a Monte Carlo batch of simulation runs
+ */
+struct BatchOptions
+{
+    int runs = 100;                   ///< Number of runs (one seed each)
+    qint64 ticks = 1000000;           ///< Steps per run
+    double step_sec = 2.0;            ///< Fixed simulation step (seconds)
+    quint64 seed = 1;                 ///< Base seed; run i uses a seed derived from seed + i
+    int threads = 0;                  ///< Worker threads, 0 for one per core
+    double jitter_pos_nm = 0.5;       ///< Std. deviation of the contact start position (nm)
+    double jitter_course_deg = 10.0;  ///< Std. deviation of the contact course (degrees)
+    double jitter_speed_kn = 1.0;     ///< Std. deviation of the contact speed (knots)
+    bool tracking = false;            ///< Also run the sensor and trackers (not in the summary)
+    QString output = "-";             ///< CSV file with one line per run, "-" for stdout
+    Scenario scenario = Scenario::defaultScenario(); ///< Base scenario every run varies
+};
+
+/**
+ * @brief Summary statistics of one batch run (adopted track)
+ */
+struct BatchRunSummary
+{
+    int run = 0;                      ///< Run number
+    quint64 seed = 0;                 ///< Seed the contacts and sensor measurements were varied with
+    qint64 ticks = 0;                 ///< Steps simulated
+    double wall_sec = 0.0;            ///< Wall-clock time of the run (seconds)
+
+    // ===== BEARING RATE (DEG/S, EVERY TICK AFTER THE FIRST) =====
+    double rate_mean = 0.0;           ///< Mean bearing rate
+    double rate_stddev = 0.0;         ///< Standard deviation of the bearing rate
+    double rate_min = 0.0;            ///< Lowest bearing rate
+    double rate_max = 0.0;            ///< Highest bearing rate
+    double peak_rate_time_sec = 0.0;  ///< Time of the largest |bearing rate|
+
+    // ===== GEOMETRY =====
+    double min_range = 0.0;           ///< Closest approach (nm)
+    double min_range_time_sec = 0.0;  ///< Time of the closest approach (seconds)
+    double final_bearing = 0.0;       ///< Bearing at the end of the run (degrees)
+    double final_range = 0.0;         ///< Range at the end of the run (nm)
+};
+
+/**
+ * @brief Runs a Monte Carlo batch faster than real time, without a GUI
+ *
+ * Every run copies the scenario, varies each contact's start position,
+ * course and speed with Gaussian noise from its own seed (which also
+ * seeds the sensor measurements), and steps a Simulation directly (no
+ * timers) for the given number of ticks while accumulating bearing-rate
+ * statistics of the adopted track. The summary only uses the true
+ * kinematics, so the sensor and the trackers are off unless
+ * options.tracking is set. Runs are spread over a QThreadPool;
+ * the CSV lines are written in run order, so the output only depends on
+ * the options, not on the thread count.
+ *
+ * @param options Run count, length, seeding, variation and output
+ * @return Process exit code (0 on success)
+ */
+int runBatch(const BatchOptions &options);
+
+/**
+ * @brief Simulates one batch run
+ *
+ * Exposed for callers that want the summaries without the CSV output;
+ * thread-safe, it only reads the options.
+ *
+ * @param options Batch options (scenario, length, variation)
+ * @param run Run number; selects the seed
+ * @return Summary statistics of the run
+ */
+BatchRunSummary simulateBatchRun(const BatchOptions &options, int run);
+
+#endif // BATCH_H
@@ -0,0 +1,295 @@
+#include "bearingkernel.h"
+#include <atomic>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TSA_BEARING_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const double kPi        = 3.14159265358979323846;
+const double kRadToDeg  = 180.0 / kPi;
+
+/**
+ * @brief Scalar range/bearing/rate for one contact
+ *
+ * Same math as TSAWidget::calculateRange() and calculateBearing(); used
+ * as the fallback path and for the tail of the SIMD loops.
+ */
+inline void scalarOne(double x, double y, double inv_dt,
+                      double &bearing, double &range, double &rate)
+{
+    range = std::sqrt(x*x + y*y);
+
+    double b = std::atan2(x, y) * kRadToDeg;
+    b = (b < 0.0 ? b + 360.0 : b);     // Normalize to 0-360°
+
+    double db = b - bearing;
+    if (db > 180.0)  db -= 360.0;
+    if (db < -180.0) db += 360.0;
+    rate    = db * inv_dt;
+    bearing = b;
+}
+
+void kernelScalar(const double *rel_x, const double *rel_y, double inv_dt,
+                  double *bearing, double *range, double *rate, int count)
+{
+    for (int i = 0; i < count; ++i)
+        scalarOne(rel_x[i], rel_y[i], inv_dt, bearing[i], range[i], rate[i]);
+}
+
+#ifdef TSA_BEARING_KERNEL_X86
+
+// Cephes atan() rational approximation coefficients, valid on [0, 0.66]
+const double kP0 = -8.750608600031904122785E-1;
+const double kP1 = -1.615753718733365076637E1;
+const double kP2 = -7.500855792314704667340E1;
+const double kP3 = -1.228866684490136173410E2;
+const double kP4 = -6.485021904942025371773E1;
+const double kQ0 =  2.485846490142306297962E1;
+const double kQ1 =  1.650270098316988542046E2;
+const double kQ2 =  4.328810604912902668951E2;
+const double kQ3 =  4.853903996359136964868E2;
+const double kQ4 =  1.945506571482613964425E2;
+
+/*
+ * Bearing math shared by both SIMD paths:
+ *   q  = min(|x|,|y|) / max(|x|,|y|)            in [0, 1]
+ *   a  = atan(q), reduced to [0, 0.66] via atan(q) = π/4 + atan((q-1)/(q+1))
+ *   a  = π/2 - a                                 if |x| > |y|
+ *   a  = π - a                                   if y < 0
+ *   a  = 2π - a                                  if x < 0
+ * which gives atan2(x, y) already normalized to 0-2π.
+ */
+
+void kernelSse2(const double *rel_x, const double *rel_y, double inv_dt,
+                double *bearing, double *range, double *rate, int count)
+{
+    const __m128d sign   = _mm_set1_pd(-0.0);
+    const __m128d zero   = _mm_setzero_pd();
+    const __m128d one    = _mm_set1_pd(1.0);
+    const __m128d red    = _mm_set1_pd(0.66);
+    const __m128d pi_4   = _mm_set1_pd(kPi / 4.0);
+    const __m128d pi_2   = _mm_set1_pd(kPi / 2.0);
+    const __m128d pi     = _mm_set1_pd(kPi);
+    const __m128d two_pi = _mm_set1_pd(2.0 * kPi);
+    const __m128d to_deg = _mm_set1_pd(kRadToDeg);
+    const __m128d d180   = _mm_set1_pd(180.0);
+    const __m128d d360   = _mm_set1_pd(360.0);
+    const __m128d vinv   = _mm_set1_pd(inv_dt);
+
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d x = _mm_loadu_pd(rel_x + i);
+        const __m128d y = _mm_loadu_pd(rel_y + i);
+
+        _mm_storeu_pd(range + i,
+                      _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y))));
+
+        const __m128d ax = _mm_andnot_pd(sign, x);
+        const __m128d ay = _mm_andnot_pd(sign, y);
+        const __m128d lo = _mm_min_pd(ax, ay);
+        const __m128d hi = _mm_max_pd(ax, ay);
+        const __m128d hi_zero = _mm_cmpeq_pd(hi, zero);
+        __m128d q = _mm_div_pd(lo, _mm_or_pd(_mm_and_pd(hi_zero, one),
+                                             _mm_andnot_pd(hi_zero, hi)));
+
+        // Range reduction for q > 0.66
+        const __m128d big = _mm_cmpgt_pd(q, red);
+        const __m128d qr  = _mm_div_pd(_mm_sub_pd(q, one), _mm_add_pd(q, one));
+        q = _mm_or_pd(_mm_and_pd(big, qr), _mm_andnot_pd(big, q));
+        const __m128d base = _mm_and_pd(big, pi_4);
+
+        const __m128d z = _mm_mul_pd(q, q);
+        __m128d p = _mm_set1_pd(kP0);
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(kP1));
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(kP2));
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(kP3));
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(kP4));
+        __m128d r = _mm_add_pd(z, _mm_set1_pd(kQ0));
+        r = _mm_add_pd(_mm_mul_pd(r, z), _mm_set1_pd(kQ1));
+        r = _mm_add_pd(_mm_mul_pd(r, z), _mm_set1_pd(kQ2));
+        r = _mm_add_pd(_mm_mul_pd(r, z), _mm_set1_pd(kQ3));
+        r = _mm_add_pd(_mm_mul_pd(r, z), _mm_set1_pd(kQ4));
+        __m128d a = _mm_add_pd(base,
+                    _mm_add_pd(q, _mm_mul_pd(_mm_mul_pd(q, z), _mm_div_pd(p, r))));
+
+        // Quadrant fix-up
+        const __m128d swap = _mm_cmpgt_pd(ax, ay);
+        a = _mm_or_pd(_mm_and_pd(swap, _mm_sub_pd(pi_2, a)), _mm_andnot_pd(swap, a));
+        const __m128d south = _mm_cmplt_pd(y, zero);
+        a = _mm_or_pd(_mm_and_pd(south, _mm_sub_pd(pi, a)), _mm_andnot_pd(south, a));
+        const __m128d west = _mm_cmplt_pd(x, zero);
+        a = _mm_or_pd(_mm_and_pd(west, _mm_sub_pd(two_pi, a)), _mm_andnot_pd(west, a));
+        const __m128d b = _mm_mul_pd(a, to_deg);
+
+        // Bearing rate with ±180° fold
+        __m128d db = _mm_sub_pd(b, _mm_loadu_pd(bearing + i));
+        db = _mm_sub_pd(db, _mm_and_pd(_mm_cmpgt_pd(db, d180), d360));
+        db = _mm_add_pd(db, _mm_and_pd(_mm_cmplt_pd(db, _mm_sub_pd(zero, d180)), d360));
+        _mm_storeu_pd(rate + i, _mm_mul_pd(db, vinv));
+        _mm_storeu_pd(bearing + i, b);
+    }
+    for (; i < count; ++i)
+        scalarOne(rel_x[i], rel_y[i], inv_dt, bearing[i], range[i], rate[i]);
+}
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+void kernelAvx2(const double *rel_x, const double *rel_y, double inv_dt,
+                double *bearing, double *range, double *rate, int count)
+{
+    const __m256d sign   = _mm256_set1_pd(-0.0);
+    const __m256d zero   = _mm256_setzero_pd();
+    const __m256d one    = _mm256_set1_pd(1.0);
+    const __m256d red    = _mm256_set1_pd(0.66);
+    const __m256d pi_4   = _mm256_set1_pd(kPi / 4.0);
+    const __m256d pi_2   = _mm256_set1_pd(kPi / 2.0);
+    const __m256d pi     = _mm256_set1_pd(kPi);
+    const __m256d two_pi = _mm256_set1_pd(2.0 * kPi);
+    const __m256d to_deg = _mm256_set1_pd(kRadToDeg);
+    const __m256d d180   = _mm256_set1_pd(180.0);
+    const __m256d m180   = _mm256_set1_pd(-180.0);
+    const __m256d d360   = _mm256_set1_pd(360.0);
+    const __m256d vinv   = _mm256_set1_pd(inv_dt);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d x = _mm256_loadu_pd(rel_x + i);
+        const __m256d y = _mm256_loadu_pd(rel_y + i);
+
+        _mm256_storeu_pd(range + i,
+                         _mm256_sqrt_pd(_mm256_fmadd_pd(x, x, _mm256_mul_pd(y, y))));
+
+        const __m256d ax = _mm256_andnot_pd(sign, x);
+        const __m256d ay = _mm256_andnot_pd(sign, y);
+        const __m256d lo = _mm256_min_pd(ax, ay);
+        const __m256d hi = _mm256_max_pd(ax, ay);
+        const __m256d hi_zero = _mm256_cmp_pd(hi, zero, _CMP_EQ_OQ);
+        __m256d q = _mm256_div_pd(lo, _mm256_blendv_pd(hi, one, hi_zero));
+
+        // Range reduction for q > 0.66
+        const __m256d big = _mm256_cmp_pd(q, red, _CMP_GT_OQ);
+        q = _mm256_blendv_pd(q, _mm256_div_pd(_mm256_sub_pd(q, one),
+                                              _mm256_add_pd(q, one)), big);
+        const __m256d base = _mm256_and_pd(big, pi_4);
+
+        const __m256d z = _mm256_mul_pd(q, q);
+        __m256d p = _mm256_set1_pd(kP0);
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(kP1));
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(kP2));
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(kP3));
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(kP4));
+        __m256d r = _mm256_add_pd(z, _mm256_set1_pd(kQ0));
+        r = _mm256_fmadd_pd(r, z, _mm256_set1_pd(kQ1));
+        r = _mm256_fmadd_pd(r, z, _mm256_set1_pd(kQ2));
+        r = _mm256_fmadd_pd(r, z, _mm256_set1_pd(kQ3));
+        r = _mm256_fmadd_pd(r, z, _mm256_set1_pd(kQ4));
+        __m256d a = _mm256_add_pd(base,
+                    _mm256_fmadd_pd(_mm256_mul_pd(q, z), _mm256_div_pd(p, r), q));
+
+        // Quadrant fix-up
+        a = _mm256_blendv_pd(a, _mm256_sub_pd(pi_2, a), _mm256_cmp_pd(ax, ay, _CMP_GT_OQ));
+        a = _mm256_blendv_pd(a, _mm256_sub_pd(pi, a), _mm256_cmp_pd(y, zero, _CMP_LT_OQ));
+        a = _mm256_blendv_pd(a, _mm256_sub_pd(two_pi, a), _mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+        const __m256d b = _mm256_mul_pd(a, to_deg);
+
+        // Bearing rate with ±180° fold
+        __m256d db = _mm256_sub_pd(b, _mm256_loadu_pd(bearing + i));
+        db = _mm256_sub_pd(db, _mm256_and_pd(_mm256_cmp_pd(db, d180, _CMP_GT_OQ), d360));
+        db = _mm256_add_pd(db, _mm256_and_pd(_mm256_cmp_pd(db, m180, _CMP_LT_OQ), d360));
+        _mm256_storeu_pd(rate + i, _mm256_mul_pd(db, vinv));
+        _mm256_storeu_pd(bearing + i, b);
+    }
+    for (; i < count; ++i)
+        scalarOne(rel_x[i], rel_y[i], inv_dt, bearing[i], range[i], rate[i]);
+}
+
+#pragma GCC pop_options
+
+#endif // TSA_BEARING_KERNEL_X86
+
+typedef void (*KernelFn)(const double *, const double *, double,
+                         double *, double *, double *, int);
+
+KernelFn kernelFor(BearingKernelIsa isa)
+{
+    switch (isa) {
+#ifdef TSA_BEARING_KERNEL_X86
+    case BearingKernelIsa::AVX2: return kernelAvx2;
+    case BearingKernelIsa::SSE2: return kernelSse2;
+#endif
+    default:                     return kernelScalar;
+    }
+}
+
+std::atomic<int> g_active_isa(-1);   ///< -1 until the first call detects the CPU
+
+} // namespace
+
+/**
+ * @brief Best instruction set supported by the running CPU
+ */
+BearingKernelIsa bearingKernelBestIsa()
+{
+#ifdef TSA_BEARING_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return BearingKernelIsa::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return BearingKernelIsa::SSE2;
+#endif
+    return BearingKernelIsa::Scalar;
+}
+
+/**
+ * @brief Instruction set currently used by computeBearingRangeBatch()
+ */
+BearingKernelIsa bearingKernelIsa()
+{
+    int isa = g_active_isa.load(std::memory_order_relaxed);
+    if (isa < 0) {
+        isa = static_cast<int>(bearingKernelBestIsa());
+        g_active_isa.store(isa, std::memory_order_relaxed);
+    }
+    return static_cast<BearingKernelIsa>(isa);
+}
+
+/**
+ * @brief Forces a specific implementation, clamped to what the CPU supports
+ * @param isa Requested instruction set
+ */
+void setBearingKernelIsa(BearingKernelIsa isa)
+{
+    const BearingKernelIsa best = bearingKernelBestIsa();
+    if (static_cast<int>(isa) > static_cast<int>(best))
+        isa = best;
+    g_active_isa.store(static_cast<int>(isa), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Human-readable name of an instruction set
+ */
+const char *bearingKernelIsaName(BearingKernelIsa isa)
+{
+    switch (isa) {
+    case BearingKernelIsa::AVX2: return "avx2";
+    case BearingKernelIsa::SSE2: return "sse2";
+    default:                     return "scalar";
+    }
+}
+
+/**
+ * @brief Computes range, bearing and bearing rate for a batch of contacts
+ *
+ * Dispatches to the implementation selected by bearingKernelIsa().
+ */
+void computeBearingRangeBatch(const double *rel_x, const double *rel_y,
+                              double inv_dt, double *bearing,
+                              double *range, double *rate, int count)
+{
+    kernelFor(bearingKernelIsa())(rel_x, rel_y, inv_dt, bearing, range, rate, count);
+}
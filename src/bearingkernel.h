@@ -0,0 +1,73 @@
+#ifndef BEARINGKERNEL_H
+#define BEARINGKERNEL_H
+
+/**
+ * @file bearingkernel.h
+ * @brief Batch range / bearing / bearing-rate kernel for many contacts
+ *
+ * Vectorized counterpart of TSAWidget::calculateRange() and
+ * TSAWidget::calculateBearing(), plus the ±180° folded bearing rate.
+ * The implementation is picked at runtime from the instruction sets the
+ * CPU supports (AVX2+FMA, SSE2, or plain scalar code).
+ *
+ * Accuracy against the scalar functions:
+ * - Range: within 1 ulp (the SIMD path may fuse the multiply-add)
+ * - Bearing: within 1e-9 degrees (polynomial atan, ~2 ulp in radians)
+ * - Bearing rate: within 1e-9 / dt degrees/second
+ */
+
+/**
+ * @brief Instruction set used by computeBearingRangeBatch()
+ */
+enum class BearingKernelIsa {
+    Scalar,     ///< Portable fallback using std::atan2 / std::sqrt
+    SSE2,       ///< 2 doubles per step
+    AVX2        ///< 4 doubles per step, requires AVX2 and FMA
+};
+
+/**
+ * @brief Best instruction set supported by the running CPU
+ */
+BearingKernelIsa bearingKernelBestIsa();
+
+/**
+ * @brief Instruction set currently used by computeBearingRangeBatch()
+ */
+BearingKernelIsa bearingKernelIsa();
+
+/**
+ * @brief Forces a specific implementation (for benchmarking and checks)
+ *
+ * Requests for an instruction set the CPU lacks fall back to the best
+ * supported one.
+ *
+ * @param isa Requested instruction set
+ */
+void setBearingKernelIsa(BearingKernelIsa isa);
+
+/**
+ * @brief Human-readable name of an instruction set
+ */
+const char *bearingKernelIsaName(BearingKernelIsa isa);
+
+/**
+ * @brief Computes range, bearing and bearing rate for a batch of contacts
+ *
+ * Positions are relative to own ship (target minus own ship) with X east
+ * and Y north. On entry @p bearing holds the previous bearings, on return
+ * the new ones; the rate is the bearing change folded into ±180° times
+ * @p inv_dt.
+ *
+ * @param rel_x Relative X positions (nautical miles)
+ * @param rel_y Relative Y positions (nautical miles)
+ * @param inv_dt Reciprocal of the elapsed time (1/seconds), 0 for no rate
+ * @param bearing In: previous bearings, out: new bearings (degrees, 0-360°)
+ * @param range Out: ranges (nautical miles)
+ * @param rate Out: bearing rates (degrees/second)
+ * @param count Number of contacts
+ */
+void computeBearingRangeBatch(const double *rel_x, const double *rel_y,
+                              double inv_dt, double *bearing,
+                              double *range, double *rate, int count);
+
+#endif // BEARINGKERNEL_H
@@ -0,0 +1,86 @@
+#include "configwatcher.h"
+#include "eventlog.h"
+#include <QDebug>
+#include <QFileInfo>
+
+static const LogEventFormat kConfigReloadEvent = { "config.reload", 1, { "changes" } };
+
+/**
+ * @brief Constructor - keeps the path and base values, does not read the file
+ * @param path Configuration file
+ * @param base Values for members the file does not set
+ * @param parent Parent object (optional)
+ */
+ConfigWatcher::ConfigWatcher(const QString &path, const DisplayConfig &base, QObject *parent)
+    : QObject(parent),
+      path(path),
+      base(base),
+      current(base)
+{
+    settle.setSingleShot(true);
+    settle.setInterval(kSettleMs);
+    connect(&settle, &QTimer::timeout, this, &ConfigWatcher::reload);
+    connect(&watcher, &QFileSystemWatcher::fileChanged, this, &ConfigWatcher::onWatchedPathChanged);
+    connect(&watcher, &QFileSystemWatcher::directoryChanged,
+            this, &ConfigWatcher::onWatchedPathChanged);
+}
+
+/**
+ * @brief Reads the file once and starts watching it
+ * @param error Set to a message on failure
+ * @return false if the file cannot be loaded (nothing is watched)
+ */
+bool ConfigWatcher::load(QString *error)
+{
+    DisplayConfig loaded = base;
+    if (!DisplayConfig::load(path, loaded, error))
+        return false;
+    current = loaded;
+    watcher.addPath(QFileInfo(path).absolutePath());
+    rewatch();
+    return true;
+}
+
+/**
+ * @brief Restarts the settle timer on any file or directory change
+ *
+ * Directory notifications also fire for unrelated files; they only cost
+ * a re-read that finds no change.
+ */
+void ConfigWatcher::onWatchedPathChanged()
+{
+    settle.start();
+}
+
+/**
+ * @brief Re-reads the file and emits configChanged() if it differs
+ */
+void ConfigWatcher::reload()
+{
+    rewatch();
+    if (!QFileInfo::exists(path))
+        return;                       // Mid-save, or removed: keep the current values
+
+    DisplayConfig loaded = base;
+    QString error;
+    if (!DisplayConfig::load(path, loaded, &error)) {
+        qWarning().noquote() << "Configuration not reloaded:" << error;
+        return;
+    }
+
+    const unsigned changes = loaded.changesFrom(current);
+    if (!changes)
+        return;
+    current = loaded;
+    EVENT_LOG(LogCategory::Config, LogLevel::Info, kConfigReloadEvent, double(changes));
+    emit configChanged(current, changes);
+}
+
+/**
+ * @brief Watches the file again if a rename-over-save dropped it
+ */
+void ConfigWatcher::rewatch()
+{
+    if (!watcher.files().contains(path) && QFileInfo::exists(path))
+        watcher.addPath(path);
+}
@@ -0,0 +1,81 @@
+#ifndef CONFIGWATCHER_H
+#define CONFIGWATCHER_H
+
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include "displayconfig.h"
+
+/**
+ * @brief ConfigWatcher - Reloads a DisplayConfig file when it changes on disk
+ *
+ * Watches the file and its directory with QFileSystemWatcher, so editors
+ * that save by writing a new file and renaming it over the old one are
+ * followed too. Change notifications are coalesced for kSettleMs before
+ * the file is read. A file that fails to parse or validate is reported
+ * and ignored; the last good configuration stays applied.
+ *
+ * Every load starts from the base configuration (defaults plus command
+ * line), so removing a member from the file restores its base value.
+ */
+class ConfigWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int kSettleMs = 100;  ///< Quiet time after the last change before reloading
+
+    /**
+     * @brief Constructs a watcher; nothing is read until load()
+     * @param path Configuration file
+     * @param base Values for members the file does not set
+     * @param parent Parent object (optional)
+     */
+    ConfigWatcher(const QString &path, const DisplayConfig &base, QObject *parent = nullptr);
+
+    /**
+     * @brief Reads the file once and starts watching it
+     * @param error Set to a message on failure
+     * @return false if the file cannot be loaded (nothing is watched)
+     */
+    bool load(QString *error = nullptr);
+
+    /**
+     * @brief Configuration currently in effect
+     */
+    const DisplayConfig &config() const { return current; }
+
+signals:
+    /**
+     * @brief Emitted after a reload that changed something
+     * @param config New configuration
+     * @param changes DisplayConfig::Change bits
+     */
+    void configChanged(const DisplayConfig &config, unsigned changes);
+
+private slots:
+    /**
+     * @brief Restarts the settle timer on any file or directory change
+     */
+    void onWatchedPathChanged();
+
+    /**
+     * @brief Re-reads the file and emits configChanged() if it differs
+     */
+    void reload();
+
+private:
+    /**
+     * @brief Watches the file again if a rename-over-save dropped it
+     */
+    void rewatch();
+
+    QString path;                     ///< Watched configuration file
+    DisplayConfig base;               ///< Defaults and command-line values
+    DisplayConfig current;            ///< Last configuration loaded successfully
+    QFileSystemWatcher watcher;       ///< File and directory notifications
+    QTimer settle;                    ///< Single-shot, coalesces bursts of notifications
+};
+
+#endif // CONFIGWATCHER_H
@@ -1,431 +1,286 @@
 #include "diagramwidget.h"
+#include "simhost.h"
+#include <QMouseEvent>
+#include <QPaintEvent>
 #include <QPainter>
-#include <QPainterPath>
-#include <QDebug>
+#include <QRegion>
+#include <QSignalBlocker>
+#include <QSlider>
+#include <QToolTip>
+#include <QtMath>
+#include <climits>
+
+/**
+ * @brief Constructor - Initializes the TSA display widget with the default scenario
+ * @param parent Parent widget (optional)
+ */
+TSAWidget::TSAWidget(QWidget *parent)
+    : TSAWidget(Scenario::defaultScenario(), parent)
+{
+}
 
 /**
  * @brief Constructor - Initializes the TSA display widget
  * 
- * Sets up initial simulation parameters, calculates starting positions,
- * and configures the update timer for continuous simulation.
+ * Starts the simulation for the scenario on its own thread (SimHost) and
+ * repaints whenever a new snapshot is published.
  * 
+ * @param scenario Own ship, contacts and sensor line to display
  * @param parent Parent widget (optional)
  */
-TSAWidget::TSAWidget(QWidget *parent)
+TSAWidget::TSAWidget(const Scenario &scenario, QWidget *parent)
     : QWidget(parent),
-      timer(new QTimer(this)),
-      current_time_sec(0.0),
-      prev_bearing(0.0),
-      current_bearing(45.0),
-      current_range(0.0),
-      current_bearing_rate(0.0),
-      target_course(90.0),      // Target heading East
-      target_speed(8.0),        // Target speed 8 knots
-      target_x(3.0),            // Initial target X position (nm)
-      target_y(3.0),            // Initial target Y position (nm)
-      sensor_line_start(80, 480),   // Sensor beam start point
-      sensor_line_end(720, 80)      // Sensor beam end point
+      sim(new SimHost(scenario, this)),
+      timeline(new QSlider(Qt::Horizontal, this)),
+      replay_start_sec(0.0),
+      replay_step_sec(1.0)
 {
-    // Calculate initial target position relative to own ship
-    current_range   = calculateRange(target_x, target_y);
-    current_bearing = calculateBearing(target_x, target_y);
-    prev_bearing    = current_bearing;
+    renderer.setSensorLine(scenario.sensor_start, scenario.sensor_end);
 
-    // Set up timer for simulation updates (every 2 seconds)
-    connect(timer, &QTimer::timeout, this, &TSAWidget::updateSimulation);
-    timer->start(2000);  // 2000ms = 2 seconds
+    // Timeline slider: hidden until a replay is opened; playback holds
+    // while the handle is dragged and seeks are coalesced by the worker
+    timeline->hide();
+    connect(timeline, &QSlider::valueChanged, this, &TSAWidget::onTimelineMoved);
+    connect(timeline, &QSlider::sliderPressed, this, [this]() {
+        sim->setReplayPaused(true);
+    });
+    connect(timeline, &QSlider::sliderReleased, this, [this]() {
+        sim->setReplayPaused(false);
+    });
+    connect(sim, &SimHost::replayOpened, this, &TSAWidget::onReplayOpened);
+
+    // Repaint when a new snapshot is available (queued to the GUI thread)
+    connect(sim, &SimHost::snapshotPublished, this, &TSAWidget::onSnapshotPublished);
 }
 
 /**
- * @brief Simulation update slot - called every timer interval
- * 
- * Updates target position, recalculates bearing/range/rate,
- * and triggers widget repaint. This is the main simulation loop.
+ * @brief Destructor - the SimHost child stops the simulation thread
  */
-void TSAWidget::updateSimulation()
+TSAWidget::~TSAWidget()
 {
-    // Store previous bearing for rate calculation
-    prev_bearing = current_bearing;
-    
-    // Advance simulation time
-    current_time_sec += 2.0;
-
-    // Calculate new target position and update measurements
-    calculateTargetPosition();
-    
-    // Calculate bearing rate (degrees per second)
-    current_bearing_rate = (current_bearing - prev_bearing) / 2.0;
+}
 
-    // Normalize bearing rate to handle 360° wrap-around
-    if (current_bearing_rate > 180.0)  current_bearing_rate -= 360.0;
-    if (current_bearing_rate < -180.0) current_bearing_rate += 360.0;
+/**
+ * @brief Sets the fixed simulation step on the simulation thread
+ * @param step_sec Step in seconds
+ */
+void TSAWidget::setSimulationStep(double step_sec)
+{
+    sim->setStep(step_sec);
+}
 
-    // Debug output for monitoring simulation
-    qDebug() << "Time:" << current_time_sec
-             << "Bearing:" << current_bearing
-             << "Range:" << current_range
-             << "Rate:"  << current_bearing_rate;
+/**
+ * @brief Records every simulation step to a binary file
+ * @param path Recording file (truncated)
+ */
+void TSAWidget::startRecording(const QString &path)
+{
+    sim->startRecording(path);
+}
 
-    // Trigger widget repaint to show updated display
-    update();
+/**
+ * @brief Shows a recording instead of the live simulation
+ * @param path Recording file
+ */
+void TSAWidget::startReplay(const QString &path)
+{
+    sim->startReplay(path);
 }
 
 /**
- * @brief Calculates new target position based on movement over time
- * 
- * Simulates both own ship movement (North at 10 knots) and target movement
- * (East at 8 knots), then calculates relative position and measurements.
+ * @brief Jumps the replay to the given simulation time
+ * @param time_sec Simulation time (seconds)
  */
-void TSAWidget::calculateTargetPosition()
+void TSAWidget::seekReplay(double time_sec)
 {
-    double t = current_time_sec / 3600.0; // Convert seconds to hours
-    
-    // Own ship movement (heading North at 10 knots)
-    double own_x = 0.0;
-    double own_y = S_own * t;  // Northward movement
+    sim->seekReplay(time_sec);
+}
 
-    // Target movement (heading East at 8 knots)
-    double dx = target_speed * qSin(qDegreesToRadians(target_course)) * t;
-    double dy = target_speed * qCos(qDegreesToRadians(target_course)) * t;
-    double x  = 3.0 + dx;  // Initial X + movement
-    double y  = 3.0 + dy;  // Initial Y + movement
+/**
+ * @brief Sets up and shows the timeline slider for a replay
+ * @param start_sec Time of the first tick
+ * @param end_sec Time of the last tick
+ * @param step_sec Recorded step
+ */
+void TSAWidget::onReplayOpened(double start_sec, double end_sec, double step_sec)
+{
+    replay_start_sec = start_sec;
+    replay_step_sec = step_sec > 0.0 ? step_sec : 1.0;
+    const double ticks = qMax(0.0, std::ceil((end_sec - start_sec) / replay_step_sec));
 
-    // Calculate relative position (target position minus own ship position)
-    double rel_x = x - own_x;
-    double rel_y = y - own_y;
-    
-    // Update current measurements
-    current_range   = calculateRange(rel_x, rel_y);
-    current_bearing = calculateBearing(rel_x, rel_y);
+    const QSignalBlocker blocker(timeline);
+    timeline->setRange(0, static_cast<int>(qMin(ticks, double(INT_MAX))));
+    timeline->setSingleStep(1);
+    timeline->setPageStep(qMax(1, timeline->maximum() / 20));
+    timeline->setValue(0);
+    timeline->show();
 }
 
 /**
- * @brief Calculates range (distance) from origin to given coordinates
- * @param x X coordinate in nautical miles
- * @param y Y coordinate in nautical miles
- * @return Range in nautical miles
+ * @brief Seeks to the tick selected on the timeline slider
+ *
+ * Fires for drags, clicks and keys; the worker coalesces seeks, so a
+ * fast drag only decodes the newest position.
+ *
+ * @param value Slider position (ticks from the start)
  */
-double TSAWidget::calculateRange(double x, double y) const
+void TSAWidget::onTimelineMoved(int value)
 {
-    return qSqrt(x*x + y*y);  // Pythagorean theorem
+    sim->requestReplaySeek(replay_start_sec + value * replay_step_sec);
 }
 
 /**
- * @brief Calculates bearing (direction) from origin to given coordinates
- * @param x X coordinate in nautical miles
- * @param y Y coordinate in nautical miles
- * @return Bearing in degrees (0-360°)
+ * @brief Invalidates the cached static layer on resize and places the timeline
+ * @param event Resize event information
  */
-double TSAWidget::calculateBearing(double x, double y) const
+void TSAWidget::resizeEvent(QResizeEvent *event)
 {
-    double b = qRadiansToDegrees(qAtan2(x, y));
-    return (b < 0.0 ? b + 360.0 : b);  // Normalize to 0-360°
+    renderer.invalidateBackground();
+    const int h = timeline->sizeHint().height();
+    timeline->setGeometry(8, height() - h - 8, width() - 16, h);
+    QWidget::resizeEvent(event);
 }
 
 /**
- * @brief Gets own ship position on the display
- * @return QPointF representing ship position in widget coordinates
+ * @brief Shows the contact under the cursor in a tool tip
+ *
+ * Picks through the snapshot's spatial index (TSARenderer::pickTrack()),
+ * so a click costs the same with ten contacts or ten thousand. A click
+ * away from every contact hides the tip.
+ *
+ * @param event Mouse event information
  */
-QPointF TSAWidget::getShipPosition() const
+void TSAWidget::mousePressEvent(QMouseEvent *event)
 {
-    return sensor_line_start + 0.75 * (sensor_line_end - sensor_line_start);
-}
+    static const qreal kPickRadiusPx = 6.0;
 
+    const SimSnapshot &snap = sim->snapshot();
+    const int track = renderer.pickTrack(snap, event->localPos(), kPickRadiusPx);
+    if (track < 0) {
+        QToolTip::hideText();
+        QWidget::mousePressEvent(event);
+        return;
+    }
 
+    QString text = QString("Track %1\nBRG %2°  RNG %3 nm\nCSE %4°  SPD %5 kn")
+                       .arg(track)
+                       .arg(snap.track_bearing[track], 0, 'f', 1)
+                       .arg(snap.track_range[track], 0, 'f', 2)
+                       .arg(snap.course[track], 0, 'f', 0)
+                       .arg(snap.speed[track], 0, 'f', 1);
+    if (track < snap.tma_solved.size() && snap.tma_solved[track])
+        text += QString("\nTMA RNG %1 nm  CSE %2°  SPD %3 kn")
+                    .arg(snap.tma_range[track], 0, 'f', 2)
+                    .arg(snap.tma_course[track], 0, 'f', 0)
+                    .arg(snap.tma_speed[track], 0, 'f', 1);
+    QToolTip::showText(event->globalPos(), text, this);
+    event->accept();
+}
 
 /**
- * @brief Gets sensor position on the display
- * @return QPointF representing sensor position in widget coordinates
+ * @brief Moves the sensor beam line and invalidates the cached static layer
+ * @param start Start point of the beam (widget coordinates)
+ * @param end End point of the beam (widget coordinates)
  */
-QPointF TSAWidget::getSensorPosition() const
+void TSAWidget::setSensorLine(const QPointF &start, const QPointF &end)
 {
-    return sensor_line_start + 0.45 * (sensor_line_end - sensor_line_start);
+    renderer.setSensorLine(start, end);
+    update();
 }
 
 /**
- * @brief Draws an arrow with specified parameters
+ * @brief Enables or disables the cached static layer
  * 
- * Draws a line with arrowhead at the end, useful for displaying
- * velocity vectors and tactical directions.
+ * With the cache disabled the static layer is rasterized on every
+ * repaint, as before; useful for measuring the gain.
  * 
- * @param p QPainter reference for drawing
- * @param from Starting point of arrow
- * @param to Ending point of arrow
- * @param headLen Length of arrow head
- * @param headAngleDeg Angle of arrow head in degrees
- * @param color Arrow color
- * @param width Arrow line width
+ * @param enabled true to blit the cached pixmap
  */
-void TSAWidget::drawArrow(QPainter &p, const QPointF &from, const QPointF &to,
-                          qreal headLen, qreal headAngleDeg,
-                          const QColor &color, int width)
+void TSAWidget::setBackgroundCacheEnabled(bool enabled)
 {
-    // Draw the main arrow shaft
-    p.setPen(QPen(color, width, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-    p.drawLine(from, to);
-
-    // Calculate arrow head points
-    qreal angle = qAtan2(to.y() - from.y(), to.x() - from.x());
-    qreal a1 = angle + qDegreesToRadians(180.0 - headAngleDeg);
-    qreal a2 = angle - qDegreesToRadians(180.0 - headAngleDeg);
-
-    QPointF h1(to.x() + headLen * qCos(a1), to.y() + headLen * qSin(a1));
-    QPointF h2(to.x() + headLen * qCos(a2), to.y() + headLen * qSin(a2));
-    
-    // Draw arrow head as filled polygon
-    QPolygonF head; head << to << h1 << h2;
-    p.setBrush(color);
-    p.drawPolygon(head);
+    renderer.setBackgroundCacheEnabled(enabled);
+    update();
 }
 
 /**
- * @brief Helper function to determine which side of a line a point lies on
- * @param A First point of the line
- * @param B Second point of the line  
- * @param P Point to test
- * @return Positive value if P is on "left" side, negative if on "right" side
+ * @brief Sets how the shaded half-space is hatched
+ * @param style Fill method, spacing, angle, width and colour
  */
-static qreal sideOfLine(const QPointF &A, const QPointF &B, const QPointF &P) {
-    // cross((B–A),(P–A))
-    return (B.x()-A.x())*(P.y()-A.y()) - (B.y()-A.y())*(P.x()-A.x());
+void TSAWidget::setHatchStyle(const HatchStyle &style)
+{
+    renderer.setHatchStyle(style);
+    update();
 }
 
 /**
- * @brief Returns the two points where line through A→B intersects the widget rectangle
- * @param A First point of the line
- * @param B Second point of the line
- * @param rect Widget rectangle bounds
- * @return Pair of intersection points spanning the full widget
+ * @brief Applies display and simulation parameters
+ *
+ * Only the caches that depend on the changed parameters are dropped (see
+ * DisplayConfig::changesFrom()); a scale change repaints just the old
+ * and new dynamic layer like a new snapshot does.
+ *
+ * @param config New parameters
  */
-QPair<QPointF,QPointF> computeFullLine(const QPointF &A, const QPointF &B, const QRectF &rect)
+void TSAWidget::setConfig(const DisplayConfig &config)
 {
-    // Line: parametric P(t)=A+t*(B–A). Compute intersections with each of the four edges.
-    QVector<QPointF> hits;
-    QPointF d = B - A;
-
-    auto intersect = [&](double x, double yMin, double yMax, bool vertical) {
-        // if vertical edge: x=x0, solve t = (x0–Ax)/dx, then y=Ay+t*dy must lie between yMin,yMax
-        // if horizontal edge: same logic swapping axes
-        double t = vertical
-            ? (x - A.x()) / d.x()
-            : (x - A.y()) / d.y();
-        QPointF P = A + t * d;
-        double y = vertical ? P.y() : P.x();
-        if (vertical ? (y >= yMin && y <= yMax)
-                     : (y >= yMin && y <= yMax))
-            hits.append(P);
-    };
-
-    // Left edge (x=rect.left())
-    if (!qFuzzyIsNull(d.x()))
-        intersect(rect.left(), rect.top(), rect.bottom(), /*vertical*/true);
-    // Right edge
-    if (!qFuzzyIsNull(d.x()))
-        intersect(rect.right(), rect.top(), rect.bottom(), true);
-    // Top edge (y=rect.top())
-    if (!qFuzzyIsNull(d.y()))
-        intersect(rect.top(), rect.left(), rect.right(), /*vertical*/false);
-    // Bottom edge
-    if (!qFuzzyIsNull(d.y()))
-        intersect(rect.bottom(), rect.left(), rect.right(), false);
-
-    // Keep only two unique intersection points (simple approach)
-    QVector<QPointF> pts;
-    for (const auto &hit : hits) {
-        bool found = false;
-        for (const auto &pt : pts) {
-            if (qAbs(hit.x() - pt.x()) < 1e-6 && qAbs(hit.y() - pt.y()) < 1e-6) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            pts.append(hit);
-            if (pts.size() >= 2) break;
-        }
+    const unsigned changes = renderer.setConfig(config);
+    if (changes & DisplayConfig::SimStep)
+        sim->setStep(config.step_sec);
+    if (changes & DisplayConfig::StaticLayer) {
+        update();
+    } else if (changes & DisplayConfig::DynamicLayer) {
+        const QRect damage = renderer.damageRect(size(), devicePixelRatioF(), sim->snapshot());
+        update(QRegion(renderer.dynamicBounds()) | damage);
     }
-    
-    if (pts.size() >= 2)
-        return { pts[0], pts[1] };
-    return { A, B }; // fallback
 }
 
 /**
- * @brief Clip the half-space on the sideSelected side of line A→B to the rect
- * @param A First point of the line
- * @param B Second point of the line
- * @param bounds Widget rectangle bounds
- * @param sideSelectedIsLeft Whether the selected side is left of the line
- * @return Polygon representing the clipped half-space
+ * @brief Shows or hides the timing overlay
+ * @param enabled true to draw PerfStats percentiles over the display
  */
-QPolygonF TSAWidget::buildHalfSpacePoly(
-    const QPointF &A, const QPointF &B,
-    const QRectF &bounds,
-    bool sideSelectedIsLeft)
+void TSAWidget::setPerfOverlayEnabled(bool enabled)
 {
-    // Collect rectangle corners
-    QVector<QPointF> pts = {
-        bounds.topLeft(), bounds.topRight(),
-        bounds.bottomRight(), bounds.bottomLeft()
-    };
-    // Keep corners on selected side
-    QPolygonF poly;
-    for (auto &pt : pts) {
-        bool left = sideOfLine(A, B, pt) > 0;
-        if (left == sideSelectedIsLeft)
-            poly.append(pt);
-    }
-    // Add beam-rect intersections
-    auto inte = computeFullLine(A, B, bounds);
-    for (auto &pt : {inte.first, inte.second}) {
-        bool left = sideOfLine(A, B, pt) > 0;
-        if (left == sideSelectedIsLeft)
-            poly.append(pt);
-    }
-    // Return a convex hull to ensure correct winding
-    return buildConvexHull(QVector<QPointF>(poly.begin(), poly.end()));
+    renderer.setPerfOverlayEnabled(enabled);
+    update();
 }
 
 /**
- * @brief Builds a convex hull from a set of points using Graham scan
- * @param points Input points
- * @return Convex hull polygon
+ * @brief Picks up a published snapshot and schedules a repaint of its damage
+ * 
+ * Also moves the replay timeline to the snapshot's time. Only the union of what the previous frame drew over the static layer
+ * and what the new snapshot will draw is invalidated; the rest of the
+ * widget keeps its pixels. The snapshot is taken here rather than in
+ * paintEvent() so the frame painted is the one the damage was computed
+ * for.
  */
-QPolygonF TSAWidget::buildConvexHull(const QVector<QPointF> &points)
+void TSAWidget::onSnapshotPublished()
 {
-    if (points.size() < 3) {
-        return QPolygonF(points);
-    }
-    
-    // Find the point with lowest y-coordinate (and leftmost if tied)
-    int lowest = 0;
-    for (int i = 1; i < points.size(); ++i) {
-        if (points[i].y() < points[lowest].y() || 
-            (points[i].y() == points[lowest].y() && points[i].x() < points[lowest].x())) {
-            lowest = i;
-        }
-    }
-    
-    // Sort points by polar angle with respect to lowest point
-    QVector<QPointF> sorted = points;
-    std::swap(sorted[0], sorted[lowest]);
-    
-    // Sort remaining points by polar angle
-    std::sort(sorted.begin() + 1, sorted.end(), [&](const QPointF &a, const QPointF &b) {
-        double angleA = qAtan2(a.y() - sorted[0].y(), a.x() - sorted[0].x());
-        double angleB = qAtan2(b.y() - sorted[0].y(), b.x() - sorted[0].x());
-        return angleA < angleB;
-    });
-    
-    // Graham scan
-    QVector<QPointF> hull;
-    hull.push_back(sorted[0]);
-    hull.push_back(sorted[1]);
-    
-    for (int i = 2; i < sorted.size(); ++i) {
-        while (hull.size() > 1 && 
-               sideOfLine(hull[hull.size()-2], hull[hull.size()-1], sorted[i]) <= 0) {
-            hull.pop_back();
-        }
-        hull.push_back(sorted[i]);
+    // Pick up the newest complete snapshot (lock-free, never torn)
+    if (!sim->takeSnapshot())
+        return;
+    const SimSnapshot &snap = sim->snapshot();
+
+    // Follow playback on the timeline, unless the user holds the handle
+    if (timeline->isVisible() && !timeline->isSliderDown()) {
+        const QSignalBlocker blocker(timeline);
+        timeline->setValue(qRound((snap.time_sec - replay_start_sec) / replay_step_sec));
     }
-    
-    return QPolygonF(hull);
+
+    const QRect damage = renderer.damageRect(size(), devicePixelRatioF(), snap);
+    update(QRegion(renderer.dynamicBounds()) | damage);
 }
 
 /**
- * @brief Main paint event - renders the complete tactical display
+ * @brief Main paint event - renders the tactical display
  * 
- * This method draws all visual elements in the correct order:
- * 1. Black background
- * 2. Full far-side half-space with hatch
- * 3. Punch out clear corridor along beam
- * 4. Punch out circles around vector origins
- * 5. Draw beam and vectors on top
+ * Hands the current snapshot to the renderer, limited to the area Qt
+ * asks for (the damage of onSnapshotPublished(), or the whole widget
+ * after a resize or an expose).
  * 
- * @param event Paint event information (unused)
+ * @param event Paint event information
  */
-void TSAWidget::paintEvent(QPaintEvent *)
+void TSAWidget::paintEvent(QPaintEvent *event)
 {
     QPainter p(this);
-    p.setRenderHint(QPainter::Antialiasing);
-    p.fillRect(rect(), Qt::black);
-
-    QPointF sensorPos = getSensorPosition();
-    QPointF shipPos = getShipPosition();
-    
-    // Get full-screen line 
-    auto full = computeFullLine(sensorPos, shipPos, rect());
-    QPointF P1 = full.first, P2 = full.second;
-    
-    // Find far end
-    double dist1 = std::hypot(P1.x() - shipPos.x(), P1.y() - shipPos.y());
-    QPointF farEnd = (dist1 > std::hypot(P2.x() - shipPos.x(), P2.y() - shipPos.y())) ? P1 : P2;
-    
-    // Create normal vector
-    QPointF dir = shipPos - farEnd;
-    QPointF normal(-dir.y(), dir.x());
-    normal /= std::hypot(normal.x(), normal.y());
-    
-    // FIXED: Check which side the ship vector points to, then shade OPPOSITE side
-    QPointF shipVector = QPointF(0, -S_own*6);
-    QPointF testPoint = shipPos + shipVector;
-    
-    bool shipVectorLeft = sideOfLine(farEnd, shipPos, testPoint) > 0;
-    if (shipVectorLeft) {
-        // Ship vector on LEFT, so shade RIGHT (flip normal)
-        normal = -normal;
-    }
-    // If ship vector on RIGHT, shade LEFT (keep normal)
-    
-    // FIXED: Create a proper polygon that covers the entire shaded half-space
-    const qreal gap = 15.0;
-    QPointF offsetStart = farEnd + normal * gap;
-    QPointF offsetEnd = shipPos + normal * gap;
-    
-    // Get full-screen line for the white outline (extended to boundaries)
-    auto fullOutline = computeFullLine(offsetStart, offsetEnd, rect());
-    QPointF outlineP1 = fullOutline.first, outlineP2 = fullOutline.second;
-    
-    // Build polygon with screen corners on the shaded side
-    QPolygonF shadedRegion;
-    QVector<QPointF> corners = {rect().topLeft(), rect().topRight(), 
-                                rect().bottomRight(), rect().bottomLeft()};
-    
-    // Add corners that are on the shaded side
-    for (auto &corner : corners) {
-        bool cornerOnShadedSide = (sideOfLine(farEnd, shipPos, corner) > 0) == !shipVectorLeft;
-        if (cornerOnShadedSide) {
-            shadedRegion << corner;
-        }
-    }
-    
-    // Add the extended outline line points
-    shadedRegion << outlineP2 << outlineP1;
-    
-    // Fill with hatching pattern
-    p.setBrush(QBrush(QColor(100,100,100,150), Qt::BDiagPattern));
-    p.setPen(Qt::NoPen);
-    p.drawPolygon(shadedRegion);
-    
-    // Add white outline (extended to screen boundaries)
-    p.setPen(QPen(Qt::white, 2, Qt::SolidLine));
-    p.drawLine(outlineP1, outlineP2);
-    
-    // Draw green bearing line
-    p.setPen(QPen(Qt::green, 4, Qt::SolidLine, Qt::RoundCap));
-    p.drawLine(farEnd, shipPos);
-    
-    // Draw markers
-    p.setBrush(Qt::yellow); p.setPen(Qt::NoPen); p.drawEllipse(shipPos, 6, 6);
-    p.setBrush(Qt::red); p.drawEllipse(sensorPos, 6, 6);
-
-    // Own ship vector 
-    QPointF ownEnd = shipPos + QPointF(0, -S_own*6);
-    drawArrow(p, shipPos, ownEnd, 12, 25, Qt::cyan, 3);
-
-    // FIXED: Target vector - reverse direction
-    QPointF targetStart = sensorPos;
-    QPointF targetEnd = targetStart + (-normal) * 80; // Flip direction with -normal
-    drawArrow(p, targetStart, targetEnd, 12, 25, Qt::red, 3);
-} 
\ No newline at end of file
+    renderer.render(p, size(), devicePixelRatioF(), sim->snapshot(), event->rect());
+}
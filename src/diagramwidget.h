@@ -2,20 +2,20 @@
 #define TSAWIDGET_H
 
 #include <QWidget>
-#include <QTimer>
 #include <QPointF>
-#include <QPolygonF>
-#include <QRectF>
-#include <QColor>
-#include <QVector>
-#include <QtMath>
+#include "simulation.h"
+#include "tsarenderer.h"
+
+class QSlider;
+class SimHost;
 
 /**
  * @brief TSAWidget - Tactical Situation Awareness Display Widget
  * 
  * This widget provides a real-time tactical display for maritime operations,
- * showing sensor coverage, target tracking, and vector analysis. It simulates
- * a naval tactical situation with own ship, target, and various tactical vectors.
+ * showing sensor coverage, target tracking, and vector analysis. The naval
+ * tactical situation is simulated by a SimWorker on a separate thread; the
+ * widget only renders the latest SimSnapshot it publishes.
  * 
  * Key Features:
  * - Real-time simulation with configurable update intervals
@@ -35,119 +35,137 @@ public:
      */
     explicit TSAWidget(QWidget *parent = nullptr);
 
-protected:
     /**
-     * @brief Qt paint event handler - renders the tactical display
-     * @param event Paint event information
+     * @brief Constructs the TSA display widget for a scenario
+     * @param scenario Own ship, contacts and sensor line to display
+     * @param parent Parent widget (optional)
      */
-    void paintEvent(QPaintEvent *event) override;
+    explicit TSAWidget(const Scenario &scenario, QWidget *parent = nullptr);
 
-private slots:
     /**
-     * @brief Updates simulation state every timer interval
+     * @brief Stops the simulation thread and waits for it to finish
+     */
+    ~TSAWidget() override;
+
+    /**
+     * @brief Sets the fixed simulation step
      * 
-     * Called every 2 seconds to update target position, bearing, range,
-     * and bearing rate calculations. Triggers widget repaint.
+     * Forwarded to the simulation thread; bearing rates are always
+     * computed from the step actually simulated.
+     * 
+     * @param step_sec Step in seconds (minimum SimScheduler::kMinStepSec)
      */
-    void updateSimulation();
+    void setSimulationStep(double step_sec);
 
-private:
-    // ===== DRAWING HELPER METHODS =====
-    
     /**
-     * @brief Draws an arrow with specified parameters
-     * @param p QPainter reference for drawing
-     * @param from Starting point of arrow
-     * @param to Ending point of arrow
-     * @param headLen Length of arrow head
-     * @param headAngleDeg Angle of arrow head in degrees
-     * @param color Arrow color
-     * @param width Arrow line width
-     */
-    void drawArrow(QPainter &p, const QPointF &from, const QPointF &to,
-                   qreal headLen, qreal headAngleDeg, const QColor &color, int width);
-    
+     * @brief Moves the sensor beam line
+     * 
+     * Invalidates the cached static layer.
+     * 
+     * @param start Start point of the beam (widget coordinates)
+     * @param end End point of the beam (widget coordinates)
+     */
+    void setSensorLine(const QPointF &start, const QPointF &end);
+
     /**
-     * @brief Clip the half-space on the sideSelected side of line A→B to the rect
-     * @param A First point of the line
-     * @param B Second point of the line
-     * @param bounds Widget rectangle bounds
-     * @param sideSelectedIsLeft Whether the selected side is left of the line
-     * @return Polygon representing the clipped half-space
+     * @brief Enables or disables the cached static layer (default on)
+     * @param enabled true to blit the cached pixmap, false to redraw it
      */
-    QPolygonF buildHalfSpacePoly(const QPointF &A, const QPointF &B,
-                                 const QRectF &bounds, bool sideSelectedIsLeft);
-    
+    void setBackgroundCacheEnabled(bool enabled);
+
     /**
-     * @brief Builds a convex hull from a set of points using Graham scan
-     * @param points Input points
-     * @return Convex hull polygon
+     * @brief Sets how the shaded half-space is hatched
+     * @param style Fill method, spacing, angle, width and colour
      */
-    QPolygonF buildConvexHull(const QVector<QPointF> &points);
-    
+    void setHatchStyle(const HatchStyle &style);
+
     /**
-     * @brief Gets the current own ship position on display
-     * @return QPointF representing ship position in widget coordinates
+     * @brief Applies display and simulation parameters
+     *
+     * Repaints the whole widget if the static layer changed, otherwise
+     * only the area the vectors and markers cover before and after.
+     *
+     * @param config New parameters (e.g. from ConfigWatcher)
      */
-    QPointF getShipPosition() const;
-    
+    void setConfig(const DisplayConfig &config);
+
     /**
-     * @brief Gets the current sensor position on the display
-     * @return QPointF representing sensor position in widget coordinates
+     * @brief Shows or hides the timing overlay
+     * @param enabled true to draw PerfStats percentiles over the display
      */
-    QPointF getSensorPosition() const;
-    
+    void setPerfOverlayEnabled(bool enabled);
 
+    /**
+     * @brief Records every simulation step to a binary file
+     * @param path Recording file (truncated)
+     */
+    void startRecording(const QString &path);
 
-    // ===== SIMULATION LOGIC METHODS =====
-    
     /**
-     * @brief Calculates new target position based on time and movement
-     * 
-     * Updates target_x, target_y, current_bearing, and current_range
-     * based on target course/speed and own ship movement.
+     * @brief Shows a recording instead of the live simulation
+     * @param path Recording file
      */
-    void calculateTargetPosition();
-    
+    void startReplay(const QString &path);
+
     /**
-     * @brief Calculates range from origin to given coordinates
-     * @param x X coordinate (nautical miles)
-     * @param y Y coordinate (nautical miles)
-     * @return Range in nautical miles
+     * @brief Jumps the replay to the given simulation time
+     * @param time_sec Simulation time (seconds)
      */
-    double calculateRange(double x, double y) const;
-    
+    void seekReplay(double time_sec);
+
+private slots:
+    /**
+     * @brief Takes the new snapshot and repaints the area it changes
+     */
+    void onSnapshotPublished();
+
     /**
-     * @brief Calculates bearing from origin to given coordinates
-     * @param x X coordinate (nautical miles)
-     * @param y Y coordinate (nautical miles)
-     * @return Bearing in degrees (0-360°)
+     * @brief Sets up and shows the timeline slider for a replay
+     * @param start_sec Time of the first tick
+     * @param end_sec Time of the last tick
+     * @param step_sec Recorded step
      */
-    double calculateBearing(double x, double y) const;
+    void onReplayOpened(double start_sec, double end_sec, double step_sec);
 
-    // ===== MEMBER VARIABLES =====
+    /**
+     * @brief Seeks to the tick selected on the timeline slider
+     * @param value Slider position (ticks from the start)
+     */
+    void onTimelineMoved(int value);
+
+protected:
+    /**
+     * @brief Qt paint event handler - renders the tactical display
+     * @param event Paint event information
+     */
+    void paintEvent(QPaintEvent *event) override;
+
+    /**
+     * @brief Qt resize event handler - invalidates the cached static layer
+     * @param event Resize event information
+     */
+    void resizeEvent(QResizeEvent *event) override;
+
+    /**
+     * @brief Qt mouse press handler - shows the contact under the cursor
+     * @param event Mouse event information
+     */
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    // ===== SIMULATION THREAD =====
     
-    QTimer *timer;                    ///< Timer for simulation updates
-    double current_time_sec;          ///< Current simulation time in seconds
-    double prev_bearing;              ///< Previous bearing for rate calculation
-    double current_bearing;           ///< Current target bearing in degrees
-    double current_range;             ///< Current target range in nautical miles
-    double current_bearing_rate;      ///< Current bearing rate in degrees/second
-
-    // ===== OWN-SHIP FIXED PARAMETERS =====
-    const double C_own = 0.0;         ///< Own ship course over ground (degrees)
-    const double S_own = 10.0;        ///< Own ship speed over ground (knots)
-    const double depth_own = 40.0;    ///< Own ship depth (meters)
-
-    // ===== TARGET SIMULATION PARAMETERS =====
-    double target_course;             ///< Target's course over ground (degrees)
-    double target_speed;              ///< Target's speed over ground (knots)
-    double target_x;                  ///< Target X position (nautical miles)
-    double target_y;                  ///< Target Y position (nautical miles)
-
-    // ===== DISPLAY GEOMETRY =====
-    QPointF sensor_line_start;        ///< Start point of sensor beam line
-    QPointF sensor_line_end;          ///< End point of sensor beam line
+    SimHost *sim;                     ///< Simulation thread and snapshot handoff (child object)
+
+    // ===== RENDERING =====
+    
+    TSARenderer renderer;             ///< Draws snapshots, owns the static layer cache
+
+    // ===== REPLAY TIMELINE =====
+
+    QSlider *timeline;                ///< Scrub slider, shown in replay mode (one step per tick)
+    double replay_start_sec;          ///< Time at slider position 0
+    double replay_step_sec;           ///< Time per slider position
 };
 
 #endif // TSAWIDGET_H 
\ No newline at end of file
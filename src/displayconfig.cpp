@@ -0,0 +1,168 @@
+#include "displayconfig.h"
+#include "simscheduler.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QJsonValue>
+
+/**
+ * @brief Changes needed to go from a previous configuration to this one
+ *
+ * Beam fractions and the outline gap move the static layer; hatch line
+ * parameters also need a new tile, while switching the fill method only
+ * repaints the static layer. Vector scales are laid out every frame, so
+ * they invalidate nothing here (the static layer cache is keyed on the
+ * own ship vector and follows its length by itself).
+ *
+ * @param previous Configuration currently applied
+ * @return OR of Change bits, 0 if nothing differs
+ */
+unsigned DisplayConfig::changesFrom(const DisplayConfig &previous) const
+{
+    unsigned changes = 0;
+    if (ship_fraction != previous.ship_fraction || sensor_fraction != previous.sensor_fraction
+            || outline_gap != previous.outline_gap)
+        changes |= StaticLayer | DynamicLayer;
+    if (hatch.spacing != previous.hatch.spacing || hatch.angle_deg != previous.hatch.angle_deg
+            || hatch.line_width != previous.hatch.line_width || hatch.color != previous.hatch.color)
+        changes |= HatchTile | StaticLayer;
+    if (hatch.fill != previous.hatch.fill)
+        changes |= StaticLayer;
+    if (own_vector_px_per_knot != previous.own_vector_px_per_knot
+            || target_vector_px != previous.target_vector_px
+            || contact_px_per_nm != previous.contact_px_per_nm
+            || leader_px_per_knot != previous.leader_px_per_knot)
+        changes |= DynamicLayer;
+    if (step_sec != previous.step_sec)
+        changes |= SimStep;
+    return changes;
+}
+
+/**
+ * @brief Checks the values are in range
+ * @param error Set to a message naming the first bad member
+ * @return true if the configuration can be applied
+ */
+bool DisplayConfig::validate(QString *error) const
+{
+    const char *bad = nullptr;
+    if (!(ship_fraction >= 0.0 && ship_fraction <= 1.0))
+        bad = "ship_fraction must be between 0 and 1";
+    else if (!(sensor_fraction >= 0.0 && sensor_fraction <= 1.0))
+        bad = "sensor_fraction must be between 0 and 1";
+    else if (!(outline_gap >= 0.0))
+        bad = "outline_gap must not be negative";
+    else if (!(own_vector_px_per_knot >= 0.0) || !(target_vector_px >= 0.0)
+             || !(contact_px_per_nm >= 0.0) || !(leader_px_per_knot >= 0.0))
+        bad = "vector scales must not be negative";
+    else if (!(hatch.spacing >= 1.0 && hatch.spacing <= HatchStyle::kMaxSpacing))
+        bad = "hatch_spacing must be between 1 and 64 pixels";
+    else if (!(hatch.line_width > 0.0))
+        bad = "hatch_width must be positive";
+    else if (!(step_sec >= SimScheduler::kMinStepSec))
+        bad = "step_ms must be at least 10";
+    else if (!qIsFinite(hatch.angle_deg))
+        bad = "hatch_angle must be a number";
+
+    if (bad && error)
+        *error = QString::fromLatin1(bad);
+    return !bad;
+}
+
+/**
+ * @brief Loads a configuration file over a base configuration
+ *
+ * The file is a few hundred bytes, so it is parsed with QJsonDocument;
+ * unknown members are rejected so a misspelt key does not go unnoticed.
+ *
+ * @param path JSON configuration file
+ * @param config Base configuration, receives the result
+ * @param error Set to a message on failure
+ * @return true on success
+ */
+bool DisplayConfig::load(const QString &path, DisplayConfig &config, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = QString("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        if (error)
+            *error = parseError.error != QJsonParseError::NoError
+                     ? QString("%1: offset %2: %3").arg(path).arg(parseError.offset)
+                                                  .arg(parseError.errorString())
+                     : QString("%1: expected an object").arg(path);
+        return false;
+    }
+
+    // Numeric members, in file units
+    struct NumberMember
+    {
+        const char *key;
+        qreal *value;
+        qreal scale;                  ///< File unit to member unit
+    };
+    DisplayConfig result = config;
+    const NumberMember numbers[] = {
+        { "ship_fraction",          &result.ship_fraction,          1.0 },
+        { "sensor_fraction",        &result.sensor_fraction,        1.0 },
+        { "outline_gap",            &result.outline_gap,            1.0 },
+        { "own_vector_px_per_knot", &result.own_vector_px_per_knot, 1.0 },
+        { "target_vector_px",       &result.target_vector_px,       1.0 },
+        { "contact_px_per_nm",      &result.contact_px_per_nm,      1.0 },
+        { "leader_px_per_knot",     &result.leader_px_per_knot,     1.0 },
+        { "hatch_spacing",          &result.hatch.spacing,          1.0 },
+        { "hatch_angle",            &result.hatch.angle_deg,        1.0 },
+        { "hatch_width",            &result.hatch.line_width,       1.0 },
+        { "step_ms",                &result.step_sec,               0.001 },
+    };
+
+    const QJsonObject root = document.object();
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+        const QString key = it.key();
+        const QJsonValue value = it.value();
+        QString bad;
+
+        if (key == QLatin1String("hatch_fill")) {
+            if (value.toString() == QLatin1String("tile"))
+                result.hatch.fill = HatchStyle::Fill::Tile;
+            else if (value.toString() == QLatin1String("pattern"))
+                result.hatch.fill = HatchStyle::Fill::Pattern;
+            else
+                bad = "expected \"tile\" or \"pattern\"";
+        } else {
+            const NumberMember *member = nullptr;
+            for (const NumberMember &m : numbers) {
+                if (key == QLatin1String(m.key))
+                    member = &m;
+            }
+            if (!member)
+                bad = "unknown member";
+            else if (!value.isDouble())
+                bad = "expected a number";
+            else
+                *member->value = value.toDouble() * member->scale;
+        }
+
+        if (!bad.isEmpty()) {
+            if (error)
+                *error = QString("%1: \"%2\": %3").arg(path, key, bad);
+            return false;
+        }
+    }
+
+    QString invalid;
+    if (!result.validate(&invalid)) {
+        if (error)
+            *error = QString("%1: %2").arg(path, invalid);
+        return false;
+    }
+    config = result;
+    return true;
+}
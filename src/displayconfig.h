@@ -0,0 +1,86 @@
+#ifndef DISPLAYCONFIG_H
+#define DISPLAYCONFIG_H
+
+#include <QString>
+#include <QtGlobal>
+#include "hatchtile.h"
+
+/**
+ * @brief DisplayConfig - Tunable display and simulation parameters
+ *
+ * Loaded at startup and reloaded while running (see ConfigWatcher).
+ * changesFrom() tells which caches a new configuration invalidates, so a
+ * reload only rebuilds what depends on the parameters that changed.
+ *
+ * File format (JSON, all members optional, missing ones keep the values
+ * the configuration was loaded over):
+ * @code
+ * {
+ *   "ship_fraction": 0.75,       "sensor_fraction": 0.45,
+ *   "outline_gap": 15,
+ *   "own_vector_px_per_knot": 6, "target_vector_px": 80,
+ *   "contact_px_per_nm": 40,     "leader_px_per_knot": 3,
+ *   "hatch_fill": "tile",        "hatch_spacing": 5.66,
+ *   "hatch_angle": 45,           "hatch_width": 1,
+ *   "step_ms": 2000
+ * }
+ * @endcode
+ */
+struct DisplayConfig
+{
+    /**
+     * @brief What a configuration change invalidates
+     */
+    enum Change : unsigned {
+        StaticLayer  = 1u << 0,       ///< Beam, outline and hatch: static layer cache
+        HatchTile    = 1u << 1,       ///< Hatch line spacing, angle, width or colour: the tile
+        DynamicLayer = 1u << 2,       ///< Vector and contact scales: the next layout only
+        SimStep      = 1u << 3        ///< Simulation step of the worker thread
+    };
+
+    // ===== BEAM GEOMETRY =====
+    qreal ship_fraction = 0.75;       ///< Own ship position along the sensor line (0..1)
+    qreal sensor_fraction = 0.45;     ///< Sensor marker position along the sensor line (0..1)
+    qreal outline_gap = 15.0;         ///< Distance from the beam to the white outline (px)
+
+    // ===== VECTORS =====
+    qreal own_vector_px_per_knot = 6.0;  ///< Own ship vector length per knot
+    qreal target_vector_px = 80.0;       ///< Target vector length
+    qreal contact_px_per_nm = 40.0;      ///< Contact placement scale around own ship
+    qreal leader_px_per_knot = 3.0;      ///< Contact velocity leader length per knot
+
+    // ===== HATCH =====
+    HatchStyle hatch;                 ///< Hatch of the shaded half-space
+
+    // ===== SIMULATION =====
+    double step_sec = 2.0;            ///< Fixed simulation step (seconds)
+
+    /**
+     * @brief Changes needed to go from a previous configuration to this one
+     * @param previous Configuration currently applied
+     * @return OR of Change bits, 0 if nothing differs
+     */
+    unsigned changesFrom(const DisplayConfig &previous) const;
+
+    /**
+     * @brief Checks the values are in range
+     * @param error Set to a message naming the first bad member
+     * @return true if the configuration can be applied
+     */
+    bool validate(QString *error = nullptr) const;
+
+    /**
+     * @brief Loads a configuration file over a base configuration
+     *
+     * Members missing from the file keep their value in @p config; it is
+     * only modified if the whole file parses and validates.
+     *
+     * @param path JSON configuration file
+     * @param config Base configuration, receives the result
+     * @param error Set to a message on failure
+     * @return true on success
+     */
+    static bool load(const QString &path, DisplayConfig &config, QString *error = nullptr);
+};
+
+#endif // DISPLAYCONFIG_H
@@ -0,0 +1,224 @@
+#include "ekftracker.h"
+#include "bearingkernel.h"
+#include <QtMath>
+#include <cmath>
+
+// Upper-triangle slots of the symmetric 4x4 covariance
+enum { P00, P01, P02, P03, P11, P12, P13, P22, P23, P33 };
+
+/**
+ * @brief Constructor - 0.5 degree bearings, 5 nm range prior
+ */
+EkfTracker::EkfTracker()
+    : bearing_sigma_deg(0.5),
+      process_noise(4.0),
+      init_range(5.0),
+      init_range_sigma(4.0),
+      init_speed_sigma(10.0),
+      time_hours(-1.0)
+{
+}
+
+/**
+ * @brief Sets the range prior of new tracks
+ * @param range_nm Range a new track is placed at (nm)
+ * @param sigma_nm Its uncertainty (nm, 1 sigma)
+ */
+void EkfTracker::setInitRange(double range_nm, double sigma_nm)
+{
+    init_range = range_nm;
+    init_range_sigma = sigma_nm;
+}
+
+/**
+ * @brief Sets the number of tracks; every track starts uninitialized
+ * @param count Number of tracks
+ */
+void EkfTracker::resize(int count)
+{
+    started.fill(0, count);
+    state_x.fill(0.0, count);
+    state_y.fill(0.0, count);
+    state_vx.fill(0.0, count);
+    state_vy.fill(0.0, count);
+    for (QVector<double> &p : cov)
+        p.fill(0.0, count);
+    rel_x.resize(count);
+    rel_y.resize(count);
+    predicted.fill(0.0, count);
+    range.resize(count);
+    rate.resize(count);
+}
+
+/**
+ * @brief Drops one track's estimate
+ * @param track Track index
+ */
+void EkfTracker::reset(int track)
+{
+    started[track] = 0;
+}
+
+/**
+ * @brief Advances every track to a time (constant velocity, white-noise acceleration)
+ *
+ * With d = dt (hours) and q the acceleration spectral density:
+ * F = [I dI; 0 I], Q = q [d^3/3 I, d^2/2 I; d^2/2 I, d I]. Uninitialized
+ * tracks are advanced too; initialize() overwrites them.
+ *
+ * @param time_sec Time to predict to (seconds)
+ */
+void EkfTracker::predict(double time_sec)
+{
+    const double t = time_sec / 3600.0;
+    const double d = time_hours < 0.0 ? 0.0 : t - time_hours;
+    time_hours = t;
+    if (d <= 0.0)
+        return;
+
+    const double q = process_noise;
+    const double q_pp = q * d * d * d / 3.0, q_pv = q * d * d / 2.0, q_vv = q * d;
+    const int n = size();
+    double *x = state_x.data(), *y = state_y.data();
+    const double *vx = state_vx.constData(), *vy = state_vy.constData();
+    double *p00 = cov[P00].data(), *p01 = cov[P01].data(), *p02 = cov[P02].data();
+    double *p03 = cov[P03].data(), *p11 = cov[P11].data(), *p12 = cov[P12].data();
+    double *p13 = cov[P13].data(), *p22 = cov[P22].data(), *p23 = cov[P23].data();
+    double *p33 = cov[P33].data();
+
+    for (int i = 0; i < n; ++i) {
+        x[i] += d * vx[i];
+        y[i] += d * vy[i];
+
+        // F P F^T, then + Q
+        p00[i] += d * (2.0 * p02[i] + d * p22[i]) + q_pp;
+        p01[i] += d * (p03[i] + p12[i] + d * p23[i]);
+        p02[i] += d * p22[i] + q_pv;
+        p03[i] += d * p23[i];
+        p11[i] += d * (2.0 * p13[i] + d * p33[i]) + q_pp;
+        p12[i] += d * p23[i];
+        p13[i] += d * p33[i] + q_pv;
+        p22[i] += q_vv;
+        p33[i] += q_vv;
+    }
+}
+
+/**
+ * @brief Updates every track with a bearing taken at the predicted time
+ *
+ * H = [dy/r^2, -dx/r^2, 0, 0] (radians per nm); with u = P H^T and
+ * S = H u + R the gain is u / S, the state moves by u nu / S and the
+ * covariance loses u u^T / S. A track without a bearing (or not started
+ * yet) gets weight 0, which leaves it unchanged.
+ *
+ * @param own_x Own ship X position (nm)
+ * @param own_y Own ship Y position (nm)
+ * @param bearing_deg Measured bearing per track (degrees), count elements
+ * @param valid 1 where a bearing was measured, nullptr if all were
+ * @param count Number of tracks
+ */
+void EkfTracker::update(double own_x, double own_y, const double *bearing_deg,
+                        const quint8 *valid, int count)
+{
+    if (count != size())
+        resize(count);
+    const int n = count;
+    double *x = state_x.data(), *y = state_y.data();
+    double *vx = state_vx.data(), *vy = state_vy.data();
+    double *rx = rel_x.data(), *ry = rel_y.data();
+
+    // Predicted bearings through the SIMD kernel
+    for (int i = 0; i < n; ++i) {
+        rx[i] = x[i] - own_x;
+        ry[i] = y[i] - own_y;
+    }
+    computeBearingRangeBatch(rx, ry, 0.0, predicted.data(), range.data(), rate.data(), n);
+
+    const double kDegToRad = M_PI / 180.0;
+    const double r_meas = qDegreesToRadians(bearing_sigma_deg) * qDegreesToRadians(bearing_sigma_deg);
+    const quint8 *on = started.constData();
+    const double *zhat = predicted.constData();
+    double *p00 = cov[P00].data(), *p01 = cov[P01].data(), *p02 = cov[P02].data();
+    double *p03 = cov[P03].data(), *p11 = cov[P11].data(), *p12 = cov[P12].data();
+    double *p13 = cov[P13].data(), *p22 = cov[P22].data(), *p23 = cov[P23].data();
+    double *p33 = cov[P33].data();
+
+    for (int i = 0; i < n; ++i) {
+        const double weight = double(on[i] & (valid ? valid[i] : quint8(1)));
+
+        const double r2 = qMax(rx[i] * rx[i] + ry[i] * ry[i], 1e-6);
+        const double h0 = ry[i] / r2, h1 = -rx[i] / r2;
+
+        // Innovation folded into +-180 degrees
+        double nu = bearing_deg[i] - zhat[i];
+        nu -= 360.0 * std::floor((nu + 180.0) / 360.0);
+        nu *= kDegToRad;
+
+        const double u0 = p00[i] * h0 + p01[i] * h1;
+        const double u1 = p01[i] * h0 + p11[i] * h1;
+        const double u2 = p02[i] * h0 + p12[i] * h1;
+        const double u3 = p03[i] * h0 + p13[i] * h1;
+        const double s = h0 * u0 + h1 * u1 + r_meas;
+        const double g = weight / s;
+
+        x[i]  += g * u0 * nu;
+        y[i]  += g * u1 * nu;
+        vx[i] += g * u2 * nu;
+        vy[i] += g * u3 * nu;
+
+        p00[i] -= g * u0 * u0;
+        p01[i] -= g * u0 * u1;
+        p02[i] -= g * u0 * u2;
+        p03[i] -= g * u0 * u3;
+        p11[i] -= g * u1 * u1;
+        p12[i] -= g * u1 * u2;
+        p13[i] -= g * u1 * u3;
+        p22[i] -= g * u2 * u2;
+        p23[i] -= g * u2 * u3;
+        p33[i] -= g * u3 * u3;
+    }
+
+    // New tracks (rare): start them at this bearing
+    for (int i = 0; i < n; ++i) {
+        if (!on[i] && (!valid || valid[i]))
+            initialize(i, own_x, own_y, bearing_deg[i]);
+    }
+}
+
+/**
+ * @brief Starts a track at a bearing with the range and velocity priors
+ *
+ * Position covariance is init_range_sigma^2 along the bearing and
+ * (init_range * bearing sigma)^2 across it.
+ */
+void EkfTracker::initialize(int track, double own_x, double own_y, double bearing_deg)
+{
+    const int i = track;
+    const double b = qDegreesToRadians(bearing_deg);
+    const double s = std::sin(b), c = std::cos(b);
+    state_x[i] = own_x + init_range * s;
+    state_y[i] = own_y + init_range * c;
+    state_vx[i] = 0.0;
+    state_vy[i] = 0.0;
+
+    const double along = init_range_sigma * init_range_sigma;
+    const double cross_sigma = init_range * qDegreesToRadians(bearing_sigma_deg);
+    const double across = cross_sigma * cross_sigma;
+    const double speed_var = init_speed_sigma * init_speed_sigma;
+    cov[P00][i] = along * s * s + across * c * c;
+    cov[P01][i] = (along - across) * s * c;
+    cov[P11][i] = along * c * c + across * s * s;
+    cov[P02][i] = cov[P03][i] = cov[P12][i] = cov[P13][i] = cov[P23][i] = 0.0;
+    cov[P22][i] = cov[P33][i] = speed_var;
+    started[i] = 1;
+}
+
+/**
+ * @brief Square root of the position covariance trace
+ * @param i Track index
+ * @return Position uncertainty (nm)
+ */
+double EkfTracker::positionSigma(int i) const
+{
+    return std::sqrt(qMax(0.0, cov[P00][i] + cov[P11][i]));
+}
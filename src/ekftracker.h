@@ -0,0 +1,134 @@
+#ifndef EKFTRACKER_H
+#define EKFTRACKER_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief EkfTracker - Bearings-only extended Kalman filter for many tracks
+ *
+ * One constant-velocity filter per track, state (x, y, vx, vy) in
+ * nautical miles and knots, driven by bearings from own ship. A track
+ * starts at its first bearing, placed at the range prior (setInitRange())
+ * along it with a wide range and velocity uncertainty.
+ *
+ * State and covariance are stored per element (structure of arrays,
+ * 4 + 10 doubles per track) and predict() and update() are written as
+ * straight loops over all tracks with closed-form 4x4 algebra and no
+ * branches in the body, so the compiler can vectorize them. Predicted
+ * bearings come from the SIMD bearing kernel (bearingkernel.h).
+ *
+ * Conventions as TrackStore: X east and Y north, bearings in degrees
+ * clockwise from North, speeds in knots.
+ */
+class EkfTracker
+{
+public:
+    /**
+     * @brief Constructs a tracker for no tracks with default noise settings
+     */
+    EkfTracker();
+
+    /**
+     * @brief Sets the number of tracks; every track starts uninitialized
+     * @param count Number of tracks
+     */
+    void resize(int count);
+
+    /**
+     * @brief Drops one track's estimate; its next bearing starts it again
+     * @param track Track index
+     */
+    void reset(int track);
+
+    // ===== NOISE AND INITIALIZATION =====
+
+    void setBearingSigma(double sigma_deg) { bearing_sigma_deg = sigma_deg; }     ///< Bearing noise (degrees, 1 sigma)
+    void setProcessNoise(double q) { process_noise = q; }                         ///< Acceleration spectral density (kn^2/hour)
+    void setInitRange(double range_nm, double sigma_nm);                           ///< Range prior of a new track (nm)
+    void setInitSpeedSigma(double sigma_kn) { init_speed_sigma = sigma_kn; }      ///< Velocity prior of a new track (kn, per axis)
+
+    double bearingSigma() const { return bearing_sigma_deg; }
+    double processNoise() const { return process_noise; }
+
+    /**
+     * @brief Advances every track to a time
+     *
+     * x' = F x, P' = F P F^T + Q for a constant-velocity model with
+     * white-noise acceleration. Time must not go backwards.
+     *
+     * @param time_sec Time to predict to (seconds)
+     */
+    void predict(double time_sec);
+
+    /**
+     * @brief Updates every track with a bearing taken at the predicted time
+     *
+     * Tracks without a bearing this time are skipped by a zero weight
+     * rather than a branch. Uninitialized tracks with a bearing are
+     * started from it. Resizes (and clears) the tracker if the track
+     * count changed.
+     *
+     * @param own_x Own ship X position (nm)
+     * @param own_y Own ship Y position (nm)
+     * @param bearing_deg Measured bearing per track (degrees), count elements;
+     *        entries without a measurement must still be finite
+     * @param valid 1 where a bearing was measured, nullptr if all were
+     * @param count Number of tracks
+     */
+    void update(double own_x, double own_y, const double *bearing_deg,
+                const quint8 *valid, int count);
+
+    /**
+     * @brief Number of tracks
+     */
+    int size() const { return state_x.size(); }
+
+    // ===== ESTIMATES =====
+
+    bool initialized(int i) const  { return started[i] != 0; } ///< Track has an estimate
+    double positionX(int i) const  { return state_x[i]; }      ///< Estimated X (nm)
+    double positionY(int i) const  { return state_y[i]; }      ///< Estimated Y (nm)
+    double velocityX(int i) const  { return state_vx[i]; }     ///< Estimated eastward velocity (kn)
+    double velocityY(int i) const  { return state_vy[i]; }     ///< Estimated northward velocity (kn)
+    double positionSigma(int i) const;                         ///< sqrt of the position covariance trace (nm)
+
+    // ===== BULK ARRAY ACCESS (size() elements each) =====
+
+    const quint8 *initializedData() const { return started.constData(); }
+    const double *positionXData() const   { return state_x.constData(); }
+    const double *positionYData() const   { return state_y.constData(); }
+    const double *velocityXData() const   { return state_vx.constData(); }
+    const double *velocityYData() const   { return state_vy.constData(); }
+
+private:
+    /**
+     * @brief Starts a track at a bearing with the range and velocity priors
+     */
+    void initialize(int track, double own_x, double own_y, double bearing_deg);
+
+    // ===== SETTINGS =====
+    double bearing_sigma_deg;         ///< Measurement noise (degrees)
+    double process_noise;             ///< Acceleration spectral density (kn^2/hour)
+    double init_range;                ///< Range a new track is placed at (nm)
+    double init_range_sigma;          ///< Range uncertainty of a new track (nm)
+    double init_speed_sigma;          ///< Velocity uncertainty of a new track (kn)
+    double time_hours;                ///< Time of the current estimates (hours), < 0 before the first predict
+
+    // ===== STATE (PER TRACK) =====
+    QVector<quint8> started;          ///< 1 once the first bearing arrived
+    QVector<double> state_x;          ///< X (nm)
+    QVector<double> state_y;          ///< Y (nm)
+    QVector<double> state_vx;         ///< Eastward velocity (kn)
+    QVector<double> state_vy;         ///< Northward velocity (kn)
+    QVector<double> cov[10];          ///< Upper triangle of P: 00 01 02 03 11 12 13 22 23 33
+
+    // ===== SCRATCH (reused every update) =====
+    QVector<double> rel_x;            ///< Predicted X relative to own ship
+    QVector<double> rel_y;            ///< Predicted Y relative to own ship
+    QVector<double> predicted;        ///< Predicted bearing (degrees)
+    QVector<double> range;            ///< Predicted range (nm)
+    QVector<double> rate;             ///< Unused kernel output
+};
+
+#endif // EKFTRACKER_H
@@ -0,0 +1,352 @@
+#include "eventlog.h"
+#include <QDebug>
+#include <QtNumeric>
+#include <QStringList>
+#include <chrono>
+#include <cstdio>
+
+std::atomic<int> EventLog::min_level[static_cast<int>(LogCategory::Count)];
+std::atomic<quint32> EventLog::sample_every[static_cast<int>(LogCategory::Count)];
+std::atomic<quint32> EventLog::sample_counter[static_cast<int>(LogCategory::Count)];
+
+static const int kCategoryCount = static_cast<int>(LogCategory::Count);
+
+/**
+ * @brief Monotonic clock in nanoseconds
+ */
+static qint64 monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ===== EventLog =====
+
+/**
+ * @brief Constructor - every category at Debug, no sampling
+ *
+ * Debug keeps the per-tick simulation line on by default, as the
+ * synchronous qDebug() output it replaces was.
+ */
+EventLog::EventLog()
+    : dropped(0),
+      epoch_ns(monotonicNs())
+{
+    for (int c = 0; c < kCategoryCount; ++c) {
+        min_level[c].store(static_cast<int>(LogLevel::Debug), std::memory_order_relaxed);
+        sample_every[c].store(1, std::memory_order_relaxed);
+        sample_counter[c].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Global instance
+ */
+EventLog &EventLog::instance()
+{
+    static EventLog log;
+    return log;
+}
+
+/**
+ * @brief Records an event; never blocks, drops it if the ring is full
+ * @param category Event category
+ * @param level Severity
+ * @param format Static event description
+ * @param values Field values (at most format.field_count are kept)
+ */
+void EventLog::log(LogCategory category, LogLevel level, const LogEventFormat &format,
+                   std::initializer_list<double> values)
+{
+    LogEvent event;
+    event.time_ns = elapsedNs();
+    event.format = &format;
+    event.category = category;
+    event.level = level;
+    int i = 0;
+    for (double v : values) {
+        if (i == format.field_count)
+            break;
+        event.values[i++] = v;
+    }
+    for (; i < format.field_count; ++i)
+        event.values[i] = 0.0;
+
+    if (!ring.push(event))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Monotonic time since the log started, as stamped on events
+ */
+quint64 EventLog::elapsedNs() const
+{
+    return quint64(monotonicNs() - epoch_ns);
+}
+
+void EventLog::setLevel(LogCategory category, LogLevel level)
+{
+    instance();     // make sure the defaults are in place first
+    min_level[static_cast<int>(category)].store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel EventLog::level(LogCategory category)
+{
+    instance();
+    return static_cast<LogLevel>(min_level[static_cast<int>(category)].load(std::memory_order_relaxed));
+}
+
+void EventLog::setSampling(LogCategory category, quint32 every)
+{
+    instance();
+    sample_every[static_cast<int>(category)].store(qMax<quint32>(every, 1), std::memory_order_relaxed);
+}
+
+const char *EventLog::categoryName(LogCategory category)
+{
+    switch (category) {
+    case LogCategory::Sim:       return "sim";
+    case LogCategory::Replay:    return "replay";
+    case LogCategory::Recording: return "recording";
+    case LogCategory::Config:    return "config";
+    case LogCategory::Log:       return "log";
+    case LogCategory::Count:     break;
+    }
+    return "?";
+}
+
+const char *EventLog::levelName(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Debug:   return "debug";
+    case LogLevel::Info:    return "info";
+    case LogLevel::Warning: return "warning";
+    case LogLevel::Error:   return "error";
+    case LogLevel::Off:     return "off";
+    }
+    return "?";
+}
+
+/**
+ * @brief Splits a "value" or "cat=value,cat=value" spec
+ *
+ * Calls apply(category, value) for every category named, or for all
+ * categories when the spec has no "=".
+ */
+template <typename Apply>
+static bool applySpec(const QString &spec, QString *error, Apply apply)
+{
+    const QStringList items = spec.split(',', Qt::SkipEmptyParts);
+    for (const QString &item : items) {
+        const int eq = item.indexOf('=');
+        if (eq < 0) {
+            for (int c = 0; c < kCategoryCount; ++c) {
+                if (!apply(static_cast<LogCategory>(c), item.trimmed(), error))
+                    return false;
+            }
+            continue;
+        }
+        const QString name = item.left(eq).trimmed();
+        int c = 0;
+        while (c < kCategoryCount
+               && name != QLatin1String(EventLog::categoryName(static_cast<LogCategory>(c))))
+            ++c;
+        if (c == kCategoryCount) {
+            if (error)
+                *error = QString("unknown log category \"%1\"").arg(name);
+            return false;
+        }
+        if (!apply(static_cast<LogCategory>(c), item.mid(eq + 1).trimmed(), error))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Applies a level spec: "debug" or "sim=debug,recording=warning"
+ * @param error Set to a message on failure
+ */
+bool EventLog::configureLevels(const QString &spec, QString *error)
+{
+    return applySpec(spec, error, [](LogCategory category, const QString &value, QString *error) {
+        for (int l = 0; l <= static_cast<int>(LogLevel::Off); ++l) {
+            if (value == QLatin1String(levelName(static_cast<LogLevel>(l)))) {
+                setLevel(category, static_cast<LogLevel>(l));
+                return true;
+            }
+        }
+        if (error)
+            *error = QString("unknown log level \"%1\"").arg(value);
+        return false;
+    });
+}
+
+/**
+ * @brief Applies a sampling spec: "10" or "sim=10,replay=2"
+ * @param error Set to a message on failure
+ */
+bool EventLog::configureSampling(const QString &spec, QString *error)
+{
+    return applySpec(spec, error, [](LogCategory category, const QString &value, QString *error) {
+        bool ok = false;
+        const uint every = value.toUInt(&ok);
+        if (!ok || every == 0) {
+            if (error)
+                *error = QString("invalid sampling \"%1\"").arg(value);
+            return false;
+        }
+        setSampling(category, every);
+        return true;
+    });
+}
+
+// ===== EventLogWriter =====
+
+/**
+ * @brief Constructor - no output yet
+ * @param parent Parent object
+ */
+EventLogWriter::EventLogWriter(QObject *parent)
+    : QThread(parent),
+      format(Format::Text),
+      stopping(false)
+{
+    setObjectName("TSA event log");
+}
+
+/**
+ * @brief Destructor - stops the thread after writing the remaining events
+ */
+EventLogWriter::~EventLogWriter()
+{
+    stop();
+}
+
+/**
+ * @brief Opens the output and starts the thread
+ * @param path Output file (appended), "-" for stderr
+ * @param format Line format
+ * @return false if the output cannot be opened
+ */
+bool EventLogWriter::open(const QString &path, Format format)
+{
+    const bool opened = (path == "-")
+        ? out.open(stderr, QIODevice::WriteOnly)
+        : (out.setFileName(path), out.open(QIODevice::WriteOnly | QIODevice::Append));
+    if (!opened) {
+        qWarning() << "Cannot open event log" << path << out.errorString();
+        return false;
+    }
+
+    this->format = format;
+    batch.reserve(64 * 1024);
+    stopping.store(false, std::memory_order_relaxed);
+    start(QThread::LowPriority);
+    return true;
+}
+
+/**
+ * @brief Writes the remaining events and stops the thread
+ */
+void EventLogWriter::stop()
+{
+    if (!isRunning())
+        return;
+    stopping.store(true, std::memory_order_relaxed);
+    wait();
+}
+
+/**
+ * @brief Writer thread: drains, formats and writes events
+ */
+void EventLogWriter::run()
+{
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (drain() == 0)
+            msleep(kPollIntervalMs);
+    }
+    drain();
+    out.flush();
+}
+
+/**
+ * @brief Drains the ring into the output
+ *
+ * Formats everything pending into one batch and writes it with a single
+ * call; a dropped-event count is reported after the batch.
+ *
+ * @return Number of events written
+ */
+int EventLogWriter::drain()
+{
+    EventLog &log = EventLog::instance();
+    LogEvent event;
+    int count = 0;
+    batch.resize(0);
+    while (log.take(event)) {
+        formatEvent(event, batch);
+        ++count;
+    }
+
+    const quint64 dropped = log.takeDropped();
+    if (dropped > 0) {
+        static const LogEventFormat kDroppedEvent = { "log.dropped", 1, { "count" } };
+        LogEvent notice;
+        notice.time_ns = log.elapsedNs();
+        notice.format = &kDroppedEvent;
+        notice.category = LogCategory::Log;
+        notice.level = LogLevel::Warning;
+        notice.values[0] = double(dropped);
+        formatEvent(notice, batch);
+    }
+
+    if (!batch.isEmpty()) {
+        out.write(batch);
+        out.flush();
+    }
+    return count;
+}
+
+/**
+ * @brief Appends one formatted event line to the batch
+ */
+void EventLogWriter::formatEvent(const LogEvent &event, QByteArray &line) const
+{
+    char stamp[32];
+    std::snprintf(stamp, sizeof(stamp), "%.6f", double(event.time_ns) * 1e-9);
+    const LogEventFormat &f = *event.format;
+
+    if (format == Format::Json) {
+        line += "{\"t\":";
+        line += stamp;
+        line += ",\"level\":\"";
+        line += EventLog::levelName(event.level);
+        line += "\",\"cat\":\"";
+        line += EventLog::categoryName(event.category);
+        line += "\",\"event\":\"";
+        line += f.name;
+        line += '"';
+        for (int i = 0; i < f.field_count; ++i) {
+            line += ",\"";
+            line += f.fields[i];
+            line += "\":";
+            line += qIsFinite(event.values[i])
+                    ? QByteArray::number(event.values[i], 'g', 10) : QByteArray("null");
+        }
+        line += "}\n";
+        return;
+    }
+
+    char head[64];
+    std::snprintf(head, sizeof(head), "%12s %-7s %s ", stamp,
+                  EventLog::levelName(event.level), EventLog::categoryName(event.category));
+    line += head;
+    line += f.name;
+    for (int i = 0; i < f.field_count; ++i) {
+        line += ' ';
+        line += f.fields[i];
+        line += '=';
+        line += QByteArray::number(event.values[i], 'g', 10);
+    }
+    line += '\n';
+}
@@ -0,0 +1,244 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QThread>
+#include <QtGlobal>
+#include <atomic>
+#include <initializer_list>
+#include "mpscring.h"
+
+/**
+ * @file eventlog.h
+ * @brief Asynchronous structured event log
+ *
+ * Hot paths record fixed-size binary events (a static format descriptor
+ * plus up to kMaxFields numbers) into a lock-free ring with the
+ * EVENT_LOG() macro; EventLogWriter formats them as text or JSON lines on
+ * a background thread. Each category has its own minimum level and an
+ * optional 1-in-N sampling of its Debug and Info events, so logging can
+ * stay on without touching frame time. A disabled event costs one relaxed
+ * atomic load and its arguments are not evaluated.
+ */
+
+/**
+ * @brief Event categories, each with its own level and sampling
+ */
+enum class LogCategory {
+    Sim,                ///< Simulation stepping
+    Replay,             ///< Recording playback
+    Recording,          ///< Recording writer
+    Config,             ///< Configuration reloads
+    Log,                ///< The event log itself (dropped events)
+    Count
+};
+
+/**
+ * @brief Event severities, in increasing order
+ */
+enum class LogLevel {
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off                 ///< Level setting only: drop every event
+};
+
+/**
+ * @brief Static description of an event: name and field names
+ *
+ * Defined once per event site with static storage; events only carry a
+ * pointer to it.
+ */
+struct LogEventFormat
+{
+    static const int kMaxFields = 6;
+
+    const char *name;                 ///< Event name, e.g. "sim.tick"
+    int field_count;                  ///< Number of values the event carries
+    const char *fields[kMaxFields];   ///< Value names, in order
+};
+
+/**
+ * @brief One recorded event (binary, formatted later)
+ */
+struct LogEvent
+{
+    quint64 time_ns;                  ///< Monotonic time since the log started
+    const LogEventFormat *format;     ///< Event description
+    LogCategory category;             ///< Category it was logged in
+    LogLevel level;                   ///< Severity
+    double values[LogEventFormat::kMaxFields]; ///< Field values
+};
+
+/**
+ * @brief EventLog - Process-wide event ring with per-category filtering
+ */
+class EventLog
+{
+public:
+    static const int kCapacity = 16384;  ///< Events buffered before new ones are dropped
+
+    /**
+     * @brief Global instance
+     */
+    static EventLog &instance();
+
+    /**
+     * @brief Level and sampling check used by EVENT_LOG()
+     *
+     * Warnings and errors pass whenever the level allows them; Debug and
+     * Info events are additionally thinned to 1 in N by the category's
+     * sampling.
+     */
+    static bool shouldLog(LogCategory category, LogLevel level)
+    {
+        const int c = static_cast<int>(category);
+        if (static_cast<int>(level) < min_level[c].load(std::memory_order_relaxed))
+            return false;
+        const quint32 every = sample_every[c].load(std::memory_order_relaxed);
+        return every <= 1 || level >= LogLevel::Warning
+               || sample_counter[c].fetch_add(1, std::memory_order_relaxed) % every == 0;
+    }
+
+    /**
+     * @brief Records an event; never blocks, drops it if the ring is full
+     * @param category Event category
+     * @param level Severity
+     * @param format Static event description
+     * @param values Field values (at most format.field_count are kept)
+     */
+    void log(LogCategory category, LogLevel level, const LogEventFormat &format,
+             std::initializer_list<double> values);
+
+    /**
+     * @brief Takes the oldest event (consumer thread only)
+     * @return false if none is pending
+     */
+    bool take(LogEvent &event) { return ring.pop(event); }
+
+    /**
+     * @brief Number of events dropped since the last call, then resets it
+     */
+    quint64 takeDropped() { return dropped.exchange(0, std::memory_order_relaxed); }
+
+    /**
+     * @brief Monotonic time since the log started, as stamped on events
+     */
+    quint64 elapsedNs() const;
+
+    // ===== CONFIGURATION (ANY THREAD) =====
+
+    static void setLevel(LogCategory category, LogLevel level);
+    static LogLevel level(LogCategory category);
+
+    /**
+     * @brief Keeps 1 in every Debug/Info events of a category (1 = all)
+     */
+    static void setSampling(LogCategory category, quint32 every);
+
+    /**
+     * @brief Applies a level spec: "debug" for every category, or
+     *        "sim=debug,recording=warning"
+     * @param error Set to a message on failure
+     */
+    static bool configureLevels(const QString &spec, QString *error = nullptr);
+
+    /**
+     * @brief Applies a sampling spec: "10" for every category, or "sim=10,replay=2"
+     * @param error Set to a message on failure
+     */
+    static bool configureSampling(const QString &spec, QString *error = nullptr);
+
+    static const char *categoryName(LogCategory category);
+    static const char *levelName(LogLevel level);
+
+private:
+    EventLog();
+
+    MpscRing<LogEvent, kCapacity> ring;   ///< Pending events
+    std::atomic<quint64> dropped;         ///< Events lost to a full ring
+    qint64 epoch_ns;                      ///< steady_clock at construction
+
+    static std::atomic<int> min_level[static_cast<int>(LogCategory::Count)];
+    static std::atomic<quint32> sample_every[static_cast<int>(LogCategory::Count)];
+    static std::atomic<quint32> sample_counter[static_cast<int>(LogCategory::Count)];
+};
+
+/**
+ * @brief Records an event if its category and level are enabled
+ *
+ * The value expressions are only evaluated for events that are kept.
+ */
+#define EVENT_LOG(category, level, format, ...)                                       \
+    do {                                                                              \
+        if (EventLog::shouldLog(category, level))                                     \
+            EventLog::instance().log(category, level, format, { __VA_ARGS__ });       \
+    } while (0)
+
+/**
+ * @brief EventLogWriter - Background thread that formats and writes events
+ *
+ * Drains the EventLog ring, formats each event as a text or JSON line
+ * and writes them in batches; when the ring is empty it sleeps for
+ * kPollIntervalMs. Dropped events are reported as a "log.dropped" line.
+ */
+class EventLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    enum class Format {
+        Text,           ///< "   12.345678 debug   sim sim.tick time=2 tracks=1"
+        Json            ///< {"t":12.345678,"level":"debug","cat":"sim","event":"sim.tick","time":2}
+    };
+
+    static const int kPollIntervalMs = 20;  ///< Sleep when the ring is empty
+
+    explicit EventLogWriter(QObject *parent = nullptr);
+
+    /**
+     * @brief Stops the thread after writing the remaining events
+     */
+    ~EventLogWriter() override;
+
+    /**
+     * @brief Opens the output and starts the thread
+     * @param path Output file (appended), "-" for stderr
+     * @param format Line format
+     * @return false if the output cannot be opened
+     */
+    bool open(const QString &path, Format format);
+
+    /**
+     * @brief Writes the remaining events and stops the thread
+     */
+    void stop();
+
+protected:
+    /**
+     * @brief Writer thread: drains, formats and writes events
+     */
+    void run() override;
+
+private:
+    /**
+     * @brief Drains the ring into the output
+     * @return Number of events written
+     */
+    int drain();
+
+    /**
+     * @brief Appends one formatted event line to the batch
+     */
+    void formatEvent(const LogEvent &event, QByteArray &out) const;
+
+    QFile out;                        ///< Output (file or stderr)
+    Format format;                    ///< Line format
+    QByteArray batch;                 ///< Lines formatted by one drain()
+    std::atomic<bool> stopping;       ///< stop() requested
+};
+
+#endif // EVENTLOG_H
@@ -0,0 +1,223 @@
+#include "geometry.h"
+#include "perfstats.h"
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Returns the two points where line through A→B intersects the widget rectangle
+ *
+ * Liang–Barsky: with P(t) = A + t*(B–A), each edge bounds t from one side.
+ * An edge parallel to the line either contains it (no bound) or rejects
+ * it. The clipped points are clamped onto the rectangle so that rounding
+ * never puts them outside.
+ *
+ * @param A First point of the line
+ * @param B Second point of the line
+ * @param rect Widget rectangle bounds
+ * @return Intersection points spanning the full widget, ordered along A→B
+ */
+ClippedLine computeFullLine(const QPointF &A, const QPointF &B, const QRectF &rect)
+{
+    PERF_SCOPE(PerfSection::FullLine);
+
+    const qreal dx = B.x() - A.x();
+    const qreal dy = B.y() - A.y();
+    ClippedLine out = { A, B, false };
+    if (dx == 0.0 && dy == 0.0)
+        return out;
+
+    const qreal left = rect.left(), right = rect.right();
+    const qreal top = rect.top(), bottom = rect.bottom();
+
+    // Edge constraints p*t <= q for left, right, top, bottom
+    const qreal p[4] = { -dx, dx, -dy, dy };
+    const qreal q[4] = { A.x() - left, right - A.x(), A.y() - top, bottom - A.y() };
+
+    qreal t0 = -std::numeric_limits<qreal>::infinity();
+    qreal t1 = std::numeric_limits<qreal>::infinity();
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0) {
+            if (q[i] < 0.0)
+                return out;               // parallel and outside
+            continue;
+        }
+        const qreal r = q[i] / p[i];
+        if (p[i] < 0.0)
+            t0 = std::max(t0, r);
+        else
+            t1 = std::min(t1, r);
+    }
+    if (t0 > t1)
+        return out;
+
+    auto clamp = [&](qreal t) {
+        return QPointF(qBound(left, A.x() + t * dx, right),
+                       qBound(top, A.y() + t * dy, bottom));
+    };
+    out.p1 = clamp(t0);
+    out.p2 = clamp(t1);
+    out.valid = true;
+    return out;
+}
+
+/**
+ * @brief Clip the half-space on the sideSelected side of line A→B to the rect
+ * @param A First point of the line
+ * @param B Second point of the line
+ * @param bounds Widget rectangle bounds
+ * @param sideSelectedIsLeft Whether the selected side is left of the line
+ * @return Polygon representing the clipped half-space
+ */
+QPolygonF buildHalfSpacePoly(
+    const QPointF &A, const QPointF &B,
+    const QRectF &bounds,
+    bool sideSelectedIsLeft)
+{
+    PERF_SCOPE(PerfSection::HalfSpacePoly);
+
+    // Collect rectangle corners
+    QVector<QPointF> pts = {
+        bounds.topLeft(), bounds.topRight(),
+        bounds.bottomRight(), bounds.bottomLeft()
+    };
+    // Keep corners on selected side
+    QPolygonF poly;
+    for (auto &pt : pts) {
+        bool left = sideOfLine(A, B, pt) > 0;
+        if (left == sideSelectedIsLeft)
+            poly.append(pt);
+    }
+    // Add beam-rect intersections
+    const ClippedLine inte = computeFullLine(A, B, bounds);
+    if (inte.valid) {
+        for (auto &pt : {inte.p1, inte.p2}) {
+            bool left = sideOfLine(A, B, pt) > 0;
+            if (left == sideSelectedIsLeft)
+                poly.append(pt);
+        }
+    }
+    // Return a convex hull to ensure correct winding
+    return buildConvexHull(poly);
+}
+
+// ===== CONVEX HULL =====
+
+/**
+ * @brief Lexicographic point order used by the monotone chain
+ */
+static inline bool lessXY(const QPointF &a, const QPointF &b)
+{
+    return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+}
+
+/**
+ * @brief Sorts [first, last) by lessXY on up to 8 threads
+ *
+ * Each thread sorts one contiguous chunk, then neighbouring chunks are
+ * merged in place pairwise until one run remains.
+ */
+static void parallelSortXY(QPointF *first, QPointF *last)
+{
+    const int count = static_cast<int>(last - first);
+    const int chunks = qBound(1, static_cast<int>(std::thread::hardware_concurrency()), 8);
+    if (chunks == 1) {
+        std::sort(first, last, lessXY);
+        return;
+    }
+
+    std::vector<QPointF *> bounds(chunks + 1);
+    for (int i = 0; i <= chunks; ++i)
+        bounds[i] = first + static_cast<qint64>(count) * i / chunks;
+
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    for (int i = 1; i < chunks; ++i)
+        workers.emplace_back([&bounds, i]() { std::sort(bounds[i], bounds[i + 1], lessXY); });
+    std::sort(bounds[0], bounds[1], lessXY);
+    for (auto &worker : workers)
+        worker.join();
+
+    for (int width = 1; width < chunks; width *= 2) {
+        for (int i = 0; i + width < chunks; i += 2 * width)
+            std::inplace_merge(bounds[i], bounds[i + width],
+                               bounds[std::min(i + 2 * width, chunks)], lessXY);
+    }
+}
+
+/**
+ * @brief Constructor - empty buffers, sequential sort
+ */
+ConvexHullBuilder::ConvexHullBuilder()
+    : parallel_sort(false)
+{
+}
+
+/**
+ * @brief Computes the convex hull of a point set (Andrew's monotone chain)
+ *
+ * O(n log n) for the sort plus O(n) for the two chains. A point is
+ * popped while the last two hull points and the new point do not make a
+ * strict left turn, which removes collinear and duplicate points.
+ *
+ * @param points Input points (not modified)
+ * @param count Number of points
+ * @return Hull vertices; valid until the next build() call
+ */
+const QPolygonF &ConvexHullBuilder::build(const QPointF *points, int count)
+{
+    PERF_SCOPE(PerfSection::ConvexHull);
+
+    sorted.resize(count);
+    QPointF *s = sorted.data();
+    std::copy(points, points + count, s);
+    if (parallel_sort && count >= kParallelSortThreshold)
+        parallelSortXY(s, s + count);
+    else
+        std::sort(s, s + count, lessXY);
+    // Exact duplicates only (QPointF::operator== is fuzzy)
+    const int n = static_cast<int>(std::unique(s, s + count, [](const QPointF &a, const QPointF &b) {
+        return a.x() == b.x() && a.y() == b.y();
+    }) - s);
+
+    if (n < 3) {
+        hull.resize(n);
+        std::copy(s, s + n, hull.data());
+        return hull;
+    }
+
+    hull.resize(2 * n);
+    QPointF *h = hull.data();
+    int k = 0;
+
+    // Lower chain, left to right
+    for (int i = 0; i < n; ++i) {
+        while (k >= 2 && sideOfLine(h[k - 2], h[k - 1], s[i]) <= 0)
+            --k;
+        h[k++] = s[i];
+    }
+
+    // Upper chain, right to left
+    const int lower = k + 1;
+    for (int i = n - 2; i >= 0; --i) {
+        while (k >= lower && sideOfLine(h[k - 2], h[k - 1], s[i]) <= 0)
+            --k;
+        h[k++] = s[i];
+    }
+
+    // The last point repeats the first
+    hull.resize(k - 1);
+    return hull;
+}
+
+/**
+ * @brief Builds a convex hull from a set of points
+ * @param points Input points
+ * @return Convex hull polygon
+ */
+QPolygonF buildConvexHull(const QVector<QPointF> &points)
+{
+    ConvexHullBuilder builder;
+    return builder.build(points);
+}
@@ -0,0 +1,117 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <QPointF>
+#include <QPolygonF>
+#include <QRectF>
+#include <QVector>
+
+/**
+ * @file geometry.h
+ * @brief 2D geometry primitives used to build the tactical display
+ *
+ * Free functions in widget (pixel) coordinates with no widget state, so
+ * they can be shared by the renderers and benchmarked in isolation.
+ */
+
+/**
+ * @brief Helper function to determine which side of a line a point lies on
+ * @param A First point of the line
+ * @param B Second point of the line
+ * @param P Point to test
+ * @return Positive value if P is on "left" side, negative if on "right" side
+ */
+inline qreal sideOfLine(const QPointF &A, const QPointF &B, const QPointF &P)
+{
+    // cross((B–A),(P–A))
+    return (B.x()-A.x())*(P.y()-A.y()) - (B.y()-A.y())*(P.x()-A.x());
+}
+
+/**
+ * @brief Result of clipping an infinite line to a rectangle
+ */
+struct ClippedLine
+{
+    QPointF p1;                       ///< Entry point (first along A→B)
+    QPointF p2;                       ///< Exit point (equal to p1 if the line only touches a corner)
+    bool valid;                       ///< false if the line misses the rectangle or A == B
+};
+
+/**
+ * @brief Returns the two points where line through A→B intersects the widget rectangle
+ *
+ * Liang–Barsky clipping of the infinite line; no heap allocation. Lines
+ * through corners and axis-aligned lines (including lines on an edge)
+ * are exact. If the line misses the rectangle, or A == B, the result is
+ * invalid and holds p1 = A, p2 = B.
+ *
+ * @param A First point of the line
+ * @param B Second point of the line
+ * @param rect Widget rectangle bounds
+ * @return Intersection points spanning the full widget, ordered along A→B
+ */
+ClippedLine computeFullLine(const QPointF &A, const QPointF &B, const QRectF &rect);
+
+/**
+ * @brief Clip the half-space on the sideSelected side of line A→B to the rect
+ * @param A First point of the line
+ * @param B Second point of the line
+ * @param bounds Widget rectangle bounds
+ * @param sideSelectedIsLeft Whether the selected side is left of the line
+ * @return Polygon representing the clipped half-space
+ */
+QPolygonF buildHalfSpacePoly(const QPointF &A, const QPointF &B,
+                             const QRectF &bounds, bool sideSelectedIsLeft);
+
+/**
+ * @brief ConvexHullBuilder - Andrew monotone-chain convex hull with reusable buffers
+ *
+ * Sorts a copy of the input lexicographically (x, then y) and builds the
+ * lower and upper chains with cross-product turns only. Duplicate and
+ * collinear points are dropped, so the result is the minimal set of hull
+ * vertices, counter-clockwise in y-up coordinates (clockwise on screen),
+ * starting at the lowest-x point. Keep one builder per caller to reuse
+ * its buffers across calls; not thread-safe.
+ */
+class ConvexHullBuilder
+{
+public:
+    static const int kParallelSortThreshold = 1 << 16; ///< Minimum size for the parallel sort
+
+    ConvexHullBuilder();
+
+    /**
+     * @brief Sorts large inputs on several threads (default off)
+     * @param enabled true to split inputs of kParallelSortThreshold points or
+     *                more across up to 8 threads
+     */
+    void setParallelSortEnabled(bool enabled) { parallel_sort = enabled; }
+
+    /**
+     * @brief Computes the convex hull of a point set
+     * @param points Input points (not modified)
+     * @param count Number of points
+     * @return Hull vertices; valid until the next build() call
+     */
+    const QPolygonF &build(const QPointF *points, int count);
+    const QPolygonF &build(const QVector<QPointF> &points)
+    { return build(points.constData(), points.size()); }
+
+private:
+    QVector<QPointF> sorted;          ///< Sorted, deduplicated copy of the input
+    QPolygonF hull;                   ///< Output vertices (capacity reused)
+    bool parallel_sort;               ///< Use the multi-threaded sort for large inputs
+};
+
+/**
+ * @brief Builds a convex hull from a set of points
+ *
+ * Convenience wrapper around a temporary ConvexHullBuilder; use a
+ * long-lived builder in hot loops to avoid reallocating its buffers.
+ *
+ * @param points Input points
+ * @return Convex hull polygon
+ */
+QPolygonF buildConvexHull(const QVector<QPointF> &points);
+
+#endif // GEOMETRY_H
@@ -0,0 +1,130 @@
+#include "halfplanekernel.h"
+#include "bearingkernel.h"
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TSA_HALFPLANE_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Line A→B prepared for classification: f(P) = dx (Py - ay) - dy (Px - ax) > threshold
+ */
+struct HalfPlane
+{
+    double ax, ay;                    ///< Line point A
+    double dx, dy;                    ///< B - A
+    double threshold;                 ///< gap * |B - A|
+};
+
+/**
+ * @brief Bit of one point (0 or 1)
+ */
+inline quint64 scalarBit(const HalfPlane &h, double x, double y)
+{
+    const double f = h.dx * (y - h.ay) - h.dy * (x - h.ax);
+    return quint64(f > h.threshold);
+}
+
+/**
+ * @brief Points [first, first + n) into one mask word (n <= 64)
+ */
+quint64 wordScalar(const HalfPlane &h, const double *x, const double *y, int n)
+{
+    quint64 bits = 0;
+    for (int j = 0; j < n; ++j)
+        bits |= scalarBit(h, x[j], y[j]) << j;
+    return bits;
+}
+
+#ifdef TSA_HALFPLANE_KERNEL_X86
+
+quint64 wordSse2(const HalfPlane &h, const double *x, const double *y, int n)
+{
+    const __m128d ax = _mm_set1_pd(h.ax), ay = _mm_set1_pd(h.ay);
+    const __m128d dx = _mm_set1_pd(h.dx), dy = _mm_set1_pd(h.dy);
+    const __m128d threshold = _mm_set1_pd(h.threshold);
+
+    quint64 bits = 0;
+    int j = 0;
+    for (; j + 2 <= n; j += 2) {
+        const __m128d px = _mm_loadu_pd(x + j);
+        const __m128d py = _mm_loadu_pd(y + j);
+        const __m128d f = _mm_sub_pd(_mm_mul_pd(dx, _mm_sub_pd(py, ay)),
+                                     _mm_mul_pd(dy, _mm_sub_pd(px, ax)));
+        bits |= quint64(_mm_movemask_pd(_mm_cmpgt_pd(f, threshold))) << j;
+    }
+    for (; j < n; ++j)
+        bits |= scalarBit(h, x[j], y[j]) << j;
+    return bits;
+}
+
+// AVX2 without FMA on purpose: an unfused multiply-subtract keeps every
+// path's bits identical for points right at the threshold
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+quint64 wordAvx2(const HalfPlane &h, const double *x, const double *y, int n)
+{
+    const __m256d ax = _mm256_set1_pd(h.ax), ay = _mm256_set1_pd(h.ay);
+    const __m256d dx = _mm256_set1_pd(h.dx), dy = _mm256_set1_pd(h.dy);
+    const __m256d threshold = _mm256_set1_pd(h.threshold);
+
+    quint64 bits = 0;
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const __m256d px = _mm256_loadu_pd(x + j);
+        const __m256d py = _mm256_loadu_pd(y + j);
+        const __m256d f = _mm256_sub_pd(_mm256_mul_pd(dx, _mm256_sub_pd(py, ay)),
+                                        _mm256_mul_pd(dy, _mm256_sub_pd(px, ax)));
+        bits |= quint64(_mm256_movemask_pd(_mm256_cmp_pd(f, threshold, _CMP_GT_OQ))) << j;
+    }
+    for (; j < n; ++j)
+        bits |= scalarBit(h, x[j], y[j]) << j;
+    return bits;
+}
+
+#pragma GCC pop_options
+
+#endif // TSA_HALFPLANE_KERNEL_X86
+
+typedef quint64 (*WordFn)(const HalfPlane &, const double *, const double *, int);
+
+WordFn wordFor(BearingKernelIsa isa)
+{
+    switch (isa) {
+#ifdef TSA_HALFPLANE_KERNEL_X86
+    case BearingKernelIsa::AVX2: return wordAvx2;
+    case BearingKernelIsa::SSE2: return wordSse2;
+#endif
+    default:                     return wordScalar;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Classifies a batch of points against the half-plane left of A→B beyond a gap
+ *
+ * Works one 64-point mask word at a time, so every word is written once
+ * and no partial words are read back.
+ */
+void classifyHalfPlaneBatch(const double *x, const double *y, int count,
+                            double ax, double ay, double bx, double by, double gap,
+                            quint64 *mask)
+{
+    HalfPlane h;
+    h.ax = ax;
+    h.ay = ay;
+    h.dx = bx - ax;
+    h.dy = by - ay;
+    h.threshold = gap * std::hypot(h.dx, h.dy);
+
+    const WordFn word = wordFor(bearingKernelIsa());
+    for (int base = 0, w = 0; base < count; base += 64, ++w) {
+        const int n = count - base < 64 ? count - base : 64;
+        mask[w] = word(h, x + base, y + base, n);
+    }
+}
@@ -0,0 +1,79 @@
+#include "hatchtile.h"
+#include <QtMath>
+#include <cmath>
+
+constexpr double HatchStyle::kMaxSpacing;
+
+static const int kMinTile = 4;            ///< Smallest tile edge tried (device px)
+static const int kMaxTile = 256;          ///< Largest tile edge tried at small spacings (device px)
+static const int kMaxTileLines = 8;       ///< Line periods a tile edge may span at large spacings
+static const double kGoodEnough = 0.005;  ///< Relative error accepted without searching further
+
+/**
+ * @brief Renders a square hatch tile for a style
+ *
+ * Line positions are t = (x nx + y ny) / spacing with the unit normal
+ * (nx, ny). The tile of edge N is seamless if N nx / spacing and
+ * N ny / spacing are integers (m, n); the smallest N whose (m, n) give
+ * the requested spacing and angle within kGoodEnough is used, otherwise
+ * the closest one found. The search goes up to kMaxTile, or further at
+ * large spacings (high DPR) until the edge spans kMaxTileLines lines.
+ *
+ * @param style Spacing, angle, width and colour (logical pixels)
+ * @param dpr Device pixel ratio of the target
+ * @return Tile and the realised spacing and angle
+ */
+HatchTile renderHatchTile(const HatchStyle &style, qreal dpr)
+{
+    const double spacing = qMax(1.0, double(style.spacing * dpr));
+    const double angle = qDegreesToRadians(double(style.angle_deg));
+    // Screen Y points down: a line at angle a runs along (cos a, -sin a)
+    const double nx = std::sin(angle), ny = std::cos(angle);
+
+    const int max_tile = qMax(kMaxTile, int(std::ceil(kMaxTileLines * spacing)));
+
+    int best_n = kMinTile, best_i = 1, best_j = 0;
+    double best_error = 1e9;
+    for (int size = kMinTile; size <= max_tile; ++size) {
+        const int i = int(std::lround(size * nx / spacing));
+        const int j = int(std::lround(size * ny / spacing));
+        if (i == 0 && j == 0)
+            continue;
+        const double len = std::hypot(double(i), double(j));
+        const double spacing_error = std::fabs(size / len - spacing) / spacing;
+        const double dot = qBound(-1.0, (i * nx + j * ny) / len, 1.0);
+        const double error = spacing_error + std::acos(dot);
+        if (error < best_error) {
+            best_error = error;
+            best_n = size;
+            best_i = i;
+            best_j = j;
+        }
+        if (best_error < kGoodEnough)
+            break;
+    }
+
+    const double len = std::hypot(double(best_i), double(best_j));
+    const double tile_spacing = best_n / len;
+    const double tnx = best_i / len, tny = best_j / len;
+    const double half_width = 0.5 * qMax(0.5, double(style.line_width * dpr));
+    const QRgb premultiplied = qPremultiply(style.color.rgba());
+
+    HatchTile tile;
+    tile.image = QImage(best_n, best_n, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < best_n; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(tile.image.scanLine(y));
+        for (int x = 0; x < best_n; ++x) {
+            const double t = ((x + 0.5) * tnx + (y + 0.5) * tny) / tile_spacing;
+            const double distance = std::fabs(t - std::floor(t + 0.5)) * tile_spacing;
+            const double coverage = qBound(0.0, half_width + 0.5 - distance, 1.0);
+            const int c = int(coverage * 255.0 + 0.5);
+            line[x] = qRgba(qRed(premultiplied) * c / 255, qGreen(premultiplied) * c / 255,
+                            qBlue(premultiplied) * c / 255, qAlpha(premultiplied) * c / 255);
+        }
+    }
+    tile.image.setDevicePixelRatio(dpr);
+    tile.spacing = tile_spacing / dpr;
+    tile.angle_deg = qRadiansToDegrees(std::atan2(tnx, tny));
+    return tile;
+}
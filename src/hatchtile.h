@@ -0,0 +1,57 @@
+#ifndef HATCHTILE_H
+#define HATCHTILE_H
+
+#include <QColor>
+#include <QImage>
+#include <QtGlobal>
+
+/**
+ * @brief How the shaded half-space is hatched
+ */
+struct HatchStyle
+{
+    /**
+     * @brief Fill method of the raster path
+     */
+    enum class Fill {
+        Tile,           ///< Pre-rendered tile QPixmap brush (spacing and angle apply)
+        Pattern         ///< Qt::BDiagPattern brush (fixed 8 px, 45 degrees)
+    };
+
+    static constexpr double kMaxSpacing = 64.0;   ///< Largest supported spacing (logical px)
+
+    Fill fill = Fill::Tile;           ///< Raster fill method
+    qreal spacing = 8.0 / 1.41421356237309504880; ///< Distance between lines (px), Qt::BDiagPattern density
+    qreal angle_deg = 45.0;           ///< Line angle, counter-clockwise from the screen x axis
+    qreal line_width = 1.0;           ///< Line width (px)
+    QColor color = QColor(100, 100, 100, 150); ///< Line colour
+};
+
+/**
+ * @brief Periodic hatch tile with the parameters it actually realises
+ *
+ * A tile only repeats seamlessly if the line family is periodic in its
+ * width and height, so angle and spacing are snapped to the nearest
+ * values with that property (within about half a percent).
+ */
+struct HatchTile
+{
+    QImage image;                     ///< Premultiplied tile, device pixels, DPR set
+    qreal spacing = 0.0;              ///< Realised line spacing (px)
+    qreal angle_deg = 0.0;            ///< Realised line angle (degrees)
+};
+
+/**
+ * @brief Renders a square hatch tile for a style
+ *
+ * Lines are antialiased analytically from their distance to each pixel
+ * centre. The tile repeats from the screen origin, so neighbouring
+ * fills join without seams when the brush origin is (0, 0).
+ *
+ * @param style Spacing, angle, width and colour (logical pixels)
+ * @param dpr Device pixel ratio of the target
+ * @return Tile and the realised spacing and angle
+ */
+HatchTile renderHatchTile(const HatchStyle &style, qreal dpr);
+
+#endif // HATCHTILE_H
@@ -0,0 +1,105 @@
+#include "headless.h"
+#include "recording.h"
+#include "simulation.h"
+#include "tsarenderer.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <cstdio>
+
+/**
+ * @brief Renders simulation frames without a window
+ *
+ * Frame 0 shows the initial state; every following frame advances the
+ * simulation by one step.
+ *
+ * @param options Frame count, size, time step and output
+ * @return Process exit code (0 on success)
+ */
+int runHeadless(const HeadlessOptions &options)
+{
+    const bool toStdout = (options.output == "-");
+
+    QFile rawOut;
+    if (toStdout) {
+        if (!rawOut.open(stdout, QIODevice::WriteOnly)) {
+            qCritical() << "Cannot open stdout:" << rawOut.errorString();
+            return 1;
+        }
+    } else {
+        if (!options.output.contains("%1")) {
+            qCritical() << "Output pattern must contain %1 for the frame number";
+            return 1;
+        }
+        QDir().mkpath(QFileInfo(options.output.arg(0)).absolutePath());
+    }
+
+    Simulation simulation(options.scenario);
+    RecordingWriter recorder;
+    RecordingReader reader;
+    QString error;
+    if (!options.record.isEmpty() && !recorder.open(options.record, options.config.step_sec, &error)) {
+        qCritical() << "Cannot record:" << error;
+        return 1;
+    }
+    if (!options.replay.isEmpty() && !reader.open(options.replay, &error)) {
+        qCritical() << "Cannot replay:" << error;
+        return 1;
+    }
+    const bool replaying = !options.replay.isEmpty();
+
+    SimSnapshot snapshot;
+    TSARenderer renderer;
+    renderer.setSensorLine(options.scenario.sensor_start, options.scenario.sensor_end);
+    renderer.setPerfOverlayEnabled(options.perf_overlay);
+    renderer.setConfig(options.config);
+    QImage frame(options.size, QImage::Format_ARGB32_Premultiplied);
+    const int frameBytes = frame.bytesPerLine() * frame.height();
+
+    QElapsedTimer clock;
+    clock.start();
+    int frames = 0;
+    for (int i = 0; i < options.frames; ++i) {
+        if (replaying) {
+            if (!reader.readNext(snapshot))
+                break;
+        } else {
+            if (i > 0)
+                simulation.step(options.config.step_sec);
+            simulation.fillSnapshot(snapshot);
+            recorder.append(simulation);
+        }
+
+        {
+            QPainter p(&frame);
+            renderer.render(p, options.size, 1.0, snapshot);
+        }
+
+        if (toStdout) {
+            if (rawOut.write(reinterpret_cast<const char *>(frame.constBits()),
+                             frameBytes) != frameBytes) {
+                qCritical() << "Short write on stdout at frame" << i;
+                return 1;
+            }
+        } else {
+            const QString path = options.output.arg(i, 6, 10, QChar('0'));
+            if (!frame.save(path, "PNG")) {
+                qCritical() << "Cannot write" << path;
+                return 1;
+            }
+        }
+        ++frames;
+    }
+    recorder.close();
+
+    const double elapsed = clock.nsecsElapsed() * 1e-9;
+    qInfo() << "Rendered" << frames << "frames of"
+            << options.size.width() << "x" << options.size.height()
+            << "in" << elapsed << "s (" << (elapsed > 0.0 ? frames / elapsed : 0.0)
+            << "frames/s)";
+    return 0;
+}
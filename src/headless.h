@@ -0,0 +1,41 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <QSize>
+#include <QString>
+#include "displayconfig.h"
+#include "scenario.h"
+
+/**
+ * @brief Options for offscreen batch frame generation
+ */
+struct HeadlessOptions
+{
+    int frames = 100;                 ///< Number of frames to render
+    QSize size = QSize(800, 560);     ///< Frame size in pixels
+    QString output = "frames/frame_%1.png"; ///< PNG path pattern (%1 = frame number), "-" for raw stdout
+    Scenario scenario = Scenario::defaultScenario(); ///< Own ship, contacts and sensor line
+    QString record;                   ///< Recording file for every step, empty for none
+    QString replay;                   ///< Recording to render instead of simulating, empty for none
+    bool perf_overlay = false;        ///< Draw the timing overlay into the frames
+    DisplayConfig config;             ///< Display parameters and simulated time between frames
+};
+
+/**
+ * @brief Renders simulation frames without a window
+ *
+ * Steps a Simulation directly (no worker thread, no timers) and paints
+ * each state with TSARenderer into a QImage. Frames are written either
+ * as numbered PNG files or, with output "-", as raw 32-bit ARGB buffers
+ * (width * height * 4 bytes per frame, QImage::Format_ARGB32 byte order;
+ * the frame is opaque so premultiplied and straight alpha coincide) on
+ * stdout. With a replay file the frames show the recorded ticks instead
+ * (one per frame, as fast as possible) and stop at the end of the
+ * recording. Requires a QGuiApplication, typically on the offscreen platform.
+ *
+ * @param options Frame count, size, time step and output
+ * @return Process exit code (0 on success)
+ */
+int runHeadless(const HeadlessOptions &options);
+
+#endif // HEADLESS_H
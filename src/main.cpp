@@ -1,23 +1,375 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QGuiApplication>
+#include <QScopedPointer>
+#include <QSurfaceFormat>
+#include <cstring>
+#include "batch.h"
+#include "configwatcher.h"
 #include "diagramwidget.h"
+#include "eventlog.h"
+#include "headless.h"
+#include "perfstats.h"
+#include "scenario.h"
+#include "simscheduler.h"
+#include "tsaglwidget.h"
+
+/**
+ * @brief Returns true if the given flag appears on the command line
+ *
+ * Matches "--flag" as well as "--flag=value". Needed before the
+ * application object exists, because the headless mode has to select
+ * the offscreen platform before Qt initializes.
+ */
+static bool hasFlag(int argc, char *argv[], const char *flag)
+{
+    const size_t length = std::strlen(flag);
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], flag, length) == 0
+            && (argv[i][length] == '\0' || argv[i][length] == '='))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Value of "--flag value" or "--flag=value" on the command line
+ *
+ * Like hasFlag(), for options that must be known before Qt initializes.
+ *
+ * @return The value, or an empty string if the flag is not given
+ */
+static QString flagValue(int argc, char *argv[], const char *flag)
+{
+    const size_t length = std::strlen(flag);
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], flag) == 0 && i + 1 < argc)
+            return QString::fromLocal8Bit(argv[i + 1]);
+        if (std::strncmp(argv[i], flag, length) == 0 && argv[i][length] == '=')
+            return QString::fromLocal8Bit(argv[i] + length + 1);
+    }
+    return QString();
+}
+
+/**
+ * @brief Applies the command line to a display widget and shows it
+ *
+ * TSAWidget and TSAGLWidget share these setters. With a watcher, later
+ * changes of the configuration file are applied to the widget as well.
+ */
+template <typename Display>
+static void showDisplay(Display &display, const DisplayConfig &config, ConfigWatcher *watcher,
+                        bool perfOverlay, const QString &record, const QString &replay)
+{
+    display.setSimulationStep(config.step_sec);
+    display.setConfig(config);
+    if (watcher)
+        QObject::connect(watcher, &ConfigWatcher::configChanged, &display, &Display::setConfig);
+    display.setPerfOverlayEnabled(perfOverlay);
+    if (!record.isEmpty())
+        display.startRecording(record);
+    if (!replay.isEmpty())
+        display.startReplay(replay);
+    display.show();
+}
 
 /**
  * @brief Main entry point for TSA Screen application
- * 
+ *
  * Creates the Qt application and main TSA display widget.
  * The TSAWidget handles all simulation and rendering logic.
- * 
+ *
+ * Options:
+ *   --scenario <file>   JSON scenario (own ship, contacts, legs, sensor line)
+ *   --config <file>     JSON display parameters (see DisplayConfig), reloaded
+ *                       while the window is open; overrides the options below
+ *   --record <file>     Record every simulation step to a binary file
+ *   --replay <file>     Show a recording instead of simulating
+ *   --step-ms <ms>      Fixed simulation step in milliseconds (default 2000, min 10)
+ *   --renderer <r>      Window renderer: raster (QPainter, default), opengl
+ *                       (OpenGL 3.3, falls back to raster when unavailable) or
+ *                       opengl-software (OpenGL on Mesa's llvmpipe, no GPU)
+ *   --hatch-fill <f>    Half-space hatch: tile (pre-rendered pixmap brush, default)
+ *                       or pattern (Qt::BDiagPattern); OpenGL always uses a shader
+ *   --hatch-spacing <px> Distance between hatch lines, 1 to 64 (default 5.66, BDiagPattern density)
+ *   --hatch-angle <deg> Hatch line angle, counter-clockwise from the x axis (default 45)
+ *   --headless          Render frames offscreen instead of opening a window
+ *   --frames <n>        Number of frames to render in headless mode (default 100)
+ *   --size <WxH>        Frame size in headless mode (default 800x560)
+ *   --output <pattern>  PNG path with %1 for the frame number, or "-" for raw
+ *                       ARGB32 frames on stdout (default frames/frame_%1.png)
+ *   --batch <runs>      Run a Monte Carlo batch without GUI, CSV summary per run
+ *   --ticks <n>         Steps per batch run (default 1000000)
+ *   --seed <n>          Base seed of the batch (default 1)
+ *   --threads <n>       Batch worker threads (default one per core)
+ *   --jitter <p,c,s>    Std. deviation of contact position (nm), course (deg)
+ *                       and speed (kn) per run (default 0.5,10,1)
+ *   --batch-output <file> CSV file for the batch, "-" for stdout (default -)
+ *   --batch-tracking    Also run the sensor and trackers in batch runs (slower)
+ *   --log <file>        Event log output, "-" for stderr (default -)
+ *   --log-format <f>    Event log lines: text or json (default text)
+ *   --log-level <spec>  Minimum level, "info" or per category "sim=info,replay=debug"
+ *                       (levels debug, info, warning, error, off; default debug)
+ *   --log-sample <spec> Keep 1 in N debug/info events, "10" or "sim=10" (default 1)
+ *   --perf-overlay      Draw p50/p99/max timings of the instrumented phases
+ *   --perf-dump <file>  Append timing histograms as JSON lines ("-" for stderr)
+ *   --perf-interval <ms> Period of --perf-dump lines (default 1000)
+ *
  * @param argc Command line argument count
  * @param argv Command line arguments array
  * @return Application exit code
  */
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
-    
+    const bool batch = hasFlag(argc, argv, "--batch");
+    const bool headless = hasFlag(argc, argv, "--headless");
+    if (headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    // The GL format and Mesa's driver choice must be set before Qt
+    // creates its first context
+    const QString rendererName = flagValue(argc, argv, "--renderer");
+    const bool openGL = !batch && !headless && rendererName.startsWith("opengl");
+    if (openGL) {
+        QSurfaceFormat::setDefaultFormat(TSAGLWidget::requiredFormat());
+        if (rendererName == "opengl-software" && qEnvironmentVariableIsEmpty("LIBGL_ALWAYS_SOFTWARE"))
+            qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+    }
+
+    QScopedPointer<QCoreApplication> app(batch
+        ? new QCoreApplication(argc, argv)
+        : headless
+        ? new QGuiApplication(argc, argv)
+        : new QApplication(argc, argv));
+    QCoreApplication::setApplicationName("TSAScreen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Tactical Situation Awareness display");
+    parser.addHelpOption();
+    QCommandLineOption scenarioOption("scenario",
+        "JSON scenario file (own ship, contacts, legs, sensor line).", "file");
+    QCommandLineOption configOption("config",
+        "JSON display parameters, reloaded when the file changes.", "file");
+    QCommandLineOption recordOption("record",
+        "Record every simulation step to a binary file.", "file");
+    QCommandLineOption replayOption("replay",
+        "Show a recording instead of simulating.", "file");
+    QCommandLineOption stepOption("step-ms",
+        "Fixed simulation step in milliseconds (min 10).", "ms", "2000");
+    QCommandLineOption rendererOption("renderer",
+        "Window renderer: raster, opengl or opengl-software (Mesa llvmpipe).",
+        "renderer", "raster");
+    QCommandLineOption hatchFillOption("hatch-fill",
+        "Half-space hatch: tile (pre-rendered pixmap brush) or pattern (Qt::BDiagPattern).",
+        "fill", "tile");
+    QCommandLineOption hatchSpacingOption("hatch-spacing",
+        "Distance between hatch lines in pixels (tile and OpenGL).", "px");
+    QCommandLineOption hatchAngleOption("hatch-angle",
+        "Hatch line angle in degrees, counter-clockwise from the x axis (tile and OpenGL).", "deg");
+    QCommandLineOption headlessOption("headless",
+        "Render frames offscreen instead of opening a window.");
+    QCommandLineOption framesOption("frames",
+        "Number of frames to render in headless mode.", "n", "100");
+    QCommandLineOption sizeOption("size",
+        "Frame size in headless mode.", "WxH", "800x560");
+    QCommandLineOption outputOption("output",
+        "PNG path pattern with %1 for the frame number, or - for raw ARGB32 on stdout.",
+        "pattern", "frames/frame_%1.png");
+    QCommandLineOption batchOption("batch",
+        "Run a Monte Carlo batch without GUI and write a CSV summary per run.", "runs");
+    QCommandLineOption ticksOption("ticks",
+        "Steps per batch run.", "n", "1000000");
+    QCommandLineOption seedOption("seed",
+        "Base seed of the batch.", "n", "1");
+    QCommandLineOption threadsOption("threads",
+        "Batch worker threads (0 = one per core).", "n", "0");
+    QCommandLineOption jitterOption("jitter",
+        "Std. deviation of contact position (nm), course (deg) and speed (kn) per batch run.",
+        "p,c,s", "0.5,10,1");
+    QCommandLineOption batchOutputOption("batch-output",
+        "CSV file for the batch summaries, or - for stdout.", "file", "-");
+    QCommandLineOption batchTrackingOption("batch-tracking",
+        "Also run the sensor model and the trackers in batch runs.");
+    QCommandLineOption logOption("log",
+        "Event log output, or - for stderr.", "file", "-");
+    QCommandLineOption logFormatOption("log-format",
+        "Event log line format: text or json.", "format", "text");
+    QCommandLineOption logLevelOption("log-level",
+        "Minimum event level (debug, info, warning, error, off), for all "
+        "categories or per category: sim=info,replay=debug,recording=warning.",
+        "spec", "debug");
+    QCommandLineOption logSampleOption("log-sample",
+        "Keep 1 in N debug/info events, for all categories or per category: sim=10.",
+        "spec", "1");
+    QCommandLineOption perfOverlayOption("perf-overlay",
+        "Draw p50/p99/max timings of the instrumented phases.");
+    QCommandLineOption perfDumpOption("perf-dump",
+        "Append timing histograms as JSON lines to file (- for stderr).", "file");
+    QCommandLineOption perfIntervalOption("perf-interval",
+        "Period of --perf-dump lines in milliseconds.", "ms", "1000");
+    parser.addOption(scenarioOption);
+    parser.addOption(configOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(stepOption);
+    parser.addOption(rendererOption);
+    parser.addOption(hatchFillOption);
+    parser.addOption(hatchSpacingOption);
+    parser.addOption(hatchAngleOption);
+    parser.addOption(headlessOption);
+    parser.addOption(framesOption);
+    parser.addOption(sizeOption);
+    parser.addOption(outputOption);
+    parser.addOption(batchOption);
+    parser.addOption(ticksOption);
+    parser.addOption(seedOption);
+    parser.addOption(threadsOption);
+    parser.addOption(jitterOption);
+    parser.addOption(batchOutputOption);
+    parser.addOption(batchTrackingOption);
+    parser.addOption(logOption);
+    parser.addOption(logFormatOption);
+    parser.addOption(logLevelOption);
+    parser.addOption(logSampleOption);
+    parser.addOption(perfOverlayOption);
+    parser.addOption(perfDumpOption);
+    parser.addOption(perfIntervalOption);
+    parser.process(*app);
+
+    const QString renderer = parser.value(rendererOption);
+    if (renderer != "raster" && renderer != "opengl" && renderer != "opengl-software") {
+        qCritical("Invalid --renderer, expected raster, opengl or opengl-software");
+        return 1;
+    }
+
+    Scenario scenario = Scenario::defaultScenario();
+    if (parser.isSet(scenarioOption)) {
+        QString error;
+        if (!Scenario::load(parser.value(scenarioOption), scenario, &error)) {
+            qCritical().noquote() << "Cannot load scenario:" << error;
+            return 1;
+        }
+    }
+    const bool perfOverlay = parser.isSet(perfOverlayOption);
+
+    // Defaults and command line first; a configuration file goes on top
+    DisplayConfig config;
+    config.step_sec = qMax(parser.value(stepOption).toDouble() / 1000.0, SimScheduler::kMinStepSec);
+    HatchStyle &hatch = config.hatch;
+    const QString hatchFill = parser.value(hatchFillOption);
+    if (hatchFill != "tile" && hatchFill != "pattern") {
+        qCritical("Invalid --hatch-fill, expected tile or pattern");
+        return 1;
+    }
+    hatch.fill = hatchFill == "tile" ? HatchStyle::Fill::Tile : HatchStyle::Fill::Pattern;
+    if (parser.isSet(hatchSpacingOption))
+        hatch.spacing = parser.value(hatchSpacingOption).toDouble();
+    if (parser.isSet(hatchAngleOption))
+        hatch.angle_deg = parser.value(hatchAngleOption).toDouble();
+    if (!(hatch.spacing >= 1.0 && hatch.spacing <= HatchStyle::kMaxSpacing)) {
+        qCritical("Invalid --hatch-spacing, expected 1 to 64 pixels");
+        return 1;
+    }
+    QScopedPointer<ConfigWatcher> configWatcher;
+    if (parser.isSet(configOption)) {
+        QString error;
+        configWatcher.reset(new ConfigWatcher(parser.value(configOption), config));
+        if (!configWatcher->load(&error)) {
+            qCritical().noquote() << "Cannot load configuration:" << error;
+            return 1;
+        }
+        config = configWatcher->config();
+    }
+
+    // Events are formatted and written on their own thread until exit
+    QString logError;
+    if (!EventLog::configureLevels(parser.value(logLevelOption), &logError)
+            || !EventLog::configureSampling(parser.value(logSampleOption), &logError)) {
+        qCritical().noquote() << "Invalid event log option:" << logError;
+        return 1;
+    }
+    const QString logFormat = parser.value(logFormatOption);
+    if (logFormat != "text" && logFormat != "json") {
+        qCritical("Invalid --log-format, expected text or json");
+        return 1;
+    }
+    EventLogWriter eventLog;
+    if (!eventLog.open(parser.value(logOption), logFormat == "json"
+                       ? EventLogWriter::Format::Json : EventLogWriter::Format::Text))
+        return 1;
+
+    // Timers are compiled in everywhere but only record when enabled
+    QScopedPointer<PerfDumper> perfDumper;
+    PerfStats::setEnabled(perfOverlay || parser.isSet(perfDumpOption));
+    if (parser.isSet(perfDumpOption)) {
+        perfDumper.reset(new PerfDumper(parser.value(perfDumpOption),
+                                        parser.value(perfIntervalOption).toInt()));
+        if (!perfDumper->isOpen())
+            return 1;
+    }
+
+    if (parser.isSet(batchOption)) {
+        BatchOptions options;
+        options.runs = parser.value(batchOption).toInt();
+        options.ticks = parser.value(ticksOption).toLongLong();
+        options.step_sec = config.step_sec;
+        options.seed = parser.value(seedOption).toULongLong();
+        options.threads = parser.value(threadsOption).toInt();
+        const QStringList jitter = parser.value(jitterOption).split(',');
+        if (jitter.size() != 3) {
+            qCritical("Invalid --jitter, expected position,course,speed");
+            return 1;
+        }
+        options.jitter_pos_nm = jitter[0].toDouble();
+        options.jitter_course_deg = jitter[1].toDouble();
+        options.jitter_speed_kn = jitter[2].toDouble();
+        options.output = parser.value(batchOutputOption);
+        options.tracking = parser.isSet(batchTrackingOption);
+        options.scenario = scenario;
+        const int result = runBatch(options);
+        if (perfDumper)
+            perfDumper->dump();
+        return result;
+    }
+
+    if (headless) {
+        HeadlessOptions options;
+        options.frames = parser.value(framesOption).toInt();
+        options.output = parser.value(outputOption);
+        const QStringList dims = parser.value(sizeOption).split('x');
+        if (dims.size() == 2)
+            options.size = QSize(dims[0].toInt(), dims[1].toInt());
+        if (options.frames < 0 || options.size.isEmpty()) {
+            qCritical("Invalid --frames or --size");
+            return 1;
+        }
+        options.scenario = scenario;
+        options.record = parser.value(recordOption);
+        options.replay = parser.value(replayOption);
+        options.perf_overlay = perfOverlay;
+        options.config = config;
+        const int result = runHeadless(options);
+        // The event loop never runs in headless mode: write one final line
+        if (perfDumper)
+            perfDumper->dump();
+        return result;
+    }
+
     // Create and show the main TSA display widget
-    TSAWidget widget;
-    widget.show();
-    
-    return app.exec();
-} 
\ No newline at end of file
+    QScopedPointer<QWidget> display;
+    const QString record = parser.value(recordOption);
+    const QString replay = parser.value(replayOption);
+    if (openGL && TSAGLWidget::isSupported()) {
+        TSAGLWidget *widget = new TSAGLWidget(scenario);
+        display.reset(widget);
+        showDisplay(*widget, config, configWatcher.data(), perfOverlay, record, replay);
+    } else {
+        if (openGL)
+            qWarning("OpenGL 3.3 core is not available, falling back to the raster renderer");
+        TSAWidget *widget = new TSAWidget(scenario);
+        display.reset(widget);
+        showDisplay(*widget, config, configWatcher.data(), perfOverlay, record, replay);
+    }
+
+    return app->exec();
+}
@@ -0,0 +1,249 @@
+#include "measurementgen.h"
+#include "halfplanekernel.h"
+#include <algorithm>
+#include <cmath>
+
+// Scans are due when their delivery time is reached up to this much (s),
+// so a delay that is a multiple of the step is not missed by rounding
+static const double kDueEpsilonSec = 1e-6;
+
+/**
+ * @brief SplitMix64 step, expands one seed into the generator state
+ */
+static quint64 splitMix64(quint64 &x)
+{
+    quint64 z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline quint64 rotl(quint64 x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// ===== SEEDED RANDOM =====
+
+/**
+ * @brief Restarts the sequence from a seed
+ * @param seed Random seed, expanded into the state with SplitMix64
+ */
+void SeededRandom::reseed(quint64 seed)
+{
+    for (quint64 &s : state)
+        s = splitMix64(seed);
+}
+
+/**
+ * @brief Next 64 random bits (xoshiro256**)
+ */
+quint64 SeededRandom::next()
+{
+    const quint64 result = rotl(state[1] * 5, 7) * 9;
+    const quint64 t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    return result;
+}
+
+/**
+ * @brief One standard normal value
+ *
+ * Draws a Box-Muller pair and returns its first value, the same value
+ * fillGaussian() would write first.
+ */
+double SeededRandom::gaussian()
+{
+    double z;
+    fillGaussian(&z, 1);
+    return z;
+}
+
+/**
+ * @brief Fills an array with standard normal values
+ *
+ * Box-Muller on pairs of uniforms; both outputs of a pair are used, and
+ * an odd count draws one extra pair.
+ *
+ * @param out Destination, count elements
+ * @param count Number of values
+ */
+void SeededRandom::fillGaussian(double *out, int count)
+{
+    const double kTwoPi = 6.283185307179586476925;
+    for (int i = 0; i < count; i += 2) {
+        const double u1 = 1.0 - uniform();     // (0, 1], log stays finite
+        const double u2 = uniform();
+        const double r = std::sqrt(-2.0 * std::log(u1));
+        out[i] = r * std::cos(kTwoPi * u2);
+        if (i + 1 < count)
+            out[i + 1] = r * std::sin(kTwoPi * u2);
+    }
+}
+
+// ===== MEASUREMENT GENERATOR =====
+
+/**
+ * @brief Constructor - seeds the generator from the model
+ * @param model Sensor error model
+ */
+MeasurementGenerator::MeasurementGenerator(const SensorModel &model)
+    : generated_count(0)
+{
+    setModel(model);
+}
+
+/**
+ * @brief Replaces the model and restarts the random sequence from its seed
+ * @param model Sensor error model
+ */
+void MeasurementGenerator::setModel(const SensorModel &model)
+{
+    sensor = model;
+    random.reseed(model.seed);
+    clutter_exp = std::exp(-qMax(0.0, model.clutter_per_scan));
+}
+
+/**
+ * @brief Produces one scan of measurements
+ *
+ * Random numbers are drawn in a fixed order (detection draws, noise,
+ * clutter count, clutter bearings), so the output depends only on the
+ * seed and the sequence of calls. Every contact's measurement is written
+ * and the output index only advances for detected ones, which keeps the
+ * loop free of branches. Gated contacts still consume their draws, so
+ * the gate does not shift the random sequence of the other contacts.
+ *
+ * @param time_sec Scan time (seconds)
+ * @param own_x Own ship X position (nm)
+ * @param own_y Own ship Y position (nm)
+ * @param truth_deg True bearing of each contact (degrees), count elements
+ * @param count Number of contacts
+ * @param batch Receives the scan; its arrays are resized in place
+ * @param gate Bit per contact (halfplanekernel.h), set where it cannot be detected; may be null
+ */
+void MeasurementGenerator::generate(double time_sec, double own_x, double own_y,
+                                    const double *truth_deg, int count, MeasurementBatch &batch,
+                                    const quint64 *gate)
+{
+    batch.time_sec = time_sec;
+    batch.own_x = own_x;
+    batch.own_y = own_y;
+
+    detect_draw.resize(count);
+    noise.resize(count);
+    double *draw = detect_draw.data();
+    double *z = noise.data();
+    for (int i = 0; i < count; ++i)
+        draw[i] = random.uniform();
+    const double sigma = sensor.bearing_sigma_deg;
+    if (sigma > 0.0)
+        random.fillGaussian(z, count);
+    else
+        std::fill(z, z + count, 0.0);
+
+    // Poisson clutter count (Knuth; the mean is a few per scan)
+    int clutter = 0;
+    if (sensor.clutter_per_scan > 0.0) {
+        for (double p = random.uniform(); p > clutter_exp; p *= random.uniform())
+            ++clutter;
+    }
+
+    batch.track.resize(count + clutter);
+    batch.bearing.resize(count + clutter);
+    int *track = batch.track.data();
+    double *bearing = batch.bearing.data();
+    const double pd = sensor.detection_prob;
+    const double bias = sensor.bias_deg;
+
+    int n = 0;
+    if (gate) {
+        for (int i = 0; i < count; ++i) {
+            double b = truth_deg[i] + bias + sigma * z[i];
+            b -= 360.0 * std::floor(b / 360.0);
+            track[n] = i;
+            bearing[n] = b;
+            n += (draw[i] < pd ? 1 : 0) & (1 ^ halfPlaneBit(gate, i));
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
+            double b = truth_deg[i] + bias + sigma * z[i];
+            b -= 360.0 * std::floor(b / 360.0);
+            track[n] = i;
+            bearing[n] = b;
+            n += draw[i] < pd ? 1 : 0;
+        }
+    }
+    batch.detections = n;
+
+    for (int c = 0; c < clutter; ++c, ++n) {
+        track[n] = -1;
+        bearing[n] = 360.0 * random.uniform();
+    }
+
+    batch.track.resize(n);
+    batch.bearing.resize(n);
+    generated_count += quint64(n);
+}
+
+// ===== MEASUREMENT QUEUE =====
+
+/**
+ * @brief Constructor - empty queue
+ * @param delay_sec Time from a scan to its delivery (seconds)
+ */
+MeasurementQueue::MeasurementQueue(double delay_sec)
+    : head(0),
+      count(0),
+      delay(qMax(0.0, delay_sec))
+{
+}
+
+/**
+ * @brief Appends a slot for a new scan
+ *
+ * A full ring is unrolled so the oldest batch sits at index 0 and grown
+ * by one slot; with a fixed delay and step this only happens until the
+ * ring holds one delay's worth of scans.
+ *
+ * @return The new batch, valid until it is popped
+ */
+MeasurementBatch &MeasurementQueue::push()
+{
+    if (count == ring.size()) {
+        std::rotate(ring.begin(), ring.begin() + head, ring.end());
+        head = 0;
+        ring.resize(count + 1);
+    }
+    ++count;
+    return ring[(head + count - 1) % ring.size()];
+}
+
+/**
+ * @brief Oldest batch if it is due
+ * @param now_sec Current time (seconds)
+ * @return The batch, or nullptr if none is due
+ */
+const MeasurementBatch *MeasurementQueue::ready(double now_sec) const
+{
+    if (count == 0)
+        return nullptr;
+    const MeasurementBatch &oldest = ring[head];
+    return oldest.time_sec + delay <= now_sec + kDueEpsilonSec ? &oldest : nullptr;
+}
+
+/**
+ * @brief Removes the oldest batch (its storage is kept for reuse)
+ */
+void MeasurementQueue::pop()
+{
+    if (count == 0)
+        return;
+    head = (head + 1) % ring.size();
+    --count;
+}
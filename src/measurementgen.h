@@ -0,0 +1,202 @@
+#ifndef MEASUREMENTGEN_H
+#define MEASUREMENTGEN_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief SensorModel - Error model of the simulated bearing sensor
+ *
+ * The defaults describe a perfect sensor: every contact is detected
+ * every scan at its true bearing, with no clutter and no delay.
+ */
+struct SensorModel
+{
+    double bearing_sigma_deg = 0.0;   ///< Gaussian bearing noise (degrees, 1 sigma)
+    double bias_deg = 0.0;            ///< Constant bearing bias (degrees)
+    double detection_prob = 1.0;      ///< Probability a contact is detected in a scan
+    double clutter_per_scan = 0.0;    ///< Mean number of false bearings per scan (Poisson)
+    double delay_sec = 0.0;           ///< Time from a scan to its delivery to the trackers (s)
+    bool baffle = false;              ///< No detections in the baffle (shaded side of the sensor line)
+    double baffle_gap_nm = 0.0;       ///< Distance beyond the sensor line where the baffle starts (nm)
+    quint64 seed = 1;                 ///< Random seed; equal seeds give equal measurements
+};
+
+/**
+ * @brief MeasurementBatch - Bearings of one sensor scan
+ *
+ * Detections come first in track order, then the clutter (track -1).
+ * The arrays are cleared and refilled in place, so a reused batch does
+ * not reallocate once it has reached its size.
+ */
+struct MeasurementBatch
+{
+    double time_sec = 0.0;            ///< Scan time (seconds)
+    double own_x = 0.0;               ///< Own ship X position at the scan (nm)
+    double own_y = 0.0;               ///< Own ship Y position at the scan (nm)
+    int detections = 0;               ///< Entries that belong to a track
+    QVector<int> track;               ///< Track index, -1 for clutter
+    QVector<double> bearing;          ///< Measured bearing (degrees, 0-360)
+
+    int size() const { return track.size(); }
+};
+
+/**
+ * @brief SeededRandom - Random numbers that are the same on every platform
+ *
+ * xoshiro256** seeded through SplitMix64, with uniform doubles from the
+ * top 53 bits and normal values from the Box-Muller transform. The
+ * <random> distributions are implementation-defined, so the same seed
+ * gives different values with different standard libraries; this class
+ * gives the same sequence everywhere.
+ */
+class SeededRandom
+{
+public:
+    /**
+     * @brief Constructs a generator at the start of a seed's sequence
+     * @param seed Random seed
+     */
+    explicit SeededRandom(quint64 seed = 1) { reseed(seed); }
+
+    /**
+     * @brief Restarts the sequence from a seed
+     * @param seed Random seed
+     */
+    void reseed(quint64 seed);
+
+    /**
+     * @brief Next 64 random bits (xoshiro256**)
+     */
+    quint64 next();
+
+    /**
+     * @brief Uniform double in [0, 1)
+     */
+    double uniform() { return double(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    /**
+     * @brief One standard normal value (the first of a Box-Muller pair)
+     */
+    double gaussian();
+
+    /**
+     * @brief Fills an array with standard normal values (Box-Muller, in pairs)
+     * @param out Destination, count elements
+     * @param count Number of values
+     */
+    void fillGaussian(double *out, int count);
+
+private:
+    quint64 state[4];                 ///< xoshiro256** state
+};
+
+/**
+ * @brief MeasurementGenerator - Seeded bearing measurements from the true contacts
+ *
+ * Turns the true bearings of every contact into one scan of sensor
+ * measurements: each contact is detected with the detection probability,
+ * its bearing gets the bias and Gaussian noise, and a Poisson number of
+ * uniformly distributed false bearings is added.
+ *
+ * Draws from a SeededRandom, so a seed gives the same measurements on
+ * every platform. A scan draws the random numbers into scratch arrays
+ * first and then builds the batch with a branch-free compaction loop;
+ * generating a measurement costs a few nanoseconds.
+ */
+class MeasurementGenerator
+{
+public:
+    /**
+     * @brief Constructs a generator seeded from the model
+     * @param model Sensor error model
+     */
+    explicit MeasurementGenerator(const SensorModel &model = SensorModel());
+
+    /**
+     * @brief Replaces the model and restarts the random sequence from its seed
+     * @param model Sensor error model
+     */
+    void setModel(const SensorModel &model);
+
+    const SensorModel &model() const { return sensor; }   ///< Current sensor model
+
+    /**
+     * @brief Produces one scan of measurements
+     * @param time_sec Scan time (seconds)
+     * @param own_x Own ship X position (nm)
+     * @param own_y Own ship Y position (nm)
+     * @param truth_deg True bearing of each contact (degrees), count elements
+     * @param count Number of contacts
+     * @param batch Receives the scan; its arrays are resized in place
+     * @param gate Optional bit per contact (see halfplanekernel.h); contacts
+     *        whose bit is set are not detected, e.g. those in the baffle
+     */
+    void generate(double time_sec, double own_x, double own_y,
+                  const double *truth_deg, int count, MeasurementBatch &batch,
+                  const quint64 *gate = nullptr);
+
+    quint64 generated() const { return generated_count; } ///< Measurements produced so far (detections and clutter)
+
+private:
+    SensorModel sensor;               ///< Error model
+    SeededRandom random;              ///< Random sequence of the model's seed
+    double clutter_exp;               ///< exp(-clutter_per_scan), Poisson sampling threshold
+    quint64 generated_count;          ///< Measurements produced so far
+
+    // ===== SCRATCH (reused every scan) =====
+    QVector<double> detect_draw;      ///< Uniform draw per contact
+    QVector<double> noise;            ///< Standard normal draw per contact
+};
+
+/**
+ * @brief MeasurementQueue - Scans in flight between the sensor and the trackers
+ *
+ * A FIFO of batches that become available a fixed delay after their scan
+ * time. Slots are kept in a ring and reused, so once the ring holds the
+ * batches of one delay it neither allocates nor copies measurements.
+ */
+class MeasurementQueue
+{
+public:
+    /**
+     * @brief Constructs an empty queue
+     * @param delay_sec Time from a scan to its delivery (seconds)
+     */
+    explicit MeasurementQueue(double delay_sec = 0.0);
+
+    void setDelay(double delay_sec) { delay = qMax(0.0, delay_sec); } ///< Delivery delay (s)
+    double delayTime() const { return delay; }                        ///< Delivery delay (s)
+
+    /**
+     * @brief Appends a slot for a new scan
+     *
+     * The returned batch still holds an old scan's data; fill it with
+     * MeasurementGenerator::generate() before the next call to ready().
+     *
+     * @return The new batch, valid until it is popped
+     */
+    MeasurementBatch &push();
+
+    /**
+     * @brief Oldest batch if it is due
+     * @param now_sec Current time (seconds)
+     * @return The batch, or nullptr if the queue is empty or its oldest scan is still in flight
+     */
+    const MeasurementBatch *ready(double now_sec) const;
+
+    /**
+     * @brief Removes the oldest batch
+     */
+    void pop();
+
+    int size() const { return count; }   ///< Batches in flight
+
+private:
+    QVector<MeasurementBatch> ring;   ///< Batch storage, reused
+    int head;                         ///< Index of the oldest batch
+    int count;                        ///< Batches in flight
+    double delay;                     ///< Delivery delay (s)
+};
+
+#endif // MEASUREMENTGEN_H
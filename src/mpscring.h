@@ -0,0 +1,99 @@
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief MpscRing - Bounded lock-free multi-producer/single-consumer queue
+ *
+ * Every slot carries a sequence number that tells producers and the
+ * consumer whose turn it is (Vyukov's bounded queue). A producer claims a
+ * slot with one compare-and-swap on the enqueue position and publishes it
+ * with a release store; the consumer needs no atomic read-modify-write at
+ * all. When the ring is full push() fails instead of waiting, so a
+ * producer on a hot path never blocks.
+ *
+ * @tparam T Element type, copy assignable
+ * @tparam Capacity Number of slots, a power of two
+ */
+template <typename T, int Capacity>
+class MpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    MpscRing()
+        : enqueue_pos(0),
+          pad_producers(),
+          dequeue_pos(0)
+    {
+        for (int i = 0; i < Capacity; ++i)
+            cells[i].sequence.store(quint64(i), std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    // ===== PRODUCER SIDE (any thread) =====
+
+    /**
+     * @brief Appends a copy of value
+     * @return false if the ring is full (value dropped)
+     */
+    bool push(const T &value)
+    {
+        quint64 pos = enqueue_pos.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &cells[pos & kMask];
+            const quint64 seq = slot->sequence.load(std::memory_order_acquire);
+            const qint64 diff = qint64(seq) - qint64(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = value;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ===== CONSUMER SIDE (one thread) =====
+
+    /**
+     * @brief Removes the oldest element
+     * @return false if the ring is empty
+     */
+    bool pop(T &value)
+    {
+        Slot &slot = cells[dequeue_pos & kMask];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos + 1)
+            return false;
+        value = slot.value;
+        slot.sequence.store(dequeue_pos + Capacity, std::memory_order_release);
+        ++dequeue_pos;
+        return true;
+    }
+
+private:
+    static const quint64 kMask = Capacity - 1;
+
+    struct Slot
+    {
+        std::atomic<quint64> sequence;  ///< pos: free for producer pos, pos + 1: filled
+        T value;
+    };
+
+    Slot cells[Capacity];             ///< Ring storage
+    std::atomic<quint64> enqueue_pos; ///< Next position to claim (producers)
+    char pad_producers[64];           ///< Keeps producer and consumer positions off one cache line
+    quint64 dequeue_pos;              ///< Next position to read (consumer only)
+};
+
+#endif // MPSCRING_H
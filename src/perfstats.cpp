@@ -0,0 +1,195 @@
+#include "perfstats.h"
+#include <QDateTime>
+#include <QDebug>
+#include <cstdio>
+
+std::atomic<bool> PerfStats::enabled_flag(false);
+
+/**
+ * @brief Short machine-readable name of a section (JSON key)
+ */
+const char *perfSectionName(PerfSection section)
+{
+    switch (section) {
+    case PerfSection::SimStep:       return "sim_step";
+    case PerfSection::FullLine:      return "full_line";
+    case PerfSection::HalfSpacePoly: return "half_space_poly";
+    case PerfSection::ConvexHull:    return "convex_hull";
+    case PerfSection::RasterStatic:  return "raster_static";
+    case PerfSection::RasterRebuild: return "raster_rebuild";
+    case PerfSection::RasterDynamic: return "raster_dynamic";
+    case PerfSection::Frame:         return "frame";
+    case PerfSection::GlUpload:      return "gl_upload";
+    case PerfSection::GlDraw:        return "gl_draw";
+    case PerfSection::Tma:           return "tma";
+    case PerfSection::Ekf:           return "ekf";
+    case PerfSection::Sensor:        return "sensor";
+    default:                         return "unknown";
+    }
+}
+
+// ===== LatencyHistogram =====
+
+/**
+ * @brief Constructor - all counters zero
+ */
+LatencyHistogram::LatencyHistogram()
+    : total(0),
+      max_ns(0)
+{
+    for (auto &bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Maps a duration to its bucket
+ *
+ * 0-15 ns map to themselves; larger values use the exponent (position
+ * of the highest set bit) and the next three bits as sub-bucket.
+ */
+int LatencyHistogram::bucketFor(quint64 ns)
+{
+    if (ns < 16)
+        return static_cast<int>(ns);
+    const int exponent = 63 - __builtin_clzll(ns);
+    const int sub = static_cast<int>((ns >> (exponent - 3)) & 7);
+    return 16 + (exponent - 4) * 8 + sub;
+}
+
+/**
+ * @brief Representative value of a bucket (middle of its range)
+ */
+quint64 LatencyHistogram::bucketMidpoint(int index)
+{
+    if (index < 16)
+        return static_cast<quint64>(index);
+    const int exponent = (index - 16) / 8 + 4;
+    const int sub = (index - 16) % 8;
+    const quint64 width = quint64(1) << (exponent - 3);
+    return (quint64(8 + sub) << (exponent - 3)) + width / 2;
+}
+
+/**
+ * @brief Records one duration
+ * @param ns Duration in nanoseconds
+ */
+void LatencyHistogram::record(quint64 ns)
+{
+    buckets[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+
+    quint64 seen = max_ns.load(std::memory_order_relaxed);
+    while (ns > seen && !max_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Clears all counters
+ */
+void LatencyHistogram::reset()
+{
+    for (auto &bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    max_ns.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Approximate percentile
+ * @param fraction Percentile as a fraction (0.5 for p50, 0.99 for p99)
+ * @return Duration in nanoseconds, 0 if empty
+ */
+quint64 LatencyHistogram::percentile(double fraction) const
+{
+    const quint64 n = count();
+    if (n == 0)
+        return 0;
+
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(fraction * n + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return qMin(bucketMidpoint(i), max());
+    }
+    return max();
+}
+
+// ===== PerfStats =====
+
+/**
+ * @brief Global instance
+ */
+PerfStats &PerfStats::instance()
+{
+    static PerfStats stats;
+    return stats;
+}
+
+/**
+ * @brief Formats all non-empty sections as one JSON object (no newline)
+ * @param reset true to clear the histograms after reading
+ */
+QByteArray PerfStats::toJson(bool reset)
+{
+    QByteArray json = "{\"t_ms\":";
+    json += QByteArray::number(QDateTime::currentMSecsSinceEpoch());
+    json += ",\"sections\":{";
+
+    bool first = true;
+    for (int i = 0; i < static_cast<int>(PerfSection::Count); ++i) {
+        LatencyHistogram &h = histograms[i];
+        if (h.count() == 0)
+            continue;
+
+        char entry[192];
+        std::snprintf(entry, sizeof(entry),
+                      "%s\"%s\":{\"n\":%llu,\"p50_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f}",
+                      first ? "" : ",", perfSectionName(static_cast<PerfSection>(i)),
+                      static_cast<unsigned long long>(h.count()),
+                      h.percentile(0.50) / 1000.0, h.percentile(0.99) / 1000.0,
+                      h.max() / 1000.0);
+        json += entry;
+        first = false;
+
+        if (reset)
+            h.reset();
+    }
+    json += "}}";
+    return json;
+}
+
+// ===== PerfDumper =====
+
+/**
+ * @brief Opens the output and starts the dump timer
+ * @param path Output file (appended), or "-" for stderr
+ * @param interval_ms Dump period in milliseconds
+ * @param parent Parent object
+ */
+PerfDumper::PerfDumper(const QString &path, int interval_ms, QObject *parent)
+    : QObject(parent),
+      timer(this)
+{
+    const bool ok = (path == "-")
+        ? out.open(stderr, QIODevice::WriteOnly)
+        : (out.setFileName(path), out.open(QIODevice::WriteOnly | QIODevice::Append));
+    if (!ok) {
+        qWarning() << "Cannot open perf dump output" << path << out.errorString();
+        return;
+    }
+
+    connect(&timer, &QTimer::timeout, this, &PerfDumper::dump);
+    timer.start(qMax(1, interval_ms));
+}
+
+/**
+ * @brief Writes one JSON line and resets the histograms
+ */
+void PerfDumper::dump()
+{
+    if (!out.isOpen())
+        return;
+    out.write(PerfStats::instance().toJson(true) + '\n');
+    out.flush();
+}
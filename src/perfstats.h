@@ -0,0 +1,200 @@
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QtGlobal>
+#include <atomic>
+#include <chrono>
+
+/**
+ * @file perfstats.h
+ * @brief Scoped timers and latency histograms for the hot paths
+ *
+ * Each instrumented phase (PerfSection) owns a LatencyHistogram. The
+ * PERF_SCOPE() macro times the enclosing block and records it; when
+ * instrumentation is disabled the cost is a single relaxed atomic load.
+ * Results are shown by the renderer overlay and written periodically as
+ * JSON lines by PerfDumper.
+ */
+
+/**
+ * @brief Instrumented phases
+ */
+enum class PerfSection {
+    SimStep,            ///< Simulation::step()
+    FullLine,           ///< computeFullLine()
+    HalfSpacePoly,      ///< buildHalfSpacePoly()
+    ConvexHull,         ///< buildConvexHull()
+    RasterStatic,       ///< Blitting (or redrawing) the static layer
+    RasterRebuild,      ///< Rebuilding the static layer cache
+    RasterDynamic,      ///< Markers, vectors and labels
+    Frame,              ///< Complete TSARenderer::render() call (or TSAGLWidget::paintGL())
+    GlUpload,           ///< OpenGL path: layout and instance buffer upload
+    GlDraw,             ///< OpenGL path: draw call submission
+    Tma,                ///< TmaEstimator::update() inside the simulation step
+    Ekf,                ///< EkfTracker predict and update inside the simulation step
+    Sensor,             ///< MeasurementGenerator::generate() inside the simulation step
+    Count
+};
+
+/**
+ * @brief Short machine-readable name of a section (JSON key)
+ */
+const char *perfSectionName(PerfSection section);
+
+/**
+ * @brief LatencyHistogram - Log-linear histogram of durations in nanoseconds
+ *
+ * Values below 16 ns get exact buckets; above that every power of two is
+ * split into 8 sub-buckets, so reported percentiles are within 12.5% of
+ * the true value. Counters are relaxed atomics: one thread may record
+ * while another reads or resets, at the price of slightly inconsistent
+ * totals during the race.
+ */
+class LatencyHistogram
+{
+public:
+    static const int kBucketCount = 16 + 60 * 8;
+
+    LatencyHistogram();
+
+    /**
+     * @brief Records one duration
+     * @param ns Duration in nanoseconds
+     */
+    void record(quint64 ns);
+
+    /**
+     * @brief Clears all counters
+     */
+    void reset();
+
+    quint64 count() const { return total.load(std::memory_order_relaxed); }
+    quint64 max() const { return max_ns.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Approximate percentile
+     * @param fraction Percentile as a fraction (0.5 for p50, 0.99 for p99)
+     * @return Duration in nanoseconds, 0 if empty
+     */
+    quint64 percentile(double fraction) const;
+
+private:
+    static int bucketFor(quint64 ns);
+    static quint64 bucketMidpoint(int index);
+
+    std::atomic<quint32> buckets[kBucketCount]; ///< Per-bucket counts
+    std::atomic<quint64> total;                 ///< Number of samples
+    std::atomic<quint64> max_ns;                ///< Largest sample
+};
+
+/**
+ * @brief PerfStats - Process-wide set of histograms, one per PerfSection
+ */
+class PerfStats
+{
+public:
+    /**
+     * @brief Global instance
+     */
+    static PerfStats &instance();
+
+    /**
+     * @brief Turns recording on or off (off by default)
+     */
+    static void setEnabled(bool enabled) { enabled_flag.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return enabled_flag.load(std::memory_order_relaxed); }
+
+    LatencyHistogram &histogram(PerfSection section)
+    { return histograms[static_cast<int>(section)]; }
+
+    /**
+     * @brief Formats all non-empty sections as one JSON object (no newline)
+     * @param reset true to clear the histograms after reading
+     */
+    QByteArray toJson(bool reset);
+
+private:
+    PerfStats() {}
+
+    LatencyHistogram histograms[static_cast<int>(PerfSection::Count)];
+    static std::atomic<bool> enabled_flag;
+};
+
+/**
+ * @brief ScopedTimer - Records the lifetime of the object into a section
+ */
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(PerfSection section)
+        : active(PerfStats::isEnabled()),
+          section(section)
+    {
+        if (active)
+            start = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedTimer()
+    {
+        if (active) {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            PerfStats::instance().histogram(section).record(static_cast<quint64>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    const bool active;
+    const PerfSection section;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+
+/**
+ * @brief Times the rest of the enclosing block into the given PerfSection
+ */
+#define PERF_SCOPE(section) ScopedTimer PERF_CONCAT(perf_scope_, __LINE__)(section)
+
+/**
+ * @brief PerfDumper - Periodically appends PerfStats as JSON lines
+ *
+ * Each line covers the interval since the previous one (histograms are
+ * reset after every dump):
+ *   {"t_ms":1700000000000,"sections":{"sim_step":{"n":50,"p50_us":3.1,...}}}
+ */
+class PerfDumper : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Opens the output and starts the dump timer
+     * @param path Output file (appended), or "-" for stderr
+     * @param interval_ms Dump period in milliseconds
+     * @param parent Parent object
+     */
+    PerfDumper(const QString &path, int interval_ms, QObject *parent = nullptr);
+
+    bool isOpen() const { return out.isOpen(); }
+
+public slots:
+    /**
+     * @brief Writes one JSON line and resets the histograms
+     */
+    void dump();
+
+private:
+    QFile out;                        ///< Output file or stderr
+    QTimer timer;                     ///< Dump period
+};
+
+#endif // PERFSTATS_H
@@ -0,0 +1,517 @@
+#include "recording.h"
+#include "eventlog.h"
+#include "simulation.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+static const char kHeaderMagic[8] = "TSAREC1";
+static const char kTrailerMagic[8] = "TSAIDX1";
+static const quint32 kByteOrderMark = 0x01020304;
+static const quint32 kTickMarker = 0x4B434954;     // "TICK" in little-endian files
+static const quint32 kFormatVersion = 1;
+
+static const LogEventFormat kBatchWrittenEvent = { "recording.batch", 1, { "bytes" } };
+
+/**
+ * @brief Size of one tick block (tick header plus its tracks)
+ */
+static qint64 blockSize(const RecordingTick &tick)
+{
+    return qint64(sizeof(RecordingTick)) + qint64(tick.track_count) * qint64(sizeof(RecordingTrack));
+}
+
+// ===== RecordingWriter =====
+
+/**
+ * @brief Constructor - no file yet
+ * @param parent Parent object
+ */
+RecordingWriter::RecordingWriter(QObject *parent)
+    : QThread(parent),
+      closing(false),
+      write_failed(false),
+      next_offset(0),
+      tick_count(0),
+      last_time_sec(0.0)
+{
+    setObjectName("TSA recording");
+}
+
+/**
+ * @brief Destructor - closes the file if still open
+ */
+RecordingWriter::~RecordingWriter()
+{
+    close();
+}
+
+/**
+ * @brief Creates the file, writes the header and starts the writer thread
+ * @param path Output file (truncated)
+ * @param step_sec Fixed simulation step, stored in the header
+ * @param error Set to a message on failure
+ * @return true on success
+ */
+bool RecordingWriter::open(const QString &path, double step_sec, QString *error)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error)
+            *error = QString("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    RecordingHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kHeaderMagic, sizeof(header.magic));
+    header.byte_order = kByteOrderMark;
+    header.version = kFormatVersion;
+    header.header_size = sizeof(RecordingHeader);
+    header.tick_size = sizeof(RecordingTick);
+    header.track_size = sizeof(RecordingTrack);
+    header.index_interval = kIndexInterval;
+    header.step_sec = step_sec;
+    if (file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        if (error)
+            *error = QString("%1: %2").arg(path, file.errorString());
+        file.close();
+        return false;
+    }
+
+    pending.reserve(2 * kBatchBytes);
+    closing = false;
+    write_failed = false;
+    index.clear();
+    next_offset = sizeof(RecordingHeader);
+    tick_count = 0;
+    last_time_sec = 0.0;
+    start();
+    return true;
+}
+
+/**
+ * @brief Queues the current state of the simulation as one tick
+ *
+ * Only the serialization into the batch happens on the calling thread;
+ * records are copied with memcpy because the batch gives no alignment
+ * guarantee for doubles.
+ *
+ * @param simulation Simulation to record (read on the calling thread)
+ */
+void RecordingWriter::append(const Simulation &simulation)
+{
+    if (!file.isOpen())
+        return;
+
+    const TrackStore &store = simulation.trackStore();
+    const int n = store.size();
+
+    RecordingTick tick;
+    std::memset(&tick, 0, sizeof(tick));
+    tick.marker        = kTickMarker;
+    tick.track_count   = n;
+    tick.tick          = simulation.tick();
+    tick.time_sec      = simulation.time();
+    tick.own_x         = simulation.ownX();
+    tick.own_y         = simulation.ownY();
+    tick.own_course    = simulation.ownCourse();
+    tick.own_speed     = simulation.ownSpeed();
+    tick.adopted_track = simulation.adoptedTrack();
+    tick.bearing       = simulation.bearing();
+    tick.range         = simulation.range();
+    tick.bearing_rate  = simulation.bearingRate();
+
+    if (tick_count % kIndexInterval == 0) {
+        RecordingIndexEntry entry = { tick.time_sec, tick.tick, next_offset };
+        index.append(entry);
+    }
+    const qint64 size = blockSize(tick);
+    next_offset += size;
+    ++tick_count;
+    last_time_sec = tick.time_sec;
+
+    const double *rx = store.relativeXData();
+    const double *ry = store.relativeYData();
+    const double *course = store.courseData();
+    const double *speed = store.speedData();
+    const double *bearing = store.bearingData();
+    const double *range = store.rangeData();
+    const double *rate = store.bearingRateData();
+
+    QMutexLocker lock(&mutex);
+    while (pending.size() >= kMaxPendingBytes && !write_failed)
+        space_available.wait(&mutex);
+    if (write_failed)
+        return;
+
+    const int offset = pending.size();
+    pending.resize(offset + static_cast<int>(size));
+    char *out = pending.data() + offset;
+    std::memcpy(out, &tick, sizeof(tick));
+    out += sizeof(tick);
+    for (int i = 0; i < n; ++i) {
+        const RecordingTrack track = { rx[i], ry[i], course[i], speed[i],
+                                       bearing[i], range[i], rate[i] };
+        std::memcpy(out, &track, sizeof(track));
+        out += sizeof(track);
+    }
+
+    if (pending.size() >= kBatchBytes)
+        batch_ready.wakeOne();
+}
+
+/**
+ * @brief Writer thread: swaps out batches and writes them to disk
+ *
+ * The mutex is held only for the swap; the disk write runs unlocked so
+ * append() never waits for I/O unless kMaxPendingBytes are queued.
+ */
+void RecordingWriter::run()
+{
+    QByteArray batch;
+    batch.reserve(2 * kBatchBytes);
+
+    for (;;) {
+        bool last = false;
+        {
+            QMutexLocker lock(&mutex);
+            if (pending.size() < kBatchBytes && !closing)
+                batch_ready.wait(&mutex, kFlushIntervalMs);
+            pending.swap(batch);
+            last = closing;
+            space_available.wakeAll();
+        }
+
+        if (!batch.isEmpty()) {
+            if (file.write(batch) != batch.size()) {
+                QMutexLocker lock(&mutex);
+                write_failed = true;
+                space_available.wakeAll();
+            }
+            EVENT_LOG(LogCategory::Recording, LogLevel::Debug, kBatchWrittenEvent,
+                      double(batch.size()));
+            batch.resize(0);
+        }
+        if (last)
+            break;
+    }
+    file.flush();
+}
+
+/**
+ * @brief Writes the remaining batch, the index and the trailer, then stops the thread
+ *
+ * Must be called from the thread that calls append().
+ */
+void RecordingWriter::close()
+{
+    if (!file.isOpen())
+        return;
+
+    {
+        QMutexLocker lock(&mutex);
+        closing = true;
+        batch_ready.wakeOne();
+    }
+    wait();
+
+    if (!write_failed) {
+        RecordingTrailer trailer;
+        std::memset(&trailer, 0, sizeof(trailer));
+        trailer.index_offset = next_offset;
+        trailer.index_count = index.size();
+        trailer.tick_count = tick_count;
+        trailer.end_time_sec = last_time_sec;
+        std::memcpy(trailer.magic, kTrailerMagic, sizeof(trailer.magic));
+
+        const qint64 indexBytes = qint64(index.size()) * sizeof(RecordingIndexEntry);
+        if (file.write(reinterpret_cast<const char *>(index.constData()), indexBytes) != indexBytes
+                || file.write(reinterpret_cast<const char *>(&trailer), sizeof(trailer))
+                   != sizeof(trailer))
+            write_failed = true;
+    }
+    if (write_failed)
+        qWarning() << "Recording" << file.fileName() << "is incomplete:" << file.errorString();
+    file.close();
+}
+
+// ===== RecordingReader =====
+
+/**
+ * @brief Constructor - no file yet
+ */
+RecordingReader::RecordingReader()
+    : data(nullptr),
+      data_size(0),
+      index(nullptr),
+      index_count(0),
+      data_end(0),
+      cursor(0),
+      tick_count(0),
+      start_time_sec(0.0),
+      end_time_sec(0.0)
+{
+    std::memset(&header, 0, sizeof(header));
+}
+
+/**
+ * @brief Destructor - unmaps the file
+ */
+RecordingReader::~RecordingReader()
+{
+    close();
+}
+
+/**
+ * @brief Unmaps and closes the file
+ */
+void RecordingReader::close()
+{
+    if (data)
+        file.unmap(const_cast<uchar *>(data));
+    file.close();
+    data = nullptr;
+    data_size = 0;
+    index = nullptr;
+    index_count = 0;
+    rebuilt_index.clear();
+    data_end = 0;
+    cursor = 0;
+    tick_count = 0;
+    start_time_sec = 0.0;
+    end_time_sec = 0.0;
+}
+
+/**
+ * @brief Maps a recording and loads (or rebuilds) its index
+ * @param path Recording file
+ * @param error Set to a message on failure
+ * @return true on success
+ */
+bool RecordingReader::open(const QString &path, QString *error)
+{
+    close();
+
+    file.setFileName(path);
+    QString problem;
+    if (!file.open(QIODevice::ReadOnly)) {
+        problem = file.errorString();
+    } else {
+        data_size = file.size();
+        if (data_size >= qint64(sizeof(RecordingHeader)))
+            data = file.map(0, data_size);
+        if (!data)
+            problem = data_size < qint64(sizeof(RecordingHeader))
+                      ? QString("not a TSA recording") : file.errorString();
+    }
+
+    if (problem.isEmpty()) {
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, kHeaderMagic, sizeof(header.magic)) != 0)
+            problem = "not a TSA recording";
+        else if (header.byte_order != kByteOrderMark)
+            problem = "recorded on a host with a different byte order";
+        else if (header.version != kFormatVersion || header.header_size != sizeof(RecordingHeader)
+                 || header.tick_size != sizeof(RecordingTick)
+                 || header.track_size != sizeof(RecordingTrack)
+                 || header.index_interval == 0)
+            problem = QString("unsupported format version %1").arg(header.version);
+    }
+
+    if (!problem.isEmpty()) {
+        if (error)
+            *error = QString("%1: %2").arg(path, problem);
+        close();
+        return false;
+    }
+
+    loadIndex();
+    cursor = header.header_size;
+    const RecordingTick *first = tickAt(cursor);
+    start_time_sec = first ? first->time_sec : 0.0;
+    return true;
+}
+
+/**
+ * @brief Loads the index from the trailer, or rebuilds it by a scan
+ *
+ * A valid trailer's index is used in place. Without one, the scan walks
+ * the tick headers from the start and stops at the first incomplete or
+ * damaged block, which becomes the end of the data.
+ */
+void RecordingReader::loadIndex()
+{
+    const qint64 trailerOffset = data_size - qint64(sizeof(RecordingTrailer));
+    if (trailerOffset >= qint64(sizeof(RecordingHeader))) {
+        const RecordingTrailer *trailer =
+            reinterpret_cast<const RecordingTrailer *>(data + trailerOffset);
+        if (std::memcmp(trailer->magic, kTrailerMagic, sizeof(trailer->magic)) == 0
+                && trailer->index_offset >= sizeof(RecordingHeader)
+                && trailer->index_offset % 8 == 0
+                && trailer->index_offset + trailer->index_count * sizeof(RecordingIndexEntry)
+                   == quint64(trailerOffset)) {
+            index = reinterpret_cast<const RecordingIndexEntry *>(data + trailer->index_offset);
+            index_count = qint64(trailer->index_count);
+            data_end = qint64(trailer->index_offset);
+            tick_count = trailer->tick_count;
+            end_time_sec = trailer->end_time_sec;
+            return;
+        }
+    }
+
+    // No valid trailer: rebuild by walking the tick headers
+    data_end = data_size;
+    tick_count = 0;
+    qint64 pos = header.header_size;
+    while (const RecordingTick *tick = tickAt(pos)) {
+        if (tick_count % header.index_interval == 0) {
+            RecordingIndexEntry entry = { tick->time_sec, tick->tick, quint64(pos) };
+            rebuilt_index.append(entry);
+        }
+        end_time_sec = tick->time_sec;
+        ++tick_count;
+        pos += blockSize(*tick);
+    }
+    data_end = pos;
+    index = rebuilt_index.constData();
+    index_count = rebuilt_index.size();
+}
+
+/**
+ * @brief Tick header at a file offset, nullptr past the last complete block
+ *
+ * Also rejects a damaged header (wrong marker) or a block whose tracks
+ * run past the end of the data.
+ */
+const RecordingTick *RecordingReader::tickAt(qint64 offset) const
+{
+    if (!data || offset + qint64(sizeof(RecordingTick)) > data_end)
+        return nullptr;
+    const RecordingTick *tick = reinterpret_cast<const RecordingTick *>(data + offset);
+    if (tick->marker != kTickMarker || tick->track_count < 0
+            || offset + blockSize(*tick) > data_end)
+        return nullptr;
+    return tick;
+}
+
+/**
+ * @brief Decodes the next tick into a snapshot
+ *
+ * Reads the records in place; the only copy is the transposition of the
+ * per-track records into the snapshot's column arrays.
+ *
+ * @param snap Snapshot to fill; its arrays are resized in place
+ * @return false at the end of the recording
+ */
+bool RecordingReader::readNext(SimSnapshot &snap)
+{
+    const RecordingTick *tick = tickAt(cursor);
+    if (!tick)
+        return false;
+    cursor += blockSize(*tick);
+
+    snap.tick          = tick->tick;
+    snap.time_sec      = tick->time_sec;
+    snap.own_x         = tick->own_x;
+    snap.own_y         = tick->own_y;
+    snap.own_course    = tick->own_course;
+    snap.own_speed     = tick->own_speed;
+    snap.adopted_track = tick->adopted_track;
+    snap.bearing       = tick->bearing;
+    snap.range         = tick->range;
+    snap.bearing_rate  = tick->bearing_rate;
+
+    const int n = tick->track_count;
+    snap.rel_x.resize(n);
+    snap.rel_y.resize(n);
+    snap.course.resize(n);
+    snap.speed.resize(n);
+    snap.track_bearing.resize(n);
+    snap.track_range.resize(n);
+    snap.track_rate.resize(n);
+    double *rx = snap.rel_x.data();
+    double *ry = snap.rel_y.data();
+    double *course = snap.course.data();
+    double *speed = snap.speed.data();
+    double *bearing = snap.track_bearing.data();
+    double *range = snap.track_range.data();
+    double *rate = snap.track_rate.data();
+
+    const RecordingTrack *in = reinterpret_cast<const RecordingTrack *>(tick + 1);
+    for (int i = 0; i < n; ++i) {
+        rx[i]      = in[i].rel_x;
+        ry[i]      = in[i].rel_y;
+        course[i]  = in[i].course;
+        speed[i]   = in[i].speed;
+        bearing[i] = in[i].bearing;
+        range[i]   = in[i].range;
+        rate[i]    = in[i].rate;
+    }
+
+    // Estimates are not recorded
+    snap.tma_solved.resize(0);
+    snap.tma_range.resize(0);
+    snap.tma_course.resize(0);
+    snap.tma_speed.resize(0);
+    snap.ekf_valid.resize(0);
+    snap.ekf_course.resize(0);
+    snap.ekf_speed.resize(0);
+
+    snap.buildIndex();
+    return true;
+}
+
+/**
+ * @brief Skips ticks without decoding them
+ * @param count Number of ticks to skip
+ * @return Number of ticks actually skipped
+ */
+int RecordingReader::skip(int count)
+{
+    int skipped = 0;
+    while (skipped < count) {
+        const RecordingTick *tick = tickAt(cursor);
+        if (!tick)
+            break;
+        cursor += blockSize(*tick);
+        ++skipped;
+    }
+    return skipped;
+}
+
+/**
+ * @brief Positions the reader on the last tick at or before time_sec
+ *
+ * Binary search on the sparse index, then a walk over at most
+ * index_interval tick headers.
+ *
+ * @param time_sec Simulation time (seconds)
+ * @return false if the recording is empty
+ */
+bool RecordingReader::seek(double time_sec)
+{
+    if (index_count == 0)
+        return false;
+
+    const RecordingIndexEntry *it =
+        std::upper_bound(index, index + index_count, time_sec,
+                         [](double t, const RecordingIndexEntry &entry) {
+                             return t < entry.time_sec;
+                         });
+    if (it != index)
+        --it;
+
+    qint64 pos = qint64(it->offset);
+    while (const RecordingTick *tick = tickAt(pos)) {
+        const qint64 next = pos + blockSize(*tick);
+        const RecordingTick *following = tickAt(next);
+        if (!following || following->time_sec > time_sec)
+            break;
+        pos = next;
+    }
+    cursor = pos;
+    return true;
+}
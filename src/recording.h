@@ -0,0 +1,275 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtGlobal>
+
+class Simulation;
+struct SimSnapshot;
+
+/**
+ * @file recording.h
+ * @brief Append-only binary recording of the simulation state
+ *
+ * File layout (host byte order, checked with RecordingHeader::byte_order):
+ *
+ *   RecordingHeader
+ *   { RecordingTick, RecordingTrack x track_count }   one block per tick
+ *   ...
+ *   RecordingIndexEntry x index_count                 written on close
+ *   RecordingTrailer                                  written on close
+ *
+ * Every record has a fixed size. A file without trailer (the writer did
+ * not close cleanly) is still readable; its index is rebuilt by walking
+ * the tick headers and a truncated last block is ignored.
+ */
+
+/**
+ * @brief File header (64 bytes)
+ */
+struct RecordingHeader
+{
+    char magic[8];                    ///< "TSAREC1" + NUL
+    quint32 byte_order;               ///< kByteOrderMark in the writer's byte order
+    quint32 version;                  ///< Format version (1)
+    quint32 header_size;              ///< sizeof(RecordingHeader)
+    quint32 tick_size;                ///< sizeof(RecordingTick)
+    quint32 track_size;               ///< sizeof(RecordingTrack)
+    quint32 index_interval;           ///< Ticks between index entries
+    double step_sec;                  ///< Fixed simulation step of the run (seconds)
+    quint64 reserved[3];              ///< Zero
+};
+
+/**
+ * @brief Per-tick record: own ship and adopted track (88 bytes)
+ */
+struct RecordingTick
+{
+    quint32 marker;                   ///< kTickMarker, guards against misaligned reads
+    qint32 track_count;               ///< Number of RecordingTrack records that follow
+    quint64 tick;                     ///< Steps simulated
+    double time_sec;                  ///< Simulation time (seconds)
+    double own_x;                     ///< Own ship X position (nm)
+    double own_y;                     ///< Own ship Y position (nm)
+    double own_course;                ///< Own ship course (degrees)
+    double own_speed;                 ///< Own ship speed (knots)
+    qint32 adopted_track;             ///< Adopted track index, -1 if none
+    quint32 reserved;                 ///< Zero
+    double bearing;                   ///< Adopted track bearing (degrees)
+    double range;                     ///< Adopted track range (nm)
+    double bearing_rate;              ///< Adopted track bearing rate (deg/s)
+};
+
+/**
+ * @brief Per-track record (56 bytes)
+ */
+struct RecordingTrack
+{
+    double rel_x;                     ///< X relative to own ship (nm)
+    double rel_y;                     ///< Y relative to own ship (nm)
+    double course;                    ///< Course (degrees)
+    double speed;                     ///< Speed (knots)
+    double bearing;                   ///< Bearing (degrees)
+    double range;                     ///< Range (nm)
+    double rate;                      ///< Bearing rate (deg/s)
+};
+
+/**
+ * @brief Sparse time index entry (24 bytes)
+ */
+struct RecordingIndexEntry
+{
+    double time_sec;                  ///< Time of the indexed tick
+    quint64 tick;                     ///< Tick number
+    quint64 offset;                   ///< File offset of its RecordingTick
+};
+
+/**
+ * @brief File trailer, the last 40 bytes of a cleanly closed recording
+ */
+struct RecordingTrailer
+{
+    quint64 index_offset;             ///< File offset of the first index entry
+    quint64 index_count;              ///< Number of index entries
+    quint64 tick_count;               ///< Number of tick blocks
+    double end_time_sec;              ///< Time of the last tick
+    char magic[8];                    ///< "TSAIDX1" + NUL
+};
+
+static_assert(sizeof(RecordingHeader) == 64, "RecordingHeader layout");
+static_assert(sizeof(RecordingTick) == 88, "RecordingTick layout");
+static_assert(sizeof(RecordingTrack) == 56, "RecordingTrack layout");
+static_assert(sizeof(RecordingIndexEntry) == 24, "RecordingIndexEntry layout");
+static_assert(sizeof(RecordingTrailer) == 40, "RecordingTrailer layout");
+
+/**
+ * @brief RecordingWriter - Background writer for a recording file
+ *
+ * append() serializes one tick into an in-memory batch under a mutex and
+ * returns; the writer thread swaps the batch out and writes it to disk
+ * when it reaches kBatchBytes or every kFlushIntervalMs. The producer
+ * only blocks if kMaxPendingBytes are waiting (disk slower than the
+ * simulation), so no tick is ever dropped.
+ */
+class RecordingWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    static const int kIndexInterval = 64;              ///< Ticks between index entries
+    static const int kBatchBytes = 256 * 1024;         ///< Batch size that wakes the writer
+    static const int kFlushIntervalMs = 200;           ///< Longest time a batch waits
+    static const int kMaxPendingBytes = 64 * 1024 * 1024; ///< Producer back-pressure limit
+
+    explicit RecordingWriter(QObject *parent = nullptr);
+
+    /**
+     * @brief Closes the file if still open
+     */
+    ~RecordingWriter() override;
+
+    /**
+     * @brief Creates the file, writes the header and starts the writer thread
+     * @param path Output file (truncated)
+     * @param step_sec Fixed simulation step, stored in the header
+     * @param error Set to a message on failure
+     * @return true on success
+     */
+    bool open(const QString &path, double step_sec, QString *error = nullptr);
+
+    /**
+     * @brief Queues the current state of the simulation as one tick
+     * @param simulation Simulation to record (read on the calling thread)
+     */
+    void append(const Simulation &simulation);
+
+    /**
+     * @brief Writes the remaining batch, the index and the trailer, then stops the thread
+     */
+    void close();
+
+    bool isOpen() const { return file.isOpen(); }
+    quint64 tickCount() const { return tick_count; }
+
+protected:
+    /**
+     * @brief Writer thread: swaps out batches and writes them to disk
+     */
+    void run() override;
+
+private:
+    QFile file;                       ///< Output file
+    QMutex mutex;                     ///< Guards pending, closing and write_failed
+    QWaitCondition batch_ready;       ///< Wakes the writer thread
+    QWaitCondition space_available;   ///< Wakes a producer blocked on kMaxPendingBytes
+    QByteArray pending;               ///< Ticks serialized since the last swap
+    bool closing;                     ///< close() requested
+    bool write_failed;                ///< A write error occurred on the writer thread
+
+    // ===== PRODUCER-SIDE STATE =====
+    QVector<RecordingIndexEntry> index;   ///< Sparse time index
+    quint64 next_offset;              ///< File offset of the next tick block
+    quint64 tick_count;               ///< Ticks appended
+    double last_time_sec;             ///< Time of the last appended tick
+};
+
+/**
+ * @brief RecordingReader - Memory-mapped reader with random-access seek
+ *
+ * The whole file is mapped read-only and records, including the index
+ * stored in the trailer, are used in place (every record size is a
+ * multiple of 8 bytes, so they stay aligned). A seek is a binary search
+ * on the sparse index plus a walk over at most index_interval tick
+ * headers, independent of the file size, and only the pages actually
+ * touched are read from disk.
+ */
+class RecordingReader
+{
+public:
+    RecordingReader();
+
+    /**
+     * @brief Unmaps the file
+     */
+    ~RecordingReader();
+
+    /**
+     * @brief Maps a recording and loads (or rebuilds) its index
+     * @param path Recording file
+     * @param error Set to a message on failure
+     * @return true on success
+     */
+    bool open(const QString &path, QString *error = nullptr);
+
+    double stepSec() const { return header.step_sec; }    ///< Recorded step (s)
+    double startTime() const { return start_time_sec; }   ///< First tick time (s)
+    double endTime() const { return end_time_sec; }       ///< Last tick time (s)
+    quint64 tickCount() const { return tick_count; }      ///< Tick blocks in the file
+    bool atEnd() const { return !tickAt(cursor); }         ///< No tick left to read
+
+    /**
+     * @brief Decodes the next tick into a snapshot
+     *
+     * The adopted track's bearing, range and rate land in the snapshot
+     * fields that mirror Simulation's current_bearing, current_range and
+     * current_bearing_rate.
+     *
+     * @param snap Snapshot to fill; its arrays are resized in place
+     * @return false at the end of the recording
+     */
+    bool readNext(SimSnapshot &snap);
+
+    /**
+     * @brief Skips ticks without decoding them
+     * @param count Number of ticks to skip
+     * @return Number of ticks actually skipped
+     */
+    int skip(int count);
+
+    /**
+     * @brief Positions the reader on the last tick at or before time_sec
+     *
+     * Times before the first tick select the first tick.
+     *
+     * @param time_sec Simulation time (seconds)
+     * @return false if the recording is empty
+     */
+    bool seek(double time_sec);
+
+private:
+    /**
+     * @brief Tick header at a file offset, nullptr past the last complete block
+     */
+    const RecordingTick *tickAt(qint64 offset) const;
+
+    /**
+     * @brief Loads the index from the trailer, or rebuilds it by a scan
+     */
+    void loadIndex();
+
+    /**
+     * @brief Unmaps and closes the file
+     */
+    void close();
+
+    QFile file;                       ///< Recording file
+    const uchar *data;                ///< Read-only mapping of the whole file
+    qint64 data_size;                 ///< Mapped bytes
+    RecordingHeader header;           ///< Validated file header
+    const RecordingIndexEntry *index; ///< Sparse time index (in the mapping or rebuilt)
+    qint64 index_count;               ///< Index entries
+    QVector<RecordingIndexEntry> rebuilt_index; ///< Index rebuilt by a scan, no trailer
+    qint64 data_end;                  ///< End of the last complete tick block
+    qint64 cursor;                    ///< Offset of the next tick to read
+    quint64 tick_count;               ///< Tick blocks in the file
+    double start_time_sec;            ///< First tick time
+    double end_time_sec;              ///< Last tick time
+};
+
+#endif // RECORDING_H
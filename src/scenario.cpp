@@ -0,0 +1,512 @@
+#include "scenario.h"
+#include <QByteArray>
+#include <QFile>
+#include <cctype>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief The built-in scenario: one target at (3,3) nm heading East at 8 knots
+ */
+Scenario Scenario::defaultScenario()
+{
+    Scenario scenario;
+    scenario.name = "Default";
+    scenario.adopted_track = scenario.contacts.addTrack(3.0, 3.0, 90.0, 8.0);
+    return scenario;
+}
+
+// ===== JSON SCANNER =====
+
+namespace {
+
+/**
+ * @brief Member name inside the input buffer (not unescaped)
+ */
+struct JsonKey
+{
+    const char *data = nullptr;
+    int size = 0;
+
+    bool operator==(const char *name) const
+    {
+        return qstrncmp(data, name, size) == 0 && name[size] == '\0';
+    }
+};
+
+/**
+ * @brief JsonScanner - Forward-only JSON reader over an in-memory buffer
+ *
+ * The caller drives it with the expected structure (nextMember(),
+ * nextElement(), readNumber(), ...) and skips what it does not know with
+ * skipValue(), so no document tree is ever built. The first error is kept
+ * together with its line number; every later call then fails.
+ */
+class JsonScanner
+{
+public:
+    JsonScanner(const char *data, const char *data_end)
+        : start(data), pos(data), end(data_end), error_pos(nullptr)
+    {
+    }
+
+    bool failed() const { return error_pos != nullptr; }
+
+    /**
+     * @brief Error text with the line it occurred on
+     */
+    QString errorString() const
+    {
+        int line = 1;
+        for (const char *c = start; c < error_pos; ++c)
+            line += (*c == '\n');
+        return QString("line %1: %2").arg(line).arg(error);
+    }
+
+    bool fail(const QString &message)
+    {
+        if (!error_pos) {
+            error_pos = qMin(pos, end);
+            error = message;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Consumes the given character after whitespace, or fails
+     */
+    bool expect(char c)
+    {
+        if (consume(c))
+            return true;
+        return fail(QString("expected '%1'").arg(QLatin1Char(c)));
+    }
+
+    /**
+     * @brief Steps to the next member of an object
+     *
+     * Call with first = true right after the opening brace has been
+     * consumed; returns false at the closing brace or on error.
+     */
+    bool nextMember(bool &first, JsonKey &key)
+    {
+        if (failed() || consume('}'))
+            return false;
+        if (!first && !expect(','))
+            return false;
+        first = false;
+        return readKey(key) && expect(':');
+    }
+
+    /**
+     * @brief Steps to the next element of an array (see nextMember())
+     */
+    bool nextElement(bool &first)
+    {
+        if (failed() || consume(']'))
+            return false;
+        if (!first && !expect(','))
+            return false;
+        first = false;
+        return true;
+    }
+
+    /**
+     * @brief Reads a number in JSON syntax (locale independent)
+     */
+    bool readNumber(double &value)
+    {
+        skipWhitespace();
+        const char *begin = pos;
+        while (pos < end && (std::isdigit(static_cast<unsigned char>(*pos))
+                             || *pos == '-' || *pos == '+' || *pos == '.'
+                             || *pos == 'e' || *pos == 'E'))
+            ++pos;
+
+        bool ok = false;
+        if (pos > begin)
+            value = QByteArray::fromRawData(begin, static_cast<int>(pos - begin)).toDouble(&ok);
+        if (!ok || !std::isfinite(value)) {
+            pos = begin;
+            return fail("expected a number");
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads a number that must be an integer
+     */
+    bool readInt(int &value)
+    {
+        double d = 0.0;
+        if (!readNumber(d))
+            return false;
+        if (d != std::floor(d) || std::fabs(d) > std::numeric_limits<int>::max())
+            return fail("expected an integer");
+        value = static_cast<int>(d);
+        return true;
+    }
+
+    /**
+     * @brief Reads true or false
+     */
+    bool readBool(bool &value)
+    {
+        skipWhitespace();
+        if (pos < end && *pos == 't') {
+            value = true;
+            return skipLiteral("true");
+        }
+        if (pos < end && *pos == 'f') {
+            value = false;
+            return skipLiteral("false");
+        }
+        return fail("expected true or false");
+    }
+
+    /**
+     * @brief Reads a string value (escapes decoded, UTF-8)
+     */
+    bool readString(QString &value)
+    {
+        QByteArray utf8;
+        if (!readRawString(&utf8))
+            return false;
+        value = QString::fromUtf8(utf8);
+        return true;
+    }
+
+    /**
+     * @brief Skips any value, including nested objects and arrays
+     */
+    bool skipValue()
+    {
+        skipWhitespace();
+        if (pos >= end)
+            return fail("unexpected end of file");
+
+        switch (*pos) {
+        case '{': {
+            ++pos;
+            bool first = true;
+            JsonKey key;
+            while (nextMember(first, key))
+                skipValue();
+            return !failed();
+        }
+        case '[': {
+            ++pos;
+            bool first = true;
+            while (nextElement(first))
+                skipValue();
+            return !failed();
+        }
+        case '"':
+            return readRawString(nullptr);
+        case 't': return skipLiteral("true");
+        case 'f': return skipLiteral("false");
+        case 'n': return skipLiteral("null");
+        default: {
+            double ignored;
+            return readNumber(ignored);
+        }
+        }
+    }
+
+    /**
+     * @brief Fails unless only whitespace remains
+     */
+    bool expectEnd()
+    {
+        skipWhitespace();
+        return pos == end || fail("trailing characters after the scenario");
+    }
+
+private:
+    void skipWhitespace()
+    {
+        while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+            ++pos;
+    }
+
+    bool consume(char c)
+    {
+        skipWhitespace();
+        if (pos < end && *pos == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool skipLiteral(const char *literal)
+    {
+        const int n = static_cast<int>(qstrlen(literal));
+        if (end - pos < n || qstrncmp(pos, literal, n) != 0)
+            return fail("unexpected character");
+        pos += n;
+        return true;
+    }
+
+    /**
+     * @brief Reads a member name without copying or unescaping it
+     */
+    bool readKey(JsonKey &key)
+    {
+        if (!expect('"'))
+            return false;
+        key.data = pos;
+        while (pos < end && *pos != '"') {
+            if (*pos == '\\')
+                ++pos;
+            ++pos;
+        }
+        if (pos >= end)
+            return fail("unterminated string");
+        key.size = static_cast<int>(pos - key.data);
+        ++pos;
+        return true;
+    }
+
+    /**
+     * @brief Reads a string, decoding escapes into out (if not null)
+     */
+    bool readRawString(QByteArray *out)
+    {
+        if (!expect('"'))
+            return false;
+        while (pos < end && *pos != '"') {
+            char c = *pos++;
+            if (c == '\\') {
+                if (pos >= end)
+                    break;
+                c = *pos++;
+                switch (c) {
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u': {
+                    bool ok = false;
+                    const ushort unit = (end - pos >= 4)
+                        ? QByteArray::fromRawData(pos, 4).toUShort(&ok, 16) : 0;
+                    if (!ok)
+                        return fail("invalid \\u escape");
+                    pos += 4;
+                    if (out)
+                        out->append(QString(QChar(unit)).toUtf8());
+                    continue;
+                }
+                default: break;               // '"', '\\' and '/' stand for themselves
+                }
+            }
+            if (out)
+                out->append(c);
+        }
+        if (pos >= end)
+            return fail("unterminated string");
+        ++pos;
+        return true;
+    }
+
+    const char *start;                ///< Beginning of the buffer (for line numbers)
+    const char *pos;                  ///< Read position
+    const char *end;                  ///< End of the buffer
+    const char *error_pos;            ///< Where the first error occurred, nullptr if none
+    QString error;                    ///< First error message
+};
+
+// ===== SCENARIO SECTIONS =====
+
+/**
+ * @brief Reads [x, y]
+ */
+bool readPoint(JsonScanner &in, QPointF &point)
+{
+    double x = 0.0, y = 0.0;
+    if (!in.expect('[') || !in.readNumber(x) || !in.expect(',')
+            || !in.readNumber(y) || !in.expect(']'))
+        return false;
+    point = QPointF(x, y);
+    return true;
+}
+
+/**
+ * @brief Reads an array of { "t", "course", "speed" } legs into legs
+ */
+bool readLegs(JsonScanner &in, int track, QVector<ManoeuvreLeg> &legs)
+{
+    if (!in.expect('['))
+        return false;
+
+    bool firstLeg = true;
+    while (in.nextElement(firstLeg)) {
+        const double unset = std::numeric_limits<double>::quiet_NaN();
+        ManoeuvreLeg leg = { unset, track, unset, unset };
+        if (!in.expect('{'))
+            return false;
+        bool first = true;
+        JsonKey key;
+        while (in.nextMember(first, key)) {
+            if (key == "t")           in.readNumber(leg.time_sec);
+            else if (key == "course") in.readNumber(leg.course);
+            else if (key == "speed")  in.readNumber(leg.speed);
+            else                      in.skipValue();
+        }
+        if (in.failed())
+            return false;
+        if (std::isnan(leg.time_sec) || std::isnan(leg.course) || std::isnan(leg.speed))
+            return in.fail("a leg needs \"t\", \"course\" and \"speed\"");
+        legs.append(leg);
+    }
+    return !in.failed();
+}
+
+bool readOwnShip(JsonScanner &in, Scenario &scenario)
+{
+    if (!in.expect('{'))
+        return false;
+    bool first = true;
+    JsonKey key;
+    while (in.nextMember(first, key)) {
+        if (key == "x")           in.readNumber(scenario.own_x);
+        else if (key == "y")      in.readNumber(scenario.own_y);
+        else if (key == "course") in.readNumber(scenario.own_course);
+        else if (key == "speed")  in.readNumber(scenario.own_speed);
+        else if (key == "depth")  in.readNumber(scenario.own_depth);
+        else if (key == "legs")   readLegs(in, -1, scenario.own_legs);
+        else                      in.skipValue();
+    }
+    return !in.failed();
+}
+
+bool readSensor(JsonScanner &in, Scenario &scenario)
+{
+    if (!in.expect('{'))
+        return false;
+    SensorModel &model = scenario.sensor_model;
+    double seed = double(model.seed);
+    bool first = true;
+    JsonKey key;
+    while (in.nextMember(first, key)) {
+        if (key == "start")              readPoint(in, scenario.sensor_start);
+        else if (key == "end")           readPoint(in, scenario.sensor_end);
+        else if (key == "bearing_sigma") in.readNumber(model.bearing_sigma_deg);
+        else if (key == "bias")          in.readNumber(model.bias_deg);
+        else if (key == "pd")            in.readNumber(model.detection_prob);
+        else if (key == "clutter")       in.readNumber(model.clutter_per_scan);
+        else if (key == "delay")         in.readNumber(model.delay_sec);
+        else if (key == "baffle")        in.readBool(model.baffle);
+        else if (key == "baffle_gap")    in.readNumber(model.baffle_gap_nm);
+        else if (key == "seed")          in.readNumber(seed);
+        else                             in.skipValue();
+    }
+    if (in.failed())
+        return false;
+
+    if (!(model.bearing_sigma_deg >= 0.0))
+        return in.fail("sensor bearing_sigma must not be negative");
+    if (!(model.detection_prob >= 0.0 && model.detection_prob <= 1.0))
+        return in.fail("sensor pd must be between 0 and 1");
+    if (!(model.clutter_per_scan >= 0.0 && model.clutter_per_scan <= 100.0))
+        return in.fail("sensor clutter must be between 0 and 100");
+    if (!(model.delay_sec >= 0.0))
+        return in.fail("sensor delay must not be negative");
+    if (!(model.baffle_gap_nm >= 0.0))
+        return in.fail("sensor baffle_gap must not be negative");
+    if (!(seed >= 0.0))
+        return in.fail("sensor seed must not be negative");
+    model.seed = quint64(seed);
+    return true;
+}
+
+/**
+ * @brief Reads the contact array straight into the TrackStore
+ *
+ * Legs may precede the position members, so they are collected in a
+ * reused buffer and added once the track exists.
+ */
+bool readContacts(JsonScanner &in, TrackStore &contacts)
+{
+    if (!in.expect('['))
+        return false;
+
+    QVector<ManoeuvreLeg> legs;
+    bool firstContact = true;
+    while (in.nextElement(firstContact)) {
+        double x = 0.0, y = 0.0, course = 0.0, speed = 0.0;
+        legs.clear();
+        if (!in.expect('{'))
+            return false;
+        bool first = true;
+        JsonKey key;
+        while (in.nextMember(first, key)) {
+            if (key == "x")           in.readNumber(x);
+            else if (key == "y")      in.readNumber(y);
+            else if (key == "course") in.readNumber(course);
+            else if (key == "speed")  in.readNumber(speed);
+            else if (key == "legs")   readLegs(in, -1, legs);
+            else                      in.skipValue();
+        }
+        if (in.failed())
+            return false;
+
+        const int track = contacts.addTrack(x, y, course, speed);
+        for (const ManoeuvreLeg &leg : legs)
+            contacts.addLeg(track, leg.time_sec, leg.course, leg.speed);
+    }
+    return !in.failed();
+}
+
+} // namespace
+
+/**
+ * @brief Loads a scenario file
+ * @param path JSON scenario file
+ * @param scenario Receives the scenario (defaults for missing members)
+ * @param error Set to a message with the line number on failure
+ * @return true on success
+ */
+bool Scenario::load(const QString &path, Scenario &scenario, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = QString("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+    const QByteArray data = file.readAll();
+
+    Scenario result;
+    JsonScanner in(data.constData(), data.constData() + data.size());
+    bool first = true;
+    JsonKey key;
+    if (in.expect('{')) {
+        while (in.nextMember(first, key)) {
+            if (key == "name")          in.readString(result.name);
+            else if (key == "own_ship") readOwnShip(in, result);
+            else if (key == "sensor")   readSensor(in, result);
+            else if (key == "adopted")  in.readInt(result.adopted_track);
+            else if (key == "contacts") readContacts(in, result.contacts);
+            else                        in.skipValue();
+        }
+        if (!in.failed())
+            in.expectEnd();
+    }
+
+    if (!in.failed() && result.contacts.size() == 0)
+        result.adopted_track = -1;
+    else if (!in.failed()
+             && (result.adopted_track < 0 || result.adopted_track >= result.contacts.size()))
+        in.fail(QString("adopted track %1 out of range").arg(result.adopted_track));
+
+    if (in.failed()) {
+        if (error)
+            *error = QString("%1: %2").arg(path, in.errorString());
+        return false;
+    }
+
+    scenario = result;
+    return true;
+}
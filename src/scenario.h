@@ -0,0 +1,83 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <QPointF>
+#include <QString>
+#include <QVector>
+#include "measurementgen.h"
+#include "trackstore.h"
+
+/**
+ * @brief Scenario - Initial conditions of a simulation run
+ *
+ * Own ship, contacts with their manoeuvre legs, the sensor beam
+ * geometry and the sensor error model. Contacts are loaded straight
+ * into a TrackStore. Simulation shares its arrays at first; the ones a
+ * step writes are copied once, when TrackStore::advance() detaches them.
+ *
+ * File format (JSON, all members optional, units as in TrackStore):
+ * @code
+ * {
+ *   "name": "Default",
+ *   "sensor":   { "start": [80, 480], "end": [720, 80],
+ *                 "bearing_sigma": 0.5, "bias": 0.1, "pd": 0.9,
+ *                 "clutter": 2, "delay": 4, "seed": 7,
+ *                 "baffle": true, "baffle_gap": 0.5 },
+ *   "own_ship": { "x": 0, "y": 0, "course": 0, "speed": 10, "depth": 40,
+ *                 "legs": [ { "t": 600, "course": 90, "speed": 12 } ] },
+ *   "adopted":  0,
+ *   "contacts": [
+ *     { "x": 3, "y": 3, "course": 90, "speed": 8,
+ *       "legs": [ { "t": 1200, "course": 180, "speed": 6 } ] }
+ *   ]
+ * }
+ * @endcode
+ * Sensor points are widget coordinates (pixels); leg times "t" are
+ * simulation seconds. The sensor error members (degrees, detection
+ * probability, false bearings per scan, seconds) default to a perfect
+ * sensor, see SensorModel. With "baffle" the sensor detects nothing
+ * beyond "baffle_gap" nm on the shaded side of its line, as drawn.
+ * Unknown members are skipped.
+ */
+struct Scenario
+{
+    QString name;                     ///< Free-form scenario name
+
+    // ===== OWN SHIP =====
+    double own_x = 0.0;               ///< Own ship X position at time zero (nm)
+    double own_y = 0.0;               ///< Own ship Y position at time zero (nm)
+    double own_course = 0.0;          ///< Own ship course over ground (degrees)
+    double own_speed = 10.0;          ///< Own ship speed over ground (knots)
+    double own_depth = 40.0;          ///< Own ship depth (meters)
+    QVector<ManoeuvreLeg> own_legs;   ///< Own ship legs (track field unused)
+
+    // ===== SENSOR =====
+    QPointF sensor_start = QPointF(80, 480); ///< Sensor beam start (widget coordinates)
+    QPointF sensor_end = QPointF(720, 80);   ///< Sensor beam end (widget coordinates)
+    SensorModel sensor_model;         ///< Bearing measurement errors
+
+    // ===== CONTACTS =====
+    TrackStore contacts;              ///< Contacts and their legs
+    int adopted_track = 0;            ///< Contact shown as the adopted target
+
+    /**
+     * @brief The built-in scenario: one target at (3,3) nm heading East at 8 knots
+     */
+    static Scenario defaultScenario();
+
+    /**
+     * @brief Loads a scenario file
+     *
+     * The file is read in one go and parsed in a single forward pass that
+     * writes contacts straight into the TrackStore; no document tree is
+     * built.
+     *
+     * @param path JSON scenario file
+     * @param scenario Receives the scenario (defaults for missing members)
+     * @param error Set to a message with the line number on failure
+     * @return true on success
+     */
+    static bool load(const QString &path, Scenario &scenario, QString *error = nullptr);
+};
+
+#endif // SCENARIO_H
@@ -0,0 +1,99 @@
+#include "simhost.h"
+#include "simworker.h"
+
+/**
+ * @brief Constructor - creates the worker and starts the simulation thread
+ *
+ * The worker is moved onto its own thread; its signals are queued to the
+ * thread this host lives on (the GUI thread).
+ *
+ * @param scenario Scenario to simulate
+ * @param parent Parent object
+ */
+SimHost::SimHost(const Scenario &scenario, QObject *parent)
+    : QObject(parent),
+      worker(new SimWorker(scenario, &snapshots))
+{
+    connect(worker, &SimWorker::snapshotPublished, this, &SimHost::snapshotPublished);
+    connect(worker, &SimWorker::replayOpened, this, &SimHost::replayOpened);
+
+    // Run the simulation on its own thread
+    worker->moveToThread(&sim_thread);
+    connect(&sim_thread, &QThread::started, worker, &SimWorker::start);
+    connect(&sim_thread, &QThread::finished, worker, &QObject::deleteLater);
+
+    sim_thread.setObjectName("TSA simulation");
+    sim_thread.start();
+}
+
+/**
+ * @brief Destructor - stops the simulation thread
+ *
+ * The worker is deleted on its own thread via deleteLater() when the
+ * thread's event loop finishes.
+ */
+SimHost::~SimHost()
+{
+    QMetaObject::invokeMethod(worker, "stop", Qt::BlockingQueuedConnection);
+    sim_thread.quit();
+    sim_thread.wait();
+}
+
+/**
+ * @brief Sets the fixed simulation step on the simulation thread
+ * @param step_sec Step in seconds
+ */
+void SimHost::setStep(double step_sec)
+{
+    QMetaObject::invokeMethod(worker, "setStep", Qt::QueuedConnection,
+                              Q_ARG(double, step_sec));
+}
+
+/**
+ * @brief Records every simulation step to a binary file
+ * @param path Recording file (truncated)
+ */
+void SimHost::startRecording(const QString &path)
+{
+    QMetaObject::invokeMethod(worker, "startRecording", Qt::QueuedConnection,
+                              Q_ARG(QString, path));
+}
+
+/**
+ * @brief Shows a recording instead of the live simulation
+ * @param path Recording file
+ */
+void SimHost::startReplay(const QString &path)
+{
+    QMetaObject::invokeMethod(worker, "startReplay", Qt::QueuedConnection,
+                              Q_ARG(QString, path));
+}
+
+/**
+ * @brief Jumps the replay to the given simulation time
+ * @param time_sec Simulation time (seconds)
+ */
+void SimHost::seekReplay(double time_sec)
+{
+    QMetaObject::invokeMethod(worker, "seekReplay", Qt::QueuedConnection,
+                              Q_ARG(double, time_sec));
+}
+
+/**
+ * @brief Requests a coalesced replay seek (safe from any thread)
+ * @param time_sec Simulation time (seconds)
+ */
+void SimHost::requestReplaySeek(double time_sec)
+{
+    worker->requestReplaySeek(time_sec);
+}
+
+/**
+ * @brief Holds or resumes replay playback on the simulation thread
+ * @param paused true to hold the current tick
+ */
+void SimHost::setReplayPaused(bool paused)
+{
+    QMetaObject::invokeMethod(worker, "setReplayPaused", Qt::QueuedConnection,
+                              Q_ARG(bool, paused));
+}
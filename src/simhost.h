@@ -0,0 +1,77 @@
+#ifndef SIMHOST_H
+#define SIMHOST_H
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include "simulation.h"
+#include "triplebuffer.h"
+
+class SimWorker;
+
+/**
+ * @brief SimHost - Simulation thread, its SimWorker and the snapshot handoff
+ *
+ * Shared by the display widgets: starts a SimWorker on its own thread,
+ * forwards the control calls to it as queued invocations and hands the
+ * published snapshots to the GUI thread through a TripleBuffer. Signals
+ * are re-emitted on the GUI thread.
+ */
+class SimHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Creates the worker for a scenario and starts its thread
+     * @param scenario Scenario to simulate
+     * @param parent Parent object (the display widget)
+     */
+    explicit SimHost(const Scenario &scenario, QObject *parent = nullptr);
+
+    /**
+     * @brief Stops the simulation thread and waits for it to finish
+     */
+    ~SimHost() override;
+
+    /**
+     * @brief Takes the newest published snapshot (GUI thread)
+     * @return true if a new snapshot was picked up since the last call
+     */
+    bool takeSnapshot() { return snapshots.update(); }
+
+    /**
+     * @brief Snapshot picked up by the last takeSnapshot()
+     */
+    const SimSnapshot &snapshot() const { return snapshots.readBuffer(); }
+
+    // ===== CONTROL (FORWARDED TO THE SIMULATION THREAD) =====
+
+    void setStep(double step_sec);                  ///< Fixed simulation step (seconds)
+    void startRecording(const QString &path);       ///< Record every step (file truncated)
+    void startReplay(const QString &path);          ///< Show a recording instead
+    void seekReplay(double time_sec);               ///< Jump the replay to a time
+    void requestReplaySeek(double time_sec);        ///< Coalesced seek (slider drags)
+    void setReplayPaused(bool paused);              ///< Hold or resume playback
+
+signals:
+    /**
+     * @brief A new snapshot is ready for takeSnapshot()
+     */
+    void snapshotPublished();
+
+    /**
+     * @brief A recording was opened for replay
+     * @param start_sec Time of the first tick
+     * @param end_sec Time of the last tick
+     * @param step_sec Recorded step
+     */
+    void replayOpened(double start_sec, double end_sec, double step_sec);
+
+private:
+    TripleBuffer<SimSnapshot> snapshots;  ///< Lock-free handoff from sim_thread
+    QThread sim_thread;               ///< Thread running the simulation
+    SimWorker *worker;                ///< Simulation driver living on sim_thread (publishes on construction)
+};
+
+#endif // SIMHOST_H
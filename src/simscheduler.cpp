@@ -0,0 +1,83 @@
+#include "simscheduler.h"
+
+constexpr double SimScheduler::kMinStepSec;
+
+/**
+ * @brief Constructor - sets the step and catch-up bound, clock not started
+ * @param step_sec Simulation step in seconds
+ * @param max_catch_up Maximum steps released per stepsDue() call
+ */
+SimScheduler::SimScheduler(double step_sec, int max_catch_up)
+    : step_ns(0),
+      last_ns(0),
+      backlog_ns(0),
+      max_catch_up(qMax(1, max_catch_up)),
+      dropped_steps(0)
+{
+    setStep(step_sec);
+}
+
+/**
+ * @brief Starts (or restarts) the monotonic clock with an empty backlog
+ */
+void SimScheduler::start()
+{
+    clock.start();
+    last_ns = 0;
+    backlog_ns = 0;
+}
+
+/**
+ * @brief Returns the number of whole steps due since the last call
+ *
+ * Time is kept in integer nanoseconds so the fractional remainder carries
+ * over exactly between calls and the simulation does not drift against
+ * wall time.
+ *
+ * @return Number of simulation steps to run now
+ */
+int SimScheduler::stepsDue()
+{
+    if (!clock.isValid())
+        start();
+
+    const qint64 now_ns = clock.nsecsElapsed();
+    backlog_ns += now_ns - last_ns;
+    last_ns = now_ns;
+
+    qint64 due = backlog_ns / step_ns;
+    backlog_ns -= due * step_ns;
+
+    if (due > max_catch_up) {
+        dropped_steps += due - max_catch_up;
+        due = max_catch_up;
+    }
+    return static_cast<int>(due);
+}
+
+/**
+ * @brief Changes the simulation step; the pending backlog is kept
+ * @param step_sec New step in seconds
+ */
+void SimScheduler::setStep(double step_sec)
+{
+    step_ns = qRound64(qMax(step_sec, kMinStepSec) * 1e9);
+}
+
+/**
+ * @brief Changes the catch-up bound
+ * @param max_steps Maximum steps per stepsDue() call
+ */
+void SimScheduler::setMaxCatchUpSteps(int max_steps)
+{
+    max_catch_up = qMax(1, max_steps);
+}
+
+/**
+ * @brief Suggested wake-up interval for the driving QTimer
+ * @return Step length in whole milliseconds (at least 1)
+ */
+int SimScheduler::timerIntervalMs() const
+{
+    return qMax(1, static_cast<int>(step_ns / 1000000));
+}
@@ -0,0 +1,78 @@
+#ifndef SIMSCHEDULER_H
+#define SIMSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+/**
+ * @brief SimScheduler - Fixed-step simulation clock driven by a monotonic timer
+ *
+ * Decouples simulated time from the QTimer that wakes the simulation up.
+ * Wall time measured with QElapsedTimer is accumulated and converted into
+ * a whole number of fixed simulation steps; a late wake-up therefore
+ * produces several steps instead of silently losing time.
+ *
+ * Catch-up is bounded: at most maxCatchUpSteps() steps are released per
+ * call. Any backlog beyond that (for example after the process was
+ * suspended) is dropped and counted in droppedSteps(), so a long stall
+ * cannot trigger an unbounded burst of work.
+ */
+class SimScheduler
+{
+public:
+    static constexpr double kMinStepSec = 0.010;   ///< Smallest supported step (10 ms)
+
+    /**
+     * @brief Constructs a scheduler
+     * @param step_sec Simulation step in seconds (clamped to kMinStepSec)
+     * @param max_catch_up Maximum steps released per stepsDue() call
+     */
+    explicit SimScheduler(double step_sec = 2.0, int max_catch_up = 8);
+
+    /**
+     * @brief Starts (or restarts) the monotonic clock with an empty backlog
+     */
+    void start();
+
+    /**
+     * @brief Returns the number of whole steps due since the last call
+     *
+     * Consumes the corresponding wall time from the accumulator. The result
+     * never exceeds maxCatchUpSteps(); excess backlog is dropped.
+     *
+     * @return Number of simulation steps to run now
+     */
+    int stepsDue();
+
+    /**
+     * @brief Changes the simulation step; the pending backlog is kept
+     * @param step_sec New step in seconds (clamped to kMinStepSec)
+     */
+    void setStep(double step_sec);
+
+    /**
+     * @brief Changes the catch-up bound
+     * @param max_steps Maximum steps per stepsDue() call (at least 1)
+     */
+    void setMaxCatchUpSteps(int max_steps);
+
+    double step() const { return step_ns * 1e-9; }             ///< Step (seconds)
+    int maxCatchUpSteps() const { return max_catch_up; }         ///< Catch-up bound
+    qint64 droppedSteps() const { return dropped_steps; }        ///< Steps dropped so far
+
+    /**
+     * @brief Suggested wake-up interval for the driving QTimer
+     * @return Step length in whole milliseconds (at least 1)
+     */
+    int timerIntervalMs() const;
+
+private:
+    QElapsedTimer clock;              ///< Monotonic wall clock
+    qint64 step_ns;                   ///< Simulation step (nanoseconds)
+    qint64 last_ns;                   ///< Clock reading at the previous call
+    qint64 backlog_ns;                ///< Wall time not yet turned into steps
+    int max_catch_up;                 ///< Maximum steps released per call
+    qint64 dropped_steps;             ///< Steps discarded by the catch-up bound
+};
+
+#endif // SIMSCHEDULER_H
@@ -0,0 +1,320 @@
+#include "simulation.h"
+#include "halfplanekernel.h"
+#include "perfstats.h"
+#include <QtMath>
+#include <algorithm>
+
+/**
+ * @brief Copies a track array into a snapshot array without reallocating
+ *
+ * resize() only allocates when the track count grows; the snapshot
+ * arrays are never shared, so data() does not detach.
+ */
+static void copyTrackArray(QVector<double> &dst, const double *src, int count)
+{
+    dst.resize(count);
+    std::copy(src, src + count, dst.data());
+}
+
+/**
+ * @brief Rebuilds the spatial index from the relative positions
+ *
+ * The grid is rebuilt from scratch every tick (every contact moves);
+ * max_speed lets the renderer widen its culling rectangle by the
+ * longest velocity leader.
+ */
+void SimSnapshot::buildIndex()
+{
+    const int n = trackCount();
+    grid.build(rel_x.constData(), rel_y.constData(), n);
+    max_speed = n > 0 ? *std::max_element(speed.constBegin(), speed.constEnd()) : 0.0;
+}
+
+/**
+ * @brief Constructor - sets up the default scenario
+ *
+ * One adopted target starting at (3,3) nm, heading East at 8 knots.
+ */
+Simulation::Simulation()
+    : Simulation(Scenario::defaultScenario())
+{
+}
+
+/**
+ * @brief Constructor - starts the given scenario at time zero
+ * @param scenario Own ship, contacts and legs to simulate
+ */
+Simulation::Simulation(const Scenario &scenario)
+    : current_time_sec(0.0),
+      tick_count(0),
+      own_x(scenario.own_x),
+      own_y(scenario.own_y),
+      current_bearing(45.0),
+      current_range(0.0),
+      current_bearing_rate(0.0),
+      own_course(0.0),
+      own_speed(0.0),
+      own_depth(scenario.own_depth),
+      own_start_x(scenario.own_x),
+      own_start_y(scenario.own_y),
+      own_vel_x(0.0),
+      own_vel_y(0.0),
+      own_legs(scenario.own_legs),
+      next_own_leg(0),
+      tracks(scenario.contacts),
+      adopted_track(scenario.adopted_track),
+      tracking_enabled(true),
+      sensor(scenario.sensor_model),
+      measurements(scenario.sensor_model.delay_sec),
+      baffle_dx(scenario.sensor_end.x() - scenario.sensor_start.x()),
+      baffle_dy(scenario.sensor_start.y() - scenario.sensor_end.y())   // widget Y points down
+{
+    if (scenario.sensor_model.bearing_sigma_deg > 0.0)
+        ekf.setBearingSigma(scenario.sensor_model.bearing_sigma_deg);
+
+    // Trackers cover every contact from the start: with a sensor delay the
+    // first snapshots are taken before any scan has reached them
+    tma_estimator.resize(tracks.size());
+    ekf.resize(tracks.size());
+    setOwnLeg(0.0, scenario.own_course, scenario.own_speed);
+    std::stable_sort(own_legs.begin(), own_legs.end(),
+                     [](const ManoeuvreLeg &a, const ManoeuvreLeg &b) {
+                         return a.time_sec < b.time_sec;
+                     });
+
+    // Calculate initial target position relative to own ship
+    calculateTargetPosition(0.0);
+}
+
+/**
+ * @brief Advances the simulation by one step
+ * @param dt_sec Step length in seconds
+ */
+void Simulation::step(double dt_sec)
+{
+    PERF_SCOPE(PerfSection::SimStep);
+
+    // Advance simulation time
+    current_time_sec += dt_sec;
+    ++tick_count;
+
+    // Advance all tracks and update measurements and bearing rates
+    calculateTargetPosition(dt_sec);
+}
+
+/**
+ * @brief Advances all tracks based on movement over time
+ *
+ * Moves own ship along its current leg and advances every contact in the
+ * track store and, with tracking on, generates a sensor scan of the new
+ * bearings. Scans whose delay has passed go to the trackers; the adopted
+ * track's true measurements are mirrored into the display state.
+ *
+ * @param dt_sec Time elapsed since the previous update (seconds)
+ */
+void Simulation::calculateTargetPosition(double dt_sec)
+{
+    // Own ship manoeuvres that have started
+    while (next_own_leg < own_legs.size()
+           && own_legs[next_own_leg].time_sec <= current_time_sec) {
+        const ManoeuvreLeg &leg = own_legs[next_own_leg++];
+        setOwnLeg(leg.time_sec, leg.course, leg.speed);
+    }
+
+    double t = current_time_sec / 3600.0; // Convert seconds to hours
+
+    // Own ship movement along its course
+    own_x = own_start_x + own_vel_x * t;
+    own_y = own_start_y + own_vel_y * t;
+
+    // Advance every contact relative to own ship in one pass
+    tracks.advance(current_time_sec, own_x, own_y, dt_sec);
+
+    // One sensor scan of the true bearings, delivered after the sensor delay
+    if (tracking_enabled) {
+        {
+            PERF_SCOPE(PerfSection::Sensor);
+            const quint64 *gate = sensor.model().baffle ? classifyBaffle() : nullptr;
+            sensor.generate(current_time_sec, own_x, own_y, tracks.bearingData(),
+                            tracks.size(), measurements.push(), gate);
+        }
+        while (const MeasurementBatch *batch = measurements.ready(current_time_sec)) {
+            trackScan(*batch);
+            measurements.pop();
+        }
+    }
+
+    // Update current measurements from the adopted track
+    if (adopted_track >= 0) {
+        current_range        = tracks.range(adopted_track);
+        current_bearing      = tracks.bearing(adopted_track);
+        current_bearing_rate = tracks.bearingRate(adopted_track);
+    }
+}
+
+/**
+ * @brief Feeds one delivered scan to the TMA estimator and the Kalman filters
+ *
+ * Detections are scattered into per-track arrays; clutter is dropped,
+ * since the trackers are associated by track index. A scan that detected
+ * every track takes the TMA estimator's shared-fade batch update,
+ * otherwise the detected bearings are added one by one and every track
+ * is solved again. The Kalman filters skip undetected tracks through the
+ * validity mask.
+ *
+ * @param batch Scan whose delay has passed
+ */
+void Simulation::trackScan(const MeasurementBatch &batch)
+{
+    const int n = tracks.size();
+    scan_valid.fill(0, n);
+    scan_bearing.resize(n);            // undetected entries keep a finite old bearing
+    for (int k = 0; k < batch.detections; ++k) {
+        const int i = batch.track[k];
+        scan_bearing[i] = batch.bearing[k];
+        scan_valid[i] = 1;
+    }
+
+    // Bearings-only solution from the bearing history (O(1) per track)
+    {
+        PERF_SCOPE(PerfSection::Tma);
+        if (batch.detections == n) {
+            tma_estimator.update(batch.time_sec, batch.own_x, batch.own_y,
+                                 scan_bearing.constData(), n);
+        } else {
+            if (tma_estimator.size() != n)
+                tma_estimator.resize(n);
+            for (int k = 0; k < batch.detections; ++k)
+                tma_estimator.addBearing(batch.track[k], batch.time_sec,
+                                         batch.own_x, batch.own_y, batch.bearing[k]);
+            for (int i = 0; i < n; ++i)
+                tma_estimator.solve(i, batch.time_sec, batch.own_x, batch.own_y);
+        }
+    }
+    {
+        PERF_SCOPE(PerfSection::Ekf);
+        ekf.predict(batch.time_sec);
+        ekf.update(batch.own_x, batch.own_y, scan_bearing.constData(), scan_valid.constData(), n);
+    }
+}
+
+/**
+ * @brief Marks the contacts in the sensor baffle
+ *
+ * The baffle is the display's shaded region in relative nautical miles:
+ * beyond baffle_gap_nm of the sensor line through own ship, on the side
+ * away from own ship's motion. With own ship stopped or moving along
+ * the line it is the right side of the line from the scenario's sensor
+ * start to end, the side TSARenderer::computeBeamGeometry() shades then.
+ * All contacts are classified in one batch.
+ *
+ * @return Bit per track (baffle_mask), set where the track cannot be detected
+ */
+const quint64 *Simulation::classifyBaffle()
+{
+    const int n = tracks.size();
+    baffle_mask.resize(halfPlaneMaskWords(n));
+
+    // Left of the line means a positive cross product; flip the line to
+    // shade its right side unless own ship moves to the right of it
+    const double side = baffle_dx * own_vel_y - baffle_dy * own_vel_x >= 0.0 ? -1.0 : 1.0;
+    classifyHalfPlaneBatch(tracks.relativeXData(), tracks.relativeYData(), n, 0.0, 0.0,
+                           side * baffle_dx, side * baffle_dy, sensor.model().baffle_gap_nm,
+                           baffle_mask.data());
+    return baffle_mask.constData();
+}
+
+/**
+ * @brief Sets own ship course and speed, keeping its current position
+ *
+ * Same re-basing as TrackStore legs: the position at time_sec is kept and
+ * the time-zero origin is moved so that position = start + velocity * t.
+ *
+ * @param time_sec Time of the change (seconds)
+ * @param course New course over ground (degrees)
+ * @param speed New speed over ground (knots)
+ */
+void Simulation::setOwnLeg(double time_sec, double course, double speed)
+{
+    const double t = time_sec / 3600.0;
+    const double x = own_start_x + own_vel_x * t;
+    const double y = own_start_y + own_vel_y * t;
+
+    own_course = course;
+    own_speed = speed;
+    own_vel_x = speed * qSin(qDegreesToRadians(course));
+    own_vel_y = speed * qCos(qDegreesToRadians(course));
+    own_start_x = x - own_vel_x * t;
+    own_start_y = y - own_vel_y * t;
+}
+
+/**
+ * @brief Copies the current state into a snapshot
+ * @param snap Snapshot to fill; its arrays are resized in place
+ */
+void Simulation::fillSnapshot(SimSnapshot &snap) const
+{
+    snap.tick       = tick_count;
+    snap.time_sec   = current_time_sec;
+    snap.own_x      = own_x;
+    snap.own_y      = own_y;
+    snap.own_course = own_course;
+    snap.own_speed  = own_speed;
+
+    snap.adopted_track = adopted_track;
+    snap.bearing       = current_bearing;
+    snap.range         = current_range;
+    snap.bearing_rate  = current_bearing_rate;
+
+    const int n = tracks.size();
+    Q_ASSERT(tma_estimator.size() == n && ekf.size() == n);
+    copyTrackArray(snap.rel_x,         tracks.relativeXData(),  n);
+    copyTrackArray(snap.rel_y,         tracks.relativeYData(),  n);
+    copyTrackArray(snap.course,        tracks.courseData(),     n);
+    copyTrackArray(snap.speed,         tracks.speedData(),      n);
+    copyTrackArray(snap.track_bearing, tracks.bearingData(),    n);
+    copyTrackArray(snap.track_range,   tracks.rangeData(),      n);
+    copyTrackArray(snap.track_rate,    tracks.bearingRateData(),n);
+
+    snap.tma_solved.resize(n);
+    std::copy(tma_estimator.solvedData(), tma_estimator.solvedData() + n, snap.tma_solved.data());
+    copyTrackArray(snap.tma_range,     tma_estimator.rangeData(),  n);
+    copyTrackArray(snap.tma_course,    tma_estimator.courseData(), n);
+    copyTrackArray(snap.tma_speed,     tma_estimator.speedData(),  n);
+
+    snap.ekf_valid.resize(n);
+    snap.ekf_course.resize(n);
+    snap.ekf_speed.resize(n);
+    const double *vx = ekf.velocityXData();
+    const double *vy = ekf.velocityYData();
+    for (int i = 0; i < n; ++i) {
+        snap.ekf_valid[i] = ekf.initializedData()[i];
+        snap.ekf_course[i] = calculateBearing(vx[i], vy[i]);
+        snap.ekf_speed[i] = calculateRange(vx[i], vy[i]);
+    }
+
+    snap.buildIndex();
+}
+
+/**
+ * @brief Calculates range (distance) from origin to given coordinates
+ * @param x X coordinate in nautical miles
+ * @param y Y coordinate in nautical miles
+ * @return Range in nautical miles
+ */
+double Simulation::calculateRange(double x, double y)
+{
+    return qSqrt(x*x + y*y);  // Pythagorean theorem
+}
+
+/**
+ * @brief Calculates bearing (direction) from origin to given coordinates
+ * @param x X coordinate in nautical miles
+ * @param y Y coordinate in nautical miles
+ * @return Bearing in degrees (0-360°)
+ */
+double Simulation::calculateBearing(double x, double y)
+{
+    double b = qRadiansToDegrees(qAtan2(x, y));
+    return (b < 0.0 ? b + 360.0 : b);  // Normalize to 0-360°
+}
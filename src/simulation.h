@@ -0,0 +1,223 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <QVector>
+#include <QtGlobal>
+#include "ekftracker.h"
+#include "measurementgen.h"
+#include "scenario.h"
+#include "spatialgrid.h"
+#include "tmaestimator.h"
+#include "trackstore.h"
+
+/**
+ * @brief SimSnapshot - Immutable copy of the simulation state for rendering
+ *
+ * Filled by Simulation::fillSnapshot() on the simulation thread and handed
+ * to the GUI through a TripleBuffer. The per-track arrays mirror the
+ * TrackStore layout; they are resized in place, so a reused snapshot does
+ * not reallocate once it has reached the track count. Both producers
+ * (Simulation and RecordingReader) finish with buildIndex(), so the
+ * spatial index is built on the simulation thread, not while painting.
+ */
+struct SimSnapshot
+{
+    quint64 tick = 0;                 ///< Number of steps simulated
+    double time_sec = 0.0;            ///< Simulation time (seconds)
+
+    // ===== OWN SHIP =====
+    double own_x = 0.0;               ///< Own ship X position (nm)
+    double own_y = 0.0;               ///< Own ship Y position (nm)
+    double own_course = 0.0;          ///< Own ship course (degrees)
+    double own_speed = 0.0;           ///< Own ship speed (knots)
+
+    // ===== ADOPTED TRACK =====
+    int adopted_track = -1;           ///< Index of the adopted track, -1 if none
+    double bearing = 0.0;             ///< Adopted track bearing (degrees)
+    double range = 0.0;               ///< Adopted track range (nm)
+    double bearing_rate = 0.0;        ///< Adopted track bearing rate (deg/s)
+
+    // ===== ALL TRACKS =====
+    QVector<double> rel_x;            ///< X relative to own ship (nm)
+    QVector<double> rel_y;            ///< Y relative to own ship (nm)
+    QVector<double> course;           ///< Course (degrees)
+    QVector<double> speed;            ///< Speed (knots)
+    QVector<double> track_bearing;    ///< Bearing (degrees)
+    QVector<double> track_range;      ///< Range (nm)
+    QVector<double> track_rate;       ///< Bearing rate (deg/s)
+
+    // ===== TMA ESTIMATES (empty in replays) =====
+    QVector<quint8> tma_solved;       ///< 1 where the bearings-only solution is valid
+    QVector<double> tma_range;        ///< Estimated range (nm)
+    QVector<double> tma_course;       ///< Estimated course (degrees)
+    QVector<double> tma_speed;        ///< Estimated speed (knots)
+
+    // ===== FILTER ESTIMATES (empty in replays) =====
+    QVector<quint8> ekf_valid;        ///< 1 where the Kalman filter has started
+    QVector<double> ekf_course;       ///< Filtered course (degrees)
+    QVector<double> ekf_speed;        ///< Filtered speed (knots)
+
+    // ===== SPATIAL INDEX (built by buildIndex()) =====
+    SpatialGrid grid;                 ///< Uniform grid over (rel_x, rel_y)
+    double max_speed = 0.0;           ///< Highest track speed (knots), bounds the leader length
+
+    int trackCount() const { return rel_x.size(); }
+
+    /**
+     * @brief Rebuilds the spatial index from the relative positions
+     */
+    void buildIndex();
+};
+
+/**
+ * @brief Simulation - Own ship and contact kinematics, independent of the GUI
+ *
+ * Owns the own-ship parameters and the TrackStore, both initialized from a
+ * Scenario, and advances them in fixed steps. The trackers (TMA and
+ * Kalman filter) see the contacts only through the sensor model: every
+ * step is one scan of generated measurements, delivered after the sensor
+ * delay, so their estimates refer to the time of the latest delivered
+ * scan. Has no timers and no thread affinity: SimWorker drives it
+ * on a worker thread, other drivers may step it directly.
+ */
+class Simulation
+{
+public:
+    /**
+     * @brief Constructs the default scenario (one target at (3,3) nm)
+     */
+    Simulation();
+
+    /**
+     * @brief Constructs a simulation at time zero of the given scenario
+     * @param scenario Own ship, contacts and legs to simulate
+     */
+    explicit Simulation(const Scenario &scenario);
+
+    /**
+     * @brief Advances the simulation by one step
+     * @param dt_sec Step length in seconds
+     */
+    void step(double dt_sec);
+
+    /**
+     * @brief Turns the sensor and the trackers on or off
+     *
+     * With tracking off a step only moves own ship and the contacts: no
+     * sensor scan is generated and the TMA estimator and Kalman filters
+     * keep their last estimates. For drivers that only need the true
+     * kinematics, such as the batch mode. On by default.
+     *
+     * @param enabled true to generate scans and update the trackers
+     */
+    void setTrackingEnabled(bool enabled) { tracking_enabled = enabled; }
+    bool trackingEnabled() const { return tracking_enabled; } ///< Sensor and trackers run every step
+
+    /**
+     * @brief Copies the current state into a snapshot
+     * @param snap Snapshot to fill; its arrays are resized in place
+     */
+    void fillSnapshot(SimSnapshot &snap) const;
+
+    double time() const { return current_time_sec; }      ///< Simulation time (s)
+    quint64 tick() const { return tick_count; }            ///< Steps simulated
+    const TrackStore &trackStore() const { return tracks; }///< All contacts
+    const TmaEstimator &tma() const { return tma_estimator; } ///< Bearings-only estimates
+    const EkfTracker &tracker() const { return ekf; }      ///< Kalman filter estimates
+    const MeasurementGenerator &measurementGenerator() const { return sensor; } ///< Sensor measurements
+    int adoptedTrack() const { return adopted_track; }     ///< Adopted track index
+    double bearing() const { return current_bearing; }     ///< Adopted bearing (deg)
+    double range() const { return current_range; }         ///< Adopted range (nm)
+    double bearingRate() const { return current_bearing_rate; } ///< Adopted rate (deg/s)
+    double ownX() const { return own_x; }                   ///< Own ship X (nm)
+    double ownY() const { return own_y; }                   ///< Own ship Y (nm)
+    double ownCourse() const { return own_course; }         ///< Own ship course (deg)
+    double ownSpeed() const { return own_speed; }           ///< Own ship speed (kn)
+    double ownDepth() const { return own_depth; }           ///< Own ship depth (m)
+
+    /**
+     * @brief Calculates range from origin to given coordinates
+     * @param x X coordinate (nautical miles)
+     * @param y Y coordinate (nautical miles)
+     * @return Range in nautical miles
+     */
+    static double calculateRange(double x, double y);
+
+    /**
+     * @brief Calculates bearing from origin to given coordinates
+     * @param x X coordinate (nautical miles)
+     * @param y Y coordinate (nautical miles)
+     * @return Bearing in degrees (0-360°)
+     */
+    static double calculateBearing(double x, double y);
+
+private:
+    /**
+     * @brief Advances all tracks to the current simulation time
+     *
+     * Moves own ship, advances every contact in the track store in one
+     * pass and mirrors the adopted track into current_bearing,
+     * current_range and current_bearing_rate. With tracking on it also
+     * generates a sensor scan and hands due scans to trackScan().
+     *
+     * @param dt_sec Time elapsed since the previous update (seconds)
+     */
+    void calculateTargetPosition(double dt_sec);
+
+    /**
+     * @brief Feeds one delivered scan to the TMA estimator and the Kalman filters
+     * @param batch Scan whose delay has passed
+     */
+    void trackScan(const MeasurementBatch &batch);
+
+    /**
+     * @brief Marks the contacts in the sensor baffle
+     * @return Bit per track (baffle_mask), set where the track cannot be detected
+     */
+    const quint64 *classifyBaffle();
+
+    /**
+     * @brief Sets own ship course and speed, keeping its current position
+     * @param time_sec Time of the change (seconds)
+     * @param course New course over ground (degrees)
+     * @param speed New speed over ground (knots)
+     */
+    void setOwnLeg(double time_sec, double course, double speed);
+
+    double current_time_sec;          ///< Current simulation time in seconds
+    quint64 tick_count;               ///< Steps simulated so far
+    double own_x;                     ///< Own ship X position (nautical miles)
+    double own_y;                     ///< Own ship Y position (nautical miles)
+    double current_bearing;           ///< Current target bearing in degrees
+    double current_range;             ///< Current target range in nautical miles
+    double current_bearing_rate;      ///< Current bearing rate in degrees/second
+
+    // ===== OWN-SHIP PARAMETERS (CURRENT LEG) =====
+    double own_course;                ///< Own ship course over ground (degrees)
+    double own_speed;                 ///< Own ship speed over ground (knots)
+    double own_depth;                 ///< Own ship depth (meters)
+    double own_start_x;               ///< X extrapolated back to time zero on the current leg (nm)
+    double own_start_y;               ///< Y extrapolated back to time zero on the current leg (nm)
+    double own_vel_x;                 ///< Eastward velocity (nm/hour)
+    double own_vel_y;                 ///< Northward velocity (nm/hour)
+    QVector<ManoeuvreLeg> own_legs;   ///< Own ship legs sorted by time
+    int next_own_leg;                 ///< First own ship leg not applied yet
+
+    // ===== TARGET SIMULATION PARAMETERS =====
+    TrackStore tracks;                ///< All simulated contacts
+    int adopted_track;                ///< Track shown as the adopted target
+    TmaEstimator tma_estimator;       ///< Range, course and speed from the bearing history
+    EkfTracker ekf;                   ///< Per-track Kalman filter on the bearings
+
+    // ===== SENSOR =====
+    bool tracking_enabled;            ///< Generate scans and update the trackers every step
+    MeasurementGenerator sensor;      ///< Noisy, incomplete bearings from the true contacts
+    MeasurementQueue measurements;    ///< Scans waiting for the sensor delay
+    QVector<double> scan_bearing;     ///< Delivered scan scattered per track (degrees)
+    QVector<quint8> scan_valid;       ///< 1 where the delivered scan detected the track
+    double baffle_dx;                 ///< Sensor line direction, east (scenario start to end)
+    double baffle_dy;                 ///< Sensor line direction, north
+    QVector<quint64> baffle_mask;     ///< Tracks in the baffle this scan (halfplanekernel.h)
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,237 @@
+#include "simworker.h"
+#include "eventlog.h"
+#include <QDebug>
+
+static const LogEventFormat kSimTickEvent =
+    { "sim.tick", 6, { "time", "steps", "tracks", "bearing", "range", "rate" } };
+static const LogEventFormat kReplaySeekEvent = { "replay.seek", 1, { "time" } };
+static const LogEventFormat kReplayEndEvent = { "replay.end", 1, { "time" } };
+
+/**
+ * @brief Constructor - prepares the simulation, no timer yet
+ *
+ * The initial state is published immediately so the GUI has a complete
+ * snapshot before the first step runs.
+ *
+ * @param scenario Scenario to simulate
+ * @param output Triple buffer the snapshots are published to
+ * @param parent Parent object
+ */
+SimWorker::SimWorker(const Scenario &scenario, TripleBuffer<SimSnapshot> *output,
+                     QObject *parent)
+    : QObject(parent),
+      simulation(scenario),
+      scheduler(2.0),
+      timer(nullptr),
+      snapshots(output),
+      recorder(nullptr),
+      replay_paused(false),
+      seek_target(0.0),
+      seek_queued(false)
+{
+    publishSnapshot();
+}
+
+/**
+ * @brief Creates the timer on the worker thread and starts stepping
+ */
+void SimWorker::start()
+{
+    if (!timer) {
+        timer = new QTimer(this);
+        timer->setTimerType(Qt::PreciseTimer);
+        connect(timer, &QTimer::timeout, this, &SimWorker::updateSimulation);
+    }
+    timer->start(scheduler.timerIntervalMs());
+    scheduler.start();
+}
+
+/**
+ * @brief Stops the timer; called before the thread quits
+ */
+void SimWorker::stop()
+{
+    if (timer)
+        timer->stop();
+    if (recorder)
+        recorder->close();
+}
+
+/**
+ * @brief Changes the fixed simulation step and re-arms the timer
+ * @param step_sec Step in seconds
+ */
+void SimWorker::setStep(double step_sec)
+{
+    scheduler.setStep(step_sec);
+    if (timer && timer->isActive())
+        timer->start(scheduler.timerIntervalMs());
+}
+
+/**
+ * @brief Simulation update slot - called every timer interval
+ *
+ * Runs the fixed steps that are due on the monotonic clock, so a late
+ * timer tick catches up instead of letting simulated time drift behind
+ * wall time, then publishes one snapshot.
+ */
+void SimWorker::updateSimulation()
+{
+    const int steps = scheduler.stepsDue();
+    if (steps == 0)
+        return;
+
+    if (replay) {
+        replaySteps(steps);
+        return;
+    }
+
+    const double dt = scheduler.step();
+    for (int i = 0; i < steps; ++i) {
+        simulation.step(dt);
+        if (recorder)
+            recorder->append(simulation);
+    }
+
+    // Monitoring event, formatted on the event log thread
+    EVENT_LOG(LogCategory::Sim, LogLevel::Debug, kSimTickEvent,
+              simulation.time(), double(steps), double(simulation.trackStore().size()),
+              simulation.bearing(), simulation.range(), simulation.bearingRate());
+
+    publishSnapshot();
+}
+
+/**
+ * @brief Copies the simulation state into the back buffer and publishes it
+ */
+void SimWorker::publishSnapshot()
+{
+    simulation.fillSnapshot(snapshots->writeBuffer());
+    snapshots->publish();
+    emit snapshotPublished();
+}
+
+/**
+ * @brief Starts recording every simulation step to a file
+ *
+ * The current state is written first, so the recording starts with the
+ * tick on screen.
+ *
+ * @param path Recording file (truncated)
+ */
+void SimWorker::startRecording(const QString &path)
+{
+    if (!recorder)
+        recorder = new RecordingWriter(this);
+
+    QString error;
+    if (!recorder->open(path, scheduler.step(), &error)) {
+        qWarning() << "Cannot record:" << error;
+        return;
+    }
+    recorder->append(simulation);
+}
+
+/**
+ * @brief Switches to replaying a recording instead of simulating
+ * @param path Recording file
+ */
+void SimWorker::startReplay(const QString &path)
+{
+    QScopedPointer<RecordingReader> reader(new RecordingReader);
+    QString error;
+    if (!reader->open(path, &error)) {
+        qWarning() << "Cannot replay:" << error;
+        return;
+    }
+
+    replay.swap(reader);
+    setStep(replay->stepSec());
+    publishReplayTick();
+    emit replayOpened(replay->startTime(), replay->endTime(), replay->stepSec());
+}
+
+/**
+ * @brief Jumps the replay to the last tick at or before the given time
+ * @param time_sec Simulation time (seconds)
+ */
+void SimWorker::seekReplay(double time_sec)
+{
+    if (!replay || !replay->seek(time_sec))
+        return;
+    EVENT_LOG(LogCategory::Replay, LogLevel::Debug, kReplaySeekEvent, time_sec);
+    publishReplayTick();
+
+    // Seeking back from the end restarts a finished playback
+    if (timer && !replay_paused && !timer->isActive())
+        start();
+}
+
+/**
+ * @brief Requests a replay seek from any thread, coalescing pending ones
+ * @param time_sec Simulation time (seconds)
+ */
+void SimWorker::requestReplaySeek(double time_sec)
+{
+    seek_target.store(time_sec, std::memory_order_relaxed);
+    if (!seek_queued.exchange(true, std::memory_order_acq_rel))
+        QMetaObject::invokeMethod(this, "applyReplaySeek", Qt::QueuedConnection);
+}
+
+/**
+ * @brief Runs the latest seek requested by requestReplaySeek()
+ */
+void SimWorker::applyReplaySeek()
+{
+    seek_queued.exchange(false, std::memory_order_acq_rel);
+    seekReplay(seek_target.load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief Pauses or resumes replay playback
+ *
+ * Resuming restarts the scheduler clock, so the time spent paused is not
+ * caught up in one burst.
+ *
+ * @param paused true to hold the current tick
+ */
+void SimWorker::setReplayPaused(bool paused)
+{
+    replay_paused = paused;
+    if (!timer)
+        return;
+    if (paused)
+        timer->stop();
+    else if (replay && !replay->atEnd())
+        start();
+}
+
+/**
+ * @brief Shows the recorded tick due after the given number of steps
+ *
+ * Intermediate ticks are skipped without decoding; at the end of the
+ * recording the last frame stays on screen.
+ *
+ * @param steps Steps due on the scheduler
+ */
+void SimWorker::replaySteps(int steps)
+{
+    replay->skip(steps - 1);
+    if (!publishReplayTick() && timer) {
+        EVENT_LOG(LogCategory::Replay, LogLevel::Info, kReplayEndEvent, replay->endTime());
+        timer->stop();
+    }
+}
+
+/**
+ * @brief Decodes the next recorded tick into the back buffer and publishes it
+ * @return false at the end of the recording
+ */
+bool SimWorker::publishReplayTick()
+{
+    if (!replay->readNext(snapshots->writeBuffer()))
+        return false;
+    snapshots->publish();
+    emit snapshotPublished();
+    return true;
+}
@@ -0,0 +1,148 @@
+#ifndef SIMWORKER_H
+#define SIMWORKER_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QTimer>
+#include <atomic>
+#include "recording.h"
+#include "simulation.h"
+#include "simscheduler.h"
+#include "triplebuffer.h"
+
+/**
+ * @brief SimWorker - Runs the Simulation on its own thread
+ *
+ * Lives on a QThread created by SimHost. A timer on that thread wakes
+ * the SimScheduler, the due steps are simulated and the resulting state is
+ * published as a SimSnapshot through a lock-free TripleBuffer. The GUI
+ * thread never touches the Simulation itself.
+ *
+ * Every step can be appended to a RecordingWriter; in replay mode the
+ * snapshots come from a RecordingReader instead of the Simulation.
+ */
+class SimWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the worker (call moveToThread() before start())
+     * @param scenario Scenario to simulate
+     * @param output Triple buffer the snapshots are published to
+     * @param parent Parent object (must be nullptr if moved to a thread)
+     */
+    SimWorker(const Scenario &scenario, TripleBuffer<SimSnapshot> *output,
+              QObject *parent = nullptr);
+
+    /**
+     * @brief Requests a replay seek from any thread
+     *
+     * Seeks are coalesced: while one is queued, later requests only
+     * replace its target time, so dragging a slider faster than the
+     * worker can decode never builds a backlog.
+     *
+     * @param time_sec Simulation time (seconds)
+     */
+    void requestReplaySeek(double time_sec);
+
+public slots:
+    /**
+     * @brief Creates the timer on the worker thread and starts stepping
+     */
+    void start();
+
+    /**
+     * @brief Stops the timer; called before the thread quits
+     */
+    void stop();
+
+    /**
+     * @brief Changes the fixed simulation step
+     * @param step_sec Step in seconds (minimum SimScheduler::kMinStepSec)
+     */
+    void setStep(double step_sec);
+
+    /**
+     * @brief Starts recording every simulation step to a file
+     * @param path Recording file (truncated)
+     */
+    void startRecording(const QString &path);
+
+    /**
+     * @brief Switches to replaying a recording instead of simulating
+     *
+     * The step is taken from the recording; one recorded tick is shown per
+     * step.
+     *
+     * @param path Recording file
+     */
+    void startReplay(const QString &path);
+
+    /**
+     * @brief Jumps the replay to the last tick at or before the given time
+     * @param time_sec Simulation time (seconds)
+     */
+    void seekReplay(double time_sec);
+
+    /**
+     * @brief Pauses or resumes replay playback (seeks still show their tick)
+     * @param paused true to hold the current tick
+     */
+    void setReplayPaused(bool paused);
+
+signals:
+    /**
+     * @brief Emitted after a new snapshot was published
+     */
+    void snapshotPublished();
+
+    /**
+     * @brief Emitted when a recording was opened for replay
+     * @param start_sec Time of the first tick
+     * @param end_sec Time of the last tick
+     * @param step_sec Recorded step
+     */
+    void replayOpened(double start_sec, double end_sec, double step_sec);
+
+private slots:
+    /**
+     * @brief Runs the due steps and publishes a snapshot
+     */
+    void updateSimulation();
+
+    /**
+     * @brief Runs the latest seek requested by requestReplaySeek()
+     */
+    void applyReplaySeek();
+
+private:
+    /**
+     * @brief Copies the simulation state into the back buffer and publishes it
+     */
+    void publishSnapshot();
+
+    /**
+     * @brief Shows the recorded tick due after the given number of steps
+     * @param steps Steps due on the scheduler
+     */
+    void replaySteps(int steps);
+
+    /**
+     * @brief Decodes the next recorded tick into the back buffer and publishes it
+     * @return false at the end of the recording
+     */
+    bool publishReplayTick();
+
+    Simulation simulation;            ///< Kinematics owned by this thread
+    SimScheduler scheduler;           ///< Fixed-step clock (monotonic)
+    QTimer *timer;                    ///< Wake-up timer, created on the worker thread
+    TripleBuffer<SimSnapshot> *snapshots;  ///< Output to the GUI thread
+    RecordingWriter *recorder;        ///< Recording of every step, nullptr if off
+    QScopedPointer<RecordingReader> replay; ///< Replay source, null when simulating
+    bool replay_paused;               ///< Playback held (e.g. while scrubbing)
+    std::atomic<double> seek_target;  ///< Latest requested seek time
+    std::atomic<bool> seek_queued;    ///< applyReplaySeek() is queued
+};
+
+#endif // SIMWORKER_H
@@ -0,0 +1,255 @@
+#include "spatialgrid.h"
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+
+// Target occupancy of an automatically sized grid
+static const double kPointsPerCell = 2.0;
+
+/**
+ * @brief Constructor - no points, one empty cell
+ */
+SpatialGrid::SpatialGrid()
+    : origin_x(0.0),
+      origin_y(0.0),
+      cell(1.0),
+      inv_cell(1.0),
+      cols(1),
+      rows(1)
+{
+    cell_start.fill(0, 2);
+}
+
+/**
+ * @brief Rebuilds the grid over a point set
+ *
+ * Cells cover the bounding box of the points. The number of cells is
+ * capped at a few per point, so a far outlier makes the cells larger
+ * instead of the grid huge. Points are then bucketed with a counting
+ * sort: count per cell, prefix sum, scatter.
+ *
+ * @param x X coordinate of each point, count elements
+ * @param y Y coordinate of each point, count elements
+ * @param count Number of points
+ * @param cell_size Cell edge length, 0 to derive it from the bounds
+ */
+void SpatialGrid::build(const double *x, const double *y, int count, double cell_size)
+{
+    double min_x = 0.0, max_x = 0.0, min_y = 0.0, max_y = 0.0;
+    if (count > 0) {
+        min_x = max_x = x[0];
+        min_y = max_y = y[0];
+        for (int i = 1; i < count; ++i) {
+            min_x = qMin(min_x, x[i]); max_x = qMax(max_x, x[i]);
+            min_y = qMin(min_y, y[i]); max_y = qMax(max_y, y[i]);
+        }
+    }
+    const double w = max_x - min_x, h = max_y - min_y;
+    const double extent = qMax(qMax(w, h), 1e-9);
+
+    if (!(cell_size > 0.0)) {
+        const double cells = qMax(1.0, count / kPointsPerCell);
+        cell_size = w > 0.0 && h > 0.0 ? std::sqrt(w * h / cells) : extent / cells;
+    }
+    const double max_cells = 4.0 * count + 64.0;
+    cell_size = qMax(cell_size, extent * 1e-9);
+    while ((std::floor(w / cell_size) + 1.0) * (std::floor(h / cell_size) + 1.0) > max_cells)
+        cell_size *= 1.5;
+
+    origin_x = min_x;
+    origin_y = min_y;
+    cell = cell_size;
+    inv_cell = 1.0 / cell_size;
+    cols = int(w * inv_cell) + 1;
+    rows = int(h * inv_cell) + 1;
+
+    const int cells = cols * rows;
+    cell_start.fill(0, cells + 1);
+    point_cell.resize(count);
+    int *start = cell_start.data();
+    int *pc = point_cell.data();
+    for (int i = 0; i < count; ++i) {
+        const int cx = qMin(int((x[i] - origin_x) * inv_cell), cols - 1);
+        const int cy = qMin(int((y[i] - origin_y) * inv_cell), rows - 1);
+        pc[i] = cy * cols + cx;
+        ++start[pc[i] + 1];
+    }
+    for (int c = 0; c < cells; ++c)
+        start[c + 1] += start[c];
+
+    // Scatter; start[c] is used as the fill position and restored after
+    items.resize(count);
+    item_x.resize(count);
+    item_y.resize(count);
+    int *it = items.data();
+    double *ix = item_x.data();
+    double *iy = item_y.data();
+    for (int i = 0; i < count; ++i) {
+        const int k = start[pc[i]]++;
+        it[k] = i;
+        ix[k] = x[i];
+        iy[k] = y[i];
+    }
+    for (int c = cells; c > 0; --c)
+        start[c] = start[c - 1];
+    start[0] = 0;
+}
+
+/**
+ * @brief Cell range covering [min, max] along one axis, clamped to the grid
+ * @param min Lower coordinate
+ * @param max Upper coordinate
+ * @param origin Grid origin on this axis
+ * @param cells Cells on this axis
+ * @param first Receives the first cell
+ * @param last Receives the last cell
+ * @return false if the range misses the grid
+ */
+bool SpatialGrid::cellRange(double min, double max, double origin, int cells,
+                            int &first, int &last) const
+{
+    const double lo = std::floor((min - origin) * inv_cell);
+    const double hi = std::floor((max - origin) * inv_cell);
+    if (!(hi >= 0.0) || !(lo < cells) || !(lo <= hi))
+        return false;
+    first = lo < 0.0 ? 0 : int(lo);
+    last = hi >= cells ? cells - 1 : int(hi);
+    return true;
+}
+
+/**
+ * @brief Points within a distance of a centre
+ * @param cx Centre X
+ * @param cy Centre Y
+ * @param radius Search radius
+ * @param out Receives the point indices
+ */
+void SpatialGrid::queryRadius(double cx, double cy, double radius, QVector<int> &out) const
+{
+    out.resize(0);
+    int x0, x1, y0, y1;
+    if (!cellRange(cx - radius, cx + radius, origin_x, cols, x0, x1)
+            || !cellRange(cy - radius, cy + radius, origin_y, rows, y0, y1))
+        return;
+
+    const double r2 = radius * radius;
+    for (int row = y0; row <= y1; ++row) {
+        const int end = cell_start[row * cols + x1 + 1];
+        for (int k = cell_start[row * cols + x0]; k < end; ++k) {
+            const double dx = item_x[k] - cx, dy = item_y[k] - cy;
+            if (dx * dx + dy * dy <= r2)
+                out.append(items[k]);
+        }
+    }
+}
+
+/**
+ * @brief Points inside an axis-aligned rectangle
+ *
+ * The cells of one row are contiguous in items, so each row of the
+ * rectangle is a single run.
+ *
+ * @param min_x Left edge
+ * @param min_y Lower edge
+ * @param max_x Right edge
+ * @param max_y Upper edge
+ * @param out Receives the point indices
+ */
+void SpatialGrid::queryRect(double min_x, double min_y, double max_x, double max_y,
+                            QVector<int> &out) const
+{
+    out.resize(0);
+    int x0, x1, y0, y1;
+    if (!cellRange(min_x, max_x, origin_x, cols, x0, x1)
+            || !cellRange(min_y, max_y, origin_y, rows, y0, y1))
+        return;
+
+    for (int row = y0; row <= y1; ++row) {
+        const int end = cell_start[row * cols + x1 + 1];
+        for (int k = cell_start[row * cols + x0]; k < end; ++k) {
+            const double px = item_x[k], py = item_y[k];
+            if (px >= min_x && px <= max_x && py >= min_y && py <= max_y)
+                out.append(items[k]);
+        }
+    }
+}
+
+/**
+ * @brief Points strictly on one side of the line A→B
+ *
+ * The side function f(P) = (B - A) x (P - A) is linear, so its range
+ * over a cell is reached at the corners: f at the lower left corner
+ * plus the negative (or positive) parts of its steps along X and Y.
+ *
+ * @param ax Line point A, X
+ * @param ay Line point A, Y
+ * @param bx Line point B, X
+ * @param by Line point B, Y
+ * @param left true for the positive side, false for the negative side
+ * @param out Receives the point indices
+ */
+void SpatialGrid::queryHalfPlane(double ax, double ay, double bx, double by, bool left,
+                                 QVector<int> &out) const
+{
+    out.resize(0);
+    // Test the negative side as the positive side of the flipped function
+    const double sign = left ? 1.0 : -1.0;
+    const double dx = sign * (bx - ax), dy = sign * (by - ay);
+    const double step_x = -dy * cell, step_y = dx * cell;
+    const double low = qMin(0.0, step_x) + qMin(0.0, step_y);
+    const double high = qMax(0.0, step_x) + qMax(0.0, step_y);
+
+    for (int row = 0; row < rows; ++row) {
+        const double y = origin_y + row * cell;
+        for (int col = 0; col < cols; ++col) {
+            const int c = row * cols + col;
+            const int begin = cell_start[c], end = cell_start[c + 1];
+            if (begin == end)
+                continue;
+            const double f = dx * (y - ay) - dy * (origin_x + col * cell - ax);
+            if (f + low > 0.0) {
+                for (int k = begin; k < end; ++k)
+                    out.append(items[k]);
+            } else if (f + high > 0.0) {
+                for (int k = begin; k < end; ++k) {
+                    if (dx * (item_y[k] - ay) - dy * (item_x[k] - ax) > 0.0)
+                        out.append(items[k]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Closest point to a position
+ *
+ * Scans the cells the search circle overlaps; pick radii are a few
+ * pixels, so that is one or a few cells.
+ *
+ * @param x Position X
+ * @param y Position Y
+ * @param max_radius Points farther away are ignored
+ * @return Point index, -1 if none is within max_radius
+ */
+int SpatialGrid::nearest(double x, double y, double max_radius) const
+{
+    int x0, x1, y0, y1;
+    if (!cellRange(x - max_radius, x + max_radius, origin_x, cols, x0, x1)
+            || !cellRange(y - max_radius, y + max_radius, origin_y, rows, y0, y1))
+        return -1;
+
+    int best = -1;
+    double best_d2 = max_radius * max_radius;
+    for (int row = y0; row <= y1; ++row) {
+        const int end = cell_start[row * cols + x1 + 1];
+        for (int k = cell_start[row * cols + x0]; k < end; ++k) {
+            const double dx = item_x[k] - x, dy = item_y[k] - y;
+            const double d2 = dx * dx + dy * dy;
+            if (d2 <= best_d2 && (best < 0 || d2 < best_d2 || items[k] < best)) {
+                best = items[k];
+                best_d2 = d2;
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,111 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <QVector>
+
+/**
+ * @brief SpatialGrid - Uniform grid over a point set for proximity queries
+ *
+ * Built from scratch for every snapshot (a counting sort, O(n)) rather
+ * than updated, since every contact moves every tick. Points are sorted
+ * by cell into flat arrays (cell_start / items, with the coordinates
+ * copied alongside), so a query walks contiguous memory and never
+ * allocates once the output vector has grown.
+ *
+ * The cell size is chosen from the point bounds for about two points per
+ * cell unless given. Coordinates are plain doubles; Simulation builds
+ * one over the own-ship-relative track positions in nautical miles (Y
+ * north). Queries clear their output and return point indices in cell
+ * order.
+ */
+class SpatialGrid
+{
+public:
+    /**
+     * @brief Constructs an empty grid
+     */
+    SpatialGrid();
+
+    /**
+     * @brief Rebuilds the grid over a point set
+     * @param x X coordinate of each point, count elements
+     * @param y Y coordinate of each point, count elements
+     * @param count Number of points
+     * @param cell_size Cell edge length, 0 to derive it from the bounds
+     */
+    void build(const double *x, const double *y, int count, double cell_size = 0.0);
+
+    int size() const { return items.size(); }  ///< Number of points
+    double cellSize() const { return cell; }     ///< Cell edge length
+    int columns() const { return cols; }         ///< Cells along X
+    int rowCount() const { return rows; }        ///< Cells along Y
+
+    /**
+     * @brief Points within a distance of a centre (boundary included)
+     * @param cx Centre X
+     * @param cy Centre Y
+     * @param radius Search radius
+     * @param out Receives the point indices
+     */
+    void queryRadius(double cx, double cy, double radius, QVector<int> &out) const;
+
+    /**
+     * @brief Points inside an axis-aligned rectangle (boundary included)
+     * @param min_x Left edge
+     * @param min_y Lower edge
+     * @param max_x Right edge
+     * @param max_y Upper edge
+     * @param out Receives the point indices
+     */
+    void queryRect(double min_x, double min_y, double max_x, double max_y,
+                   QVector<int> &out) const;
+
+    /**
+     * @brief Points strictly on one side of the line A→B
+     *
+     * Same side convention as sideOfLine(): left means a positive cross
+     * product (B - A) x (P - A). Whole cells on one side are taken or
+     * skipped without testing their points; only cells the line crosses
+     * are tested point by point.
+     *
+     * @param ax Line point A, X
+     * @param ay Line point A, Y
+     * @param bx Line point B, X
+     * @param by Line point B, Y
+     * @param left true for the positive side, false for the negative side
+     * @param out Receives the point indices
+     */
+    void queryHalfPlane(double ax, double ay, double bx, double by, bool left,
+                        QVector<int> &out) const;
+
+    /**
+     * @brief Closest point to a position
+     * @param x Position X
+     * @param y Position Y
+     * @param max_radius Points farther away are ignored
+     * @return Point index, -1 if none is within max_radius
+     */
+    int nearest(double x, double y, double max_radius) const;
+
+private:
+    /**
+     * @brief Cell range covering [min, max] along one axis, clamped to the grid
+     * @return false if the range misses the grid
+     */
+    bool cellRange(double min, double max, double origin, int cells, int &first, int &last) const;
+
+    double origin_x;                  ///< X of the grid's lower left corner
+    double origin_y;                  ///< Y of the grid's lower left corner
+    double cell;                      ///< Cell edge length
+    double inv_cell;                  ///< 1 / cell
+    int cols;                         ///< Cells along X
+    int rows;                         ///< Cells along Y
+
+    QVector<int> cell_start;          ///< First entry of each cell in items (rows * cols + 1)
+    QVector<int> items;               ///< Point indices sorted by cell
+    QVector<double> item_x;           ///< X of items[k]
+    QVector<double> item_y;           ///< Y of items[k]
+    QVector<int> point_cell;          ///< Build scratch: cell of each point
+};
+
+#endif // SPATIALGRID_H
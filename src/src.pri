@@ -0,0 +1,59 @@
+# TSA Screen core sources, shared by the application and the benchmarks
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/diagramwidget.cpp \
+    $$PWD/tsaglwidget.cpp \
+    $$PWD/simhost.cpp \
+    $$PWD/trackstore.cpp \
+    $$PWD/tmaestimator.cpp \
+    $$PWD/ekftracker.cpp \
+    $$PWD/measurementgen.cpp \
+    $$PWD/spatialgrid.cpp \
+    $$PWD/bearingkernel.cpp \
+    $$PWD/halfplanekernel.cpp \
+    $$PWD/simscheduler.cpp \
+    $$PWD/simulation.cpp \
+    $$PWD/simworker.cpp \
+    $$PWD/geometry.cpp \
+    $$PWD/tsarenderer.cpp \
+    $$PWD/hatchtile.cpp \
+    $$PWD/displayconfig.cpp \
+    $$PWD/configwatcher.cpp \
+    $$PWD/arrowbatch.cpp \
+    $$PWD/headless.cpp \
+    $$PWD/perfstats.cpp \
+    $$PWD/scenario.cpp \
+    $$PWD/recording.cpp \
+    $$PWD/batch.cpp \
+    $$PWD/eventlog.cpp
+
+HEADERS += \
+    $$PWD/diagramwidget.h \
+    $$PWD/tsaglwidget.h \
+    $$PWD/simhost.h \
+    $$PWD/trackstore.h \
+    $$PWD/tmaestimator.h \
+    $$PWD/ekftracker.h \
+    $$PWD/measurementgen.h \
+    $$PWD/spatialgrid.h \
+    $$PWD/bearingkernel.h \
+    $$PWD/halfplanekernel.h \
+    $$PWD/simscheduler.h \
+    $$PWD/simulation.h \
+    $$PWD/simworker.h \
+    $$PWD/triplebuffer.h \
+    $$PWD/geometry.h \
+    $$PWD/tsarenderer.h \
+    $$PWD/hatchtile.h \
+    $$PWD/displayconfig.h \
+    $$PWD/configwatcher.h \
+    $$PWD/arrowbatch.h \
+    $$PWD/headless.h \
+    $$PWD/perfstats.h \
+    $$PWD/scenario.h \
+    $$PWD/recording.h \
+    $$PWD/batch.h \
+    $$PWD/eventlog.h \
+    $$PWD/mpscring.h
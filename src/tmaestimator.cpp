@@ -0,0 +1,290 @@
+#include "tmaestimator.h"
+#include <QtMath>
+#include <cmath>
+
+// Upper-triangle slots of the symmetric 4x4 normal matrix
+enum { N00, N01, N02, N03, N11, N12, N13, N22, N23, N33 };
+
+/**
+ * @brief Weight left to the history after dt_hours with a fade-out time constant
+ */
+static inline double fadeFactor(double dt_hours, double memory_sec)
+{
+    return (memory_sec > 0.0 && dt_hours > 0.0) ? std::exp(-dt_hours * 3600.0 / memory_sec) : 1.0;
+}
+
+/**
+ * @brief Constructor - no tracks yet
+ * @param memory_sec Time constant of the bearing fade-out (seconds), 0 to keep all
+ */
+TmaEstimator::TmaEstimator(double memory_sec)
+    : memory_sec(qMax(0.0, memory_sec))
+{
+}
+
+/**
+ * @brief Sets the number of tracks and clears every history
+ * @param count Number of tracks
+ */
+void TmaEstimator::resize(int count)
+{
+    for (QVector<double> &n : normal)
+        n.fill(0.0, count);
+    for (QVector<double> &b : rhs)
+        b.fill(0.0, count);
+    ref_hours.fill(0.0, count);
+    last_hours.fill(0.0, count);
+    bearing_count.fill(0, count);
+    last_sin.fill(0.0, count);
+    last_cos.fill(1.0, count);
+    solved_flag.fill(0, count);
+    est_x.fill(0.0, count);
+    est_y.fill(0.0, count);
+    est_range.fill(0.0, count);
+    est_course.fill(0.0, count);
+    est_speed.fill(0.0, count);
+}
+
+/**
+ * @brief Forgets the bearing history of one track
+ * @param track Track index
+ */
+void TmaEstimator::reset(int track)
+{
+    for (QVector<double> &n : normal)
+        n[track] = 0.0;
+    for (QVector<double> &b : rhs)
+        b[track] = 0.0;
+    bearing_count[track] = 0;
+    solved_flag[track] = 0;
+}
+
+/**
+ * @brief Adds one bearing per track and solves every track again
+ *
+ * The fade factor is shared by every track last updated at the same
+ * time, so the exponential is normally evaluated once per call.
+ *
+ * @param time_sec Time of the bearings (seconds)
+ * @param own_x Own ship X position (nm)
+ * @param own_y Own ship Y position (nm)
+ * @param bearing_deg Bearing of each track (degrees), count elements
+ * @param count Number of tracks
+ */
+void TmaEstimator::update(double time_sec, double own_x, double own_y,
+                          const double *bearing_deg, int count)
+{
+    if (count != size())
+        resize(count);
+
+    const double t = time_sec / 3600.0;
+    double fade_dt = -1.0, fade = 1.0;
+    for (int i = 0; i < count; ++i) {
+        const double dt = prepareTrack(i, t);
+        if (dt != fade_dt) {
+            fade_dt = dt;
+            fade = fadeFactor(dt, memory_sec);
+        }
+        accumulate(i, t, own_x, own_y, bearing_deg[i], fade);
+    }
+
+    for (int i = 0; i < count; ++i)
+        solve(i, time_sec, own_x, own_y);
+}
+
+/**
+ * @brief Adds a single bearing to one track without solving it
+ * @param track Track index
+ * @param time_sec Time of the bearing (seconds)
+ * @param own_x Own ship X position when it was taken (nm)
+ * @param own_y Own ship Y position when it was taken (nm)
+ * @param bearing_deg Bearing (degrees)
+ */
+void TmaEstimator::addBearing(int track, double time_sec, double own_x, double own_y,
+                              double bearing_deg)
+{
+    const double t = time_sec / 3600.0;
+    const double dt = prepareTrack(track, t);
+    accumulate(track, t, own_x, own_y, bearing_deg, fadeFactor(dt, memory_sec));
+}
+
+/**
+ * @brief Starts or rebases a track's reference time for a new bearing
+ * @param track Track index
+ * @param t_hours Time of the bearing (hours)
+ * @return Hours since the track's previous bearing (0 for the first)
+ */
+double TmaEstimator::prepareTrack(int track, double t_hours)
+{
+    if (bearing_count[track] == 0)
+        ref_hours[track] = last_hours[track] = t_hours;
+    else if (t_hours - ref_hours[track] > kRebaseHours)
+        rebase(track, t_hours);
+    return t_hours - last_hours[track];
+}
+
+/**
+ * @brief Fades a track's equations and adds the row of one bearing
+ *
+ * Row a = (cos b, -sin b, tau cos b, -tau sin b), observation
+ * z = ox cos b - oy sin b.
+ *
+ * @param track Track index
+ * @param t_hours Time of the bearing (hours)
+ * @param own_x Own ship X position (nm)
+ * @param own_y Own ship Y position (nm)
+ * @param bearing_deg Bearing (degrees)
+ * @param fade Weight kept by the previous bearings
+ */
+void TmaEstimator::accumulate(int track, double t_hours, double own_x, double own_y,
+                              double bearing_deg, double fade)
+{
+    const int i = track;
+    const double b = qDegreesToRadians(bearing_deg);
+    const double c = std::cos(b), s = std::sin(b);
+    const double tau = t_hours - ref_hours[i];
+    const double a0 = c, a1 = -s, a2 = tau * c, a3 = -tau * s;
+    const double z = own_x * c - own_y * s;
+
+    normal[N00][i] = fade * normal[N00][i] + a0 * a0;
+    normal[N01][i] = fade * normal[N01][i] + a0 * a1;
+    normal[N02][i] = fade * normal[N02][i] + a0 * a2;
+    normal[N03][i] = fade * normal[N03][i] + a0 * a3;
+    normal[N11][i] = fade * normal[N11][i] + a1 * a1;
+    normal[N12][i] = fade * normal[N12][i] + a1 * a2;
+    normal[N13][i] = fade * normal[N13][i] + a1 * a3;
+    normal[N22][i] = fade * normal[N22][i] + a2 * a2;
+    normal[N23][i] = fade * normal[N23][i] + a2 * a3;
+    normal[N33][i] = fade * normal[N33][i] + a3 * a3;
+    rhs[0][i] = fade * rhs[0][i] + a0 * z;
+    rhs[1][i] = fade * rhs[1][i] + a1 * z;
+    rhs[2][i] = fade * rhs[2][i] + a2 * z;
+    rhs[3][i] = fade * rhs[3][i] + a3 * z;
+
+    last_hours[i] = t_hours;
+    last_sin[i] = s;
+    last_cos[i] = c;
+    ++bearing_count[i];
+}
+
+/**
+ * @brief Moves a track's reference time forward, transforming its equations
+ *
+ * With theta' = (x0 + vx d, y0 + vy d, vx, vy) at the new reference
+ * (d = new - old), every row a becomes T^-1 a with T^-1 = I - d (E20 + E31),
+ * so N' = T^-1 N T^-T and r' = T^-1 r; no bearing has to be revisited.
+ *
+ * @param track Track index
+ * @param new_ref_hours New reference time (hours)
+ */
+void TmaEstimator::rebase(int track, double new_ref_hours)
+{
+    const double d = new_ref_hours - ref_hours[track];
+    const int i = track;
+
+    double m[4][4];
+    m[0][0] = normal[N00][i]; m[0][1] = normal[N01][i]; m[0][2] = normal[N02][i]; m[0][3] = normal[N03][i];
+    m[1][1] = normal[N11][i]; m[1][2] = normal[N12][i]; m[1][3] = normal[N13][i];
+    m[2][2] = normal[N22][i]; m[2][3] = normal[N23][i];
+    m[3][3] = normal[N33][i];
+    for (int r = 1; r < 4; ++r) {
+        for (int c = 0; c < r; ++c)
+            m[r][c] = m[c][r];
+    }
+
+    // Rows, then columns: row2 -= d row0, row3 -= d row1
+    for (int c = 0; c < 4; ++c) {
+        m[2][c] -= d * m[0][c];
+        m[3][c] -= d * m[1][c];
+    }
+    for (int r = 0; r < 4; ++r) {
+        m[r][2] -= d * m[r][0];
+        m[r][3] -= d * m[r][1];
+    }
+
+    normal[N00][i] = m[0][0]; normal[N01][i] = m[0][1]; normal[N02][i] = m[0][2]; normal[N03][i] = m[0][3];
+    normal[N11][i] = m[1][1]; normal[N12][i] = m[1][2]; normal[N13][i] = m[1][3];
+    normal[N22][i] = m[2][2]; normal[N23][i] = m[2][3];
+    normal[N33][i] = m[3][3];
+    rhs[2][i] -= d * rhs[0][i];
+    rhs[3][i] -= d * rhs[1][i];
+    ref_hours[i] = new_ref_hours;
+}
+
+/**
+ * @brief Solves one track's normal equations and updates its estimate
+ *
+ * Cholesky factorization of the 4x4 normal matrix. A pivot that keeps
+ * less than kMinPivot of its diagonal entry means the bearings do not
+ * determine that component (no own ship manoeuvre yet): the track is
+ * marked unsolved and keeps its previous numbers. A solution that puts
+ * the target behind the last bearing, or on own ship's own track (which
+ * satisfies every bearing line while own ship holds its leg), is
+ * rejected the same way.
+ *
+ * @param track Track index
+ * @param time_sec Time to report the position for (seconds)
+ * @param own_x Own ship X position at that time (nm)
+ * @param own_y Own ship Y position at that time (nm)
+ */
+void TmaEstimator::solve(int track, double time_sec, double own_x, double own_y)
+{
+    const int i = track;
+    solved_flag[i] = 0;
+    if (bearing_count[i] < kMinBearings)
+        return;
+
+    const double a[4][4] = {
+        { normal[N00][i], normal[N01][i], normal[N02][i], normal[N03][i] },
+        { normal[N01][i], normal[N11][i], normal[N12][i], normal[N13][i] },
+        { normal[N02][i], normal[N12][i], normal[N22][i], normal[N23][i] },
+        { normal[N03][i], normal[N13][i], normal[N23][i], normal[N33][i] },
+    };
+
+    // A = L L^T
+    double l[4][4] = {};
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c <= r; ++c) {
+            double sum = a[r][c];
+            for (int k = 0; k < c; ++k)
+                sum -= l[r][k] * l[c][k];
+            if (r == c) {
+                if (!(sum > kMinPivot * a[r][r]) || !(a[r][r] > 0.0))
+                    return;
+                l[r][r] = std::sqrt(sum);
+            } else {
+                l[r][c] = sum / l[c][c];
+            }
+        }
+    }
+
+    // L y = r, L^T theta = y
+    double y[4], theta[4];
+    for (int r = 0; r < 4; ++r) {
+        double sum = rhs[r][i];
+        for (int k = 0; k < r; ++k)
+            sum -= l[r][k] * y[k];
+        y[r] = sum / l[r][r];
+    }
+    for (int r = 3; r >= 0; --r) {
+        double sum = y[r];
+        for (int k = r + 1; k < 4; ++k)
+            sum -= l[k][r] * theta[k];
+        theta[r] = sum / l[r][r];
+    }
+
+    const double tau = time_sec / 3600.0 - ref_hours[i];
+    const double x = theta[0] + theta[2] * tau;
+    const double yy = theta[1] + theta[3] * tau;
+    const double dx = x - own_x, dy = yy - own_y;
+    if (dx * last_sin[i] + dy * last_cos[i] < kMinRangeNm)
+        return;
+
+    est_x[i] = x;
+    est_y[i] = yy;
+    est_range[i] = std::hypot(dx, dy);
+    const double course = qRadiansToDegrees(std::atan2(theta[2], theta[3]));
+    est_course[i] = course < 0.0 ? course + 360.0 : course;
+    est_speed[i] = std::hypot(theta[2], theta[3]);
+    solved_flag[i] = 1;
+}
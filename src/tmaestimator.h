@@ -0,0 +1,171 @@
+#ifndef TMAESTIMATOR_H
+#define TMAESTIMATOR_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief TmaEstimator - Bearings-only target motion analysis for many tracks
+ *
+ * Estimates the position and velocity of every track from its bearing
+ * history and the own ship positions the bearings were taken from,
+ * assuming the target holds course and speed. Uses the pseudo-linear
+ * estimator: a bearing b from own ship (ox, oy) puts the target on the
+ * line
+ *
+ *     (x0 + vx tau - ox) cos b - (y0 + vy tau - oy) sin b = 0
+ *
+ * which is linear in theta = (x0, y0, vx, vy), the target state at a
+ * reference time (tau = time since it, hours). Each bearing adds one row
+ * to the least-squares problem; only its 4x4 normal matrix and right-hand
+ * side are kept, so an update is O(1) per track however long the history
+ * is, and the 4x4 system is solved again after every update.
+ *
+ * Old bearings are faded out with a time constant (memoryTime()) so the
+ * solution follows target manoeuvres, and the reference time is moved
+ * forward every kRebaseHours to keep the normal matrix well conditioned.
+ * Range is only observable once own ship has manoeuvred; until then the
+ * matrix is near singular and the track is reported unsolved.
+ *
+ * The accumulators are stored per field (structure of arrays) like
+ * TrackStore; a tick touches 14 doubles and solves one 4x4 system per
+ * track.
+ *
+ * Conventions as TrackStore: nautical miles, X east and Y north, bearings
+ * and courses in degrees clockwise from North, speeds in knots.
+ */
+class TmaEstimator
+{
+public:
+    static const int kMinBearings = 8;        ///< Bearings needed before a solution is tried
+    static constexpr double kRebaseHours = 0.5;   ///< Reference time is moved after this long
+    static constexpr double kMinPivot = 1e-7; ///< Relative Cholesky pivot below which range is unobservable
+    static constexpr double kMinRangeNm = 0.1;    ///< Solutions closer along the bearing are rejected
+
+    /**
+     * @brief Constructs an estimator for no tracks
+     * @param memory_sec Time constant of the bearing fade-out (seconds), 0 to keep all
+     */
+    explicit TmaEstimator(double memory_sec = 1800.0);
+
+    /**
+     * @brief Sets the number of tracks and clears every history
+     * @param count Number of tracks
+     */
+    void resize(int count);
+
+    /**
+     * @brief Forgets the bearing history of one track (e.g. after a new association)
+     * @param track Track index
+     */
+    void reset(int track);
+
+    /**
+     * @brief Sets the time constant of the bearing fade-out
+     * @param seconds Time after which a bearing has 1/e of its weight, 0 to keep all
+     */
+    void setMemoryTime(double seconds) { memory_sec = qMax(0.0, seconds); }
+
+    double memoryTime() const { return memory_sec; }  ///< Fade-out time constant (s)
+
+    /**
+     * @brief Adds one bearing per track and solves every track again
+     *
+     * All tracks are observed at the same time from the same own ship
+     * position. Time must not go backwards; a repeated time only adds
+     * the bearings again. Resizes (and clears) the estimator if the
+     * track count changed.
+     *
+     * @param time_sec Time of the bearings (seconds)
+     * @param own_x Own ship X position (nm)
+     * @param own_y Own ship Y position (nm)
+     * @param bearing_deg Bearing of each track (degrees), count elements
+     * @param count Number of tracks
+     */
+    void update(double time_sec, double own_x, double own_y,
+                const double *bearing_deg, int count);
+
+    /**
+     * @brief Adds a single bearing to one track without solving it
+     *
+     * For bearings that arrive per track (delayed or missed detections);
+     * call solve() once the bearings of a tick are in.
+     *
+     * @param track Track index
+     * @param time_sec Time of the bearing (seconds), not before the previous one of the track
+     * @param own_x Own ship X position when it was taken (nm)
+     * @param own_y Own ship Y position when it was taken (nm)
+     * @param bearing_deg Bearing (degrees)
+     */
+    void addBearing(int track, double time_sec, double own_x, double own_y, double bearing_deg);
+
+    /**
+     * @brief Solves one track's normal equations and updates its estimate
+     * @param track Track index
+     * @param time_sec Time to report the position for (seconds)
+     * @param own_x Own ship X position at that time (nm)
+     * @param own_y Own ship Y position at that time (nm)
+     */
+    void solve(int track, double time_sec, double own_x, double own_y);
+
+    /**
+     * @brief Number of tracks
+     */
+    int size() const { return solved_flag.size(); }
+
+    // ===== ESTIMATES (valid where solved() is true) =====
+
+    bool solved(int i) const       { return solved_flag[i] != 0; }    ///< Range observable and solved
+    int bearingCount(int i) const  { return bearing_count[i]; }  ///< Bearings used so far
+    double positionX(int i) const  { return est_x[i]; }         ///< Estimated X (nm)
+    double positionY(int i) const  { return est_y[i]; }         ///< Estimated Y (nm)
+    double range(int i) const      { return est_range[i]; }     ///< Estimated range (nm)
+    double course(int i) const     { return est_course[i]; }    ///< Estimated course (degrees)
+    double speed(int i) const      { return est_speed[i]; }     ///< Estimated speed (knots)
+
+    // ===== BULK ARRAY ACCESS (size() elements each) =====
+
+    const quint8 *solvedData() const  { return solved_flag.constData(); }
+    const double *rangeData() const   { return est_range.constData(); }
+    const double *courseData() const  { return est_course.constData(); }
+    const double *speedData() const   { return est_speed.constData(); }
+
+private:
+    /**
+     * @brief Starts or rebases a track's reference time for a new bearing
+     * @return Hours since the track's previous bearing (0 for the first)
+     */
+    double prepareTrack(int track, double t_hours);
+
+    /**
+     * @brief Fades a track's equations and adds the row of one bearing
+     */
+    void accumulate(int track, double t_hours, double own_x, double own_y,
+                    double bearing_deg, double fade);
+
+    /**
+     * @brief Moves a track's reference time forward, transforming its equations
+     */
+    void rebase(int track, double new_ref_hours);
+
+    double memory_sec;                ///< Fade-out time constant (s), 0 = none
+
+    // ===== NORMAL EQUATIONS (PER TRACK) =====
+    QVector<double> normal[10];       ///< Upper triangle of A^T W A: 00 01 02 03 11 12 13 22 23 33
+    QVector<double> rhs[4];           ///< A^T W z
+    QVector<double> ref_hours;        ///< Reference time of theta (hours)
+    QVector<double> last_hours;       ///< Time of the last bearing (hours)
+    QVector<int> bearing_count;       ///< Bearings accumulated
+    QVector<double> last_sin;         ///< sin of the last bearing (ambiguity check)
+    QVector<double> last_cos;         ///< cos of the last bearing
+
+    // ===== ESTIMATES =====
+    QVector<quint8> solved_flag;      ///< 1 if the last solve succeeded
+    QVector<double> est_x;            ///< Target X at the last solve time (nm)
+    QVector<double> est_y;            ///< Target Y at the last solve time (nm)
+    QVector<double> est_range;        ///< Range from own ship (nm)
+    QVector<double> est_course;       ///< Course (degrees)
+    QVector<double> est_speed;        ///< Speed (knots)
+};
+
+#endif // TMAESTIMATOR_H
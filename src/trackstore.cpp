@@ -0,0 +1,191 @@
+#include "trackstore.h"
+#include "bearingkernel.h"
+#include <QtMath>
+#include <algorithm>
+
+/**
+ * @brief Constructor - creates an empty track table
+ */
+TrackStore::TrackStore()
+    : next_leg(0),
+      legs_sorted(true)
+{
+}
+
+/**
+ * @brief Adds a contact moving on a constant course and speed
+ *
+ * The velocity components are precomputed here so that advance() only
+ * performs multiply-adds per track.
+ *
+ * @param x Initial X position at time zero (nautical miles)
+ * @param y Initial Y position at time zero (nautical miles)
+ * @param course Course over ground (degrees)
+ * @param speed Speed over ground (knots)
+ * @return Index of the new track
+ */
+int TrackStore::addTrack(double x, double y, double course, double speed)
+{
+    start_x.append(x);
+    start_y.append(y);
+    course_deg.append(course);
+    speed_kn.append(speed);
+    vel_x.append(speed * qSin(qDegreesToRadians(course)));
+    vel_y.append(speed * qCos(qDegreesToRadians(course)));
+
+    pos_x.append(x);
+    pos_y.append(y);
+    rel_x.append(x);
+    rel_y.append(y);
+    bearing_deg.append(0.0);
+    range_nm.append(0.0);
+    rate_dps.append(0.0);
+    return start_x.size() - 1;
+}
+
+/**
+ * @brief Replaces the initial state of an existing track
+ * @param track Track index returned by addTrack()
+ * @param x Initial X position at time zero (nautical miles)
+ * @param y Initial Y position at time zero (nautical miles)
+ * @param course Course over ground (degrees)
+ * @param speed Speed over ground (knots)
+ */
+void TrackStore::setTrack(int track, double x, double y, double course, double speed)
+{
+    start_x[track] = x;
+    start_y[track] = y;
+    course_deg[track] = course;
+    speed_kn[track] = speed;
+    vel_x[track] = speed * qSin(qDegreesToRadians(course));
+    vel_y[track] = speed * qCos(qDegreesToRadians(course));
+    pos_x[track] = x;
+    pos_y[track] = y;
+    rel_x[track] = x;
+    rel_y[track] = y;
+}
+
+/**
+ * @brief Schedules a course and speed change for a track
+ * @param track Track index returned by addTrack()
+ * @param time_sec Simulation time the leg starts (seconds)
+ * @param course New course over ground (degrees)
+ * @param speed New speed over ground (knots)
+ */
+void TrackStore::addLeg(int track, double time_sec, double course, double speed)
+{
+    ManoeuvreLeg leg = { time_sec, track, course, speed };
+    legs.append(leg);
+    legs_sorted = false;
+}
+
+/**
+ * @brief Applies every pending leg that starts at or before time_sec
+ *
+ * The track position at the leg start is kept and start_x/start_y are
+ * re-based for the new velocity, so the position loop in advance() stays
+ * a plain start + velocity * t.
+ *
+ * @param time_sec Simulation time in seconds
+ */
+void TrackStore::applyLegs(double time_sec)
+{
+    if (!legs_sorted) {
+        // Stable, so legs of one track at the same time apply in insertion order
+        std::stable_sort(legs.begin() + next_leg, legs.end(),
+                         [](const ManoeuvreLeg &a, const ManoeuvreLeg &b) {
+                             return a.time_sec < b.time_sec;
+                         });
+        legs_sorted = true;
+    }
+
+    while (next_leg < legs.size() && legs[next_leg].time_sec <= time_sec) {
+        const ManoeuvreLeg &leg = legs[next_leg++];
+        const int i = leg.track;
+        const double t = leg.time_sec / 3600.0;
+        const double x = start_x[i] + vel_x[i] * t;
+        const double y = start_y[i] + vel_y[i] * t;
+
+        course_deg[i] = leg.course;
+        speed_kn[i] = leg.speed;
+        vel_x[i] = leg.speed * qSin(qDegreesToRadians(leg.course));
+        vel_y[i] = leg.speed * qCos(qDegreesToRadians(leg.course));
+        start_x[i] = x - vel_x[i] * t;
+        start_y[i] = y - vel_y[i] * t;
+    }
+}
+
+/**
+ * @brief Reserves storage for the given number of tracks
+ * @param count Expected number of tracks
+ */
+void TrackStore::reserve(int count)
+{
+    start_x.reserve(count);     start_y.reserve(count);
+    course_deg.reserve(count);  speed_kn.reserve(count);
+    vel_x.reserve(count);       vel_y.reserve(count);
+    pos_x.reserve(count);       pos_y.reserve(count);
+    rel_x.reserve(count);       rel_y.reserve(count);
+    bearing_deg.reserve(count); range_nm.reserve(count);
+    rate_dps.reserve(count);
+}
+
+/**
+ * @brief Removes all tracks
+ */
+void TrackStore::clear()
+{
+    start_x.clear();     start_y.clear();
+    course_deg.clear();  speed_kn.clear();
+    vel_x.clear();       vel_y.clear();
+    pos_x.clear();       pos_y.clear();
+    rel_x.clear();       rel_y.clear();
+    bearing_deg.clear(); range_nm.clear();
+    rate_dps.clear();
+    legs.clear();
+    next_leg = 0;
+    legs_sorted = true;
+}
+
+/**
+ * @brief Advances every track to the given time in a single pass
+ *
+ * The position loop is plain multiply-adds over contiguous arrays that the
+ * compiler vectorizes; range, bearing and rate are then computed by the
+ * runtime-selected SIMD kernel. The raw pointers are taken once up front
+ * so QVector's detach check stays out of the loop.
+ *
+ * @param time_sec Simulation time in seconds
+ * @param own_x Own ship X position (nautical miles)
+ * @param own_y Own ship Y position (nautical miles)
+ * @param dt_sec Time since the previous update (seconds)
+ */
+void TrackStore::advance(double time_sec, double own_x, double own_y, double dt_sec)
+{
+    if (next_leg < legs.size())
+        applyLegs(time_sec);
+
+    const int n = start_x.size();
+    const double t = time_sec / 3600.0;    // Convert seconds to hours
+    const double inv_dt = dt_sec > 0.0 ? 1.0 / dt_sec : 0.0;
+
+    const double *sx = start_x.constData();
+    const double *sy = start_y.constData();
+    const double *vx = vel_x.constData();
+    const double *vy = vel_y.constData();
+    double *px = pos_x.data();
+    double *py = pos_y.data();
+    double *rx = rel_x.data();
+    double *ry = rel_y.data();
+
+    for (int i = 0; i < n; ++i) {
+        px[i] = sx[i] + vx[i] * t;
+        py[i] = sy[i] + vy[i] * t;
+        // Relative position (target minus own ship)
+        rx[i] = px[i] - own_x;
+        ry[i] = py[i] - own_y;
+    }
+
+    computeBearingRangeBatch(rx, ry, inv_dt, bearing_deg.data(),
+                             range_nm.data(), rate_dps.data(), n);
+}
@@ -0,0 +1,166 @@
+#ifndef TRACKSTORE_H
+#define TRACKSTORE_H
+
+#include <QVector>
+
+/**
+ * @brief ManoeuvreLeg - Course and speed change at a given time
+ */
+struct ManoeuvreLeg
+{
+    double time_sec;                  ///< Simulation time the leg starts (seconds)
+    int track;                        ///< Track index the leg applies to
+    double course;                    ///< New course over ground (degrees)
+    double speed;                     ///< New speed over ground (knots)
+};
+
+/**
+ * @brief TrackStore - Structure-of-arrays table of simulated contacts
+ *
+ * Holds the kinematic state and the sensor measurements of every contact
+ * in the tactical picture. Each field lives in its own contiguous array so
+ * that the per-tick update walks memory linearly and the bearing/range
+ * math runs through the SIMD batch kernel in bearingkernel.h.
+ *
+ * Conventions (same as TSAWidget):
+ * - Positions are in nautical miles, X east and Y north
+ * - Courses and bearings are in degrees clockwise from North (0-360°)
+ * - Speeds are in knots, bearing rates in degrees/second
+ */
+class TrackStore
+{
+public:
+    /**
+     * @brief Constructs an empty track table
+     */
+    TrackStore();
+
+    /**
+     * @brief Adds a contact moving on a constant course and speed
+     * @param x Initial X position at time zero (nautical miles)
+     * @param y Initial Y position at time zero (nautical miles)
+     * @param course Course over ground (degrees)
+     * @param speed Speed over ground (knots)
+     * @return Index of the new track
+     */
+    int addTrack(double x, double y, double course, double speed);
+
+    /**
+     * @brief Replaces the initial state of an existing track
+     *
+     * For varying a scenario before it is simulated (e.g. Monte Carlo
+     * runs); call before the first advance(). Scheduled legs are kept.
+     *
+     * @param track Track index returned by addTrack()
+     * @param x Initial X position at time zero (nautical miles)
+     * @param y Initial Y position at time zero (nautical miles)
+     * @param course Course over ground (degrees)
+     * @param speed Speed over ground (knots)
+     */
+    void setTrack(int track, double x, double y, double course, double speed);
+
+    /**
+     * @brief Schedules a course and speed change for a track
+     *
+     * Legs may be added in any order; they are applied by advance() once
+     * the simulation time reaches them. The track keeps its position at
+     * the leg start, so its path stays continuous.
+     *
+     * @param track Track index returned by addTrack()
+     * @param time_sec Simulation time the leg starts (seconds)
+     * @param course New course over ground (degrees)
+     * @param speed New speed over ground (knots)
+     */
+    void addLeg(int track, double time_sec, double course, double speed);
+
+    /**
+     * @brief Number of scheduled legs (applied or not)
+     */
+    int legCount() const { return legs.size(); }
+
+    /**
+     * @brief Reserves storage for the given number of tracks
+     * @param count Expected number of tracks
+     */
+    void reserve(int count);
+
+    /**
+     * @brief Removes all tracks
+     */
+    void clear();
+
+    /**
+     * @brief Number of tracks in the table
+     */
+    int size() const { return start_x.size(); }
+
+    /**
+     * @brief Advances every track to the given time in a single pass
+     *
+     * Applies the legs that have started, computes absolute positions, then
+     * range, bearing and bearing rate relative to own ship. Time must not
+     * go backwards between calls. The bearing change is folded into ±180° before
+     * dividing by dt so that crossing North does not produce a spurious rate.
+     *
+     * @param time_sec Simulation time in seconds
+     * @param own_x Own ship X position (nautical miles)
+     * @param own_y Own ship Y position (nautical miles)
+     * @param dt_sec Time elapsed since the previous update (seconds); a
+     *        non-positive value resets all bearing rates to zero
+     */
+    void advance(double time_sec, double own_x, double own_y, double dt_sec);
+
+    // ===== READ-ONLY ACCESS =====
+
+    double positionX(int i) const    { return pos_x[i]; }     ///< Absolute X (nm)
+    double positionY(int i) const    { return pos_y[i]; }     ///< Absolute Y (nm)
+    double relativeX(int i) const    { return rel_x[i]; }     ///< X from own ship (nm)
+    double relativeY(int i) const    { return rel_y[i]; }     ///< Y from own ship (nm)
+    double course(int i) const       { return course_deg[i]; }///< Course (degrees)
+    double speed(int i) const        { return speed_kn[i]; }  ///< Speed (knots)
+    double bearing(int i) const      { return bearing_deg[i]; }  ///< Bearing (degrees)
+    double range(int i) const        { return range_nm[i]; }     ///< Range (nm)
+    double bearingRate(int i) const  { return rate_dps[i]; }     ///< Rate (deg/s)
+
+    // ===== BULK ARRAY ACCESS (size() elements each) =====
+
+    const double *positionXData() const    { return pos_x.constData(); }
+    const double *positionYData() const    { return pos_y.constData(); }
+    const double *relativeXData() const    { return rel_x.constData(); }
+    const double *relativeYData() const    { return rel_y.constData(); }
+    const double *courseData() const       { return course_deg.constData(); }
+    const double *speedData() const        { return speed_kn.constData(); }
+    const double *bearingData() const      { return bearing_deg.constData(); }
+    const double *rangeData() const        { return range_nm.constData(); }
+    const double *bearingRateData() const  { return rate_dps.constData(); }
+
+private:
+    /**
+     * @brief Applies every pending leg that starts at or before time_sec
+     */
+    void applyLegs(double time_sec);
+
+    // ===== TRACK PARAMETERS (CURRENT LEG) =====
+    QVector<double> start_x;          ///< X position extrapolated back to time zero on the current leg (nm)
+    QVector<double> start_y;          ///< Y position extrapolated back to time zero on the current leg (nm)
+    QVector<double> course_deg;       ///< Course over ground (degrees)
+    QVector<double> speed_kn;         ///< Speed over ground (knots)
+    QVector<double> vel_x;            ///< Eastward velocity (nm/hour)
+    QVector<double> vel_y;            ///< Northward velocity (nm/hour)
+
+    // ===== PER-TICK STATE =====
+    QVector<double> pos_x;            ///< Current X position (nm)
+    QVector<double> pos_y;            ///< Current Y position (nm)
+    QVector<double> rel_x;            ///< Current X relative to own ship (nm)
+    QVector<double> rel_y;            ///< Current Y relative to own ship (nm)
+    QVector<double> bearing_deg;      ///< Current bearing from own ship (degrees)
+    QVector<double> range_nm;         ///< Current range from own ship (nm)
+    QVector<double> rate_dps;         ///< Current bearing rate (degrees/second)
+
+    // ===== MANOEUVRES =====
+    QVector<ManoeuvreLeg> legs;       ///< Scheduled legs, sorted by time once advance() runs
+    int next_leg;                     ///< First leg not applied yet
+    bool legs_sorted;                 ///< false after addLeg() until the next advance()
+};
+
+#endif // TRACKSTORE_H
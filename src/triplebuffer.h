@@ -0,0 +1,86 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+/**
+ * @brief TripleBuffer - Lock-free single-producer/single-consumer state handoff
+ *
+ * Three slots rotate between a writer, a reader and a shared "middle"
+ * position. The writer fills its private back slot and publishes it by
+ * swapping it with the middle slot; the reader picks up the middle slot
+ * only when a fresh one is available. Neither side ever blocks or sees a
+ * slot the other side is writing, so the reader always gets the latest
+ * complete value without tearing.
+ *
+ * Slots are reused, so a T holding containers keeps its capacity and
+ * steady-state publishing does not allocate.
+ *
+ * @tparam T Slot type, default constructible
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer()
+        : back_index(0),
+          pad_writer(),
+          middle(1),
+          pad_reader(),
+          front_index(2)
+    {
+    }
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // ===== WRITER SIDE (one thread) =====
+
+    /**
+     * @brief Slot the writer may fill; private to the writer until publish()
+     */
+    T &writeBuffer() { return buffers[back_index]; }
+
+    /**
+     * @brief Publishes the write buffer as the latest complete value
+     */
+    void publish()
+    {
+        const int previous = middle.exchange(back_index | kFreshBit,
+                                             std::memory_order_acq_rel);
+        back_index = previous & kIndexMask;
+    }
+
+    // ===== READER SIDE (one thread) =====
+
+    /**
+     * @brief Takes the newest published value if there is one
+     * @return true if a new value was picked up since the last call
+     */
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & kFreshBit))
+            return false;
+        const int previous = middle.exchange(front_index, std::memory_order_acq_rel);
+        front_index = previous & kIndexMask;
+        return true;
+    }
+
+    /**
+     * @brief Latest value picked up by update(); private to the reader
+     */
+    const T &readBuffer() const { return buffers[front_index]; }
+
+private:
+    static const int kIndexMask = 0x3;
+    static const int kFreshBit  = 0x4;
+
+    T buffers[3];                     ///< Storage rotated between the three roles
+    int back_index;                   ///< Writer's slot
+    char pad_writer[64];              ///< Keeps writer and reader indices off one cache line
+    std::atomic<int> middle;          ///< Shared slot index plus fresh flag
+    char pad_reader[64];
+    int front_index;                  ///< Reader's slot
+};
+
+#endif // TRIPLEBUFFER_H
@@ -0,0 +1,513 @@
+#include "tsaglwidget.h"
+#include "perfstats.h"
+#include "simhost.h"
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QPainter>
+#include <QtMath>
+
+static const int kDiscFloats = 7;       ///< x, y, radius, r, g, b, a
+static const int kCapsuleFloats = 9;    ///< x1, y1, x2, y2, half width, r, g, b, a
+static const int kTriangleFloats = 10;  ///< x0, y0, x1, y1, x2, y2, r, g, b, a
+
+// ===== SHADERS =====
+
+// Full-screen triangle from gl_VertexID, no vertex buffer
+static const char kBackgroundVertex[] = R"(#version 330 core
+void main()
+{
+    vec2 corner = vec2((gl_VertexID & 1) * 4 - 1, (gl_VertexID >> 1) * 4 - 1);
+    gl_Position = vec4(corner, 0.0, 1.0);
+}
+)";
+
+// Static layer per pixel: black, antialiased hatch lines beyond the
+// outline (as the raster hatch tile), 2 px white outline, 4 px
+// round-capped green beam
+static const char kBackgroundFragment[] = R"(#version 330 core
+uniform float uDpr;
+uniform float uFramebufferHeight;
+uniform vec2 uHatchNormal;
+uniform float uHatchSpacing;
+uniform float uHatchHalfWidth;
+uniform vec4 uHatchColor;
+uniform vec2 uOutlineP1;
+uniform vec2 uOutlineP2;
+uniform vec2 uNormal;
+uniform vec2 uFarEnd;
+uniform vec2 uShipPos;
+out vec4 fragColor;
+
+float segmentDistance(vec2 p, vec2 a, vec2 b)
+{
+    vec2 ab = b - a;
+    float t = clamp(dot(p - a, ab) / max(dot(ab, ab), 1e-6), 0.0, 1.0);
+    return length(p - a - ab * t);
+}
+
+void main()
+{
+    vec2 device = vec2(gl_FragCoord.x, uFramebufferHeight - gl_FragCoord.y);
+    vec2 p = device / uDpr;
+    vec3 color = vec3(0.0);
+
+    if (dot(p - uOutlineP1, uNormal) >= 0.0) {
+        float t = dot(device, uHatchNormal) / uHatchSpacing;
+        float distance = abs(t - floor(t + 0.5)) * uHatchSpacing;
+        float coverage = clamp(uHatchHalfWidth + 0.5 - distance, 0.0, 1.0);
+        color = mix(color, uHatchColor.rgb, uHatchColor.a * coverage);
+    }
+
+    float outline = clamp(1.5 - segmentDistance(p, uOutlineP1, uOutlineP2), 0.0, 1.0);
+    color = mix(color, vec3(1.0), outline);
+    float beam = clamp(2.5 - segmentDistance(p, uFarEnd, uShipPos), 0.0, 1.0);
+    color = mix(color, vec3(0.0, 1.0, 0.0), beam);
+    fragColor = vec4(color, 1.0);
+}
+)";
+
+// Quad corner of a triangle strip from gl_VertexID
+static const char kDiscVertex[] = R"(#version 330 core
+layout(location = 0) in vec3 aDisc;
+layout(location = 1) in vec4 aColor;
+uniform vec2 uViewport;
+out vec2 vLocal;
+flat out float vRadius;
+flat out vec4 vColor;
+
+void main()
+{
+    vec2 corner = vec2((gl_VertexID & 1) * 2 - 1, (gl_VertexID >> 1) * 2 - 1);
+    vLocal = corner * (aDisc.z + 1.0);
+    vRadius = aDisc.z;
+    vColor = aColor;
+    vec2 p = aDisc.xy + vLocal;
+    gl_Position = vec4(p.x / uViewport.x * 2.0 - 1.0, 1.0 - p.y / uViewport.y * 2.0, 0.0, 1.0);
+}
+)";
+
+static const char kDiscFragment[] = R"(#version 330 core
+in vec2 vLocal;
+flat in float vRadius;
+flat in vec4 vColor;
+out vec4 fragColor;
+
+void main()
+{
+    float coverage = clamp(vRadius + 0.5 - length(vLocal), 0.0, 1.0);
+    if (coverage <= 0.0)
+        discard;
+    fragColor = vec4(vColor.rgb, vColor.a * coverage);
+}
+)";
+
+// Quad around the segment, extended by the half width plus one pixel
+static const char kCapsuleVertex[] = R"(#version 330 core
+layout(location = 0) in vec4 aSegment;
+layout(location = 1) in float aHalfWidth;
+layout(location = 2) in vec4 aColor;
+uniform vec2 uViewport;
+out vec2 vPos;
+flat out vec4 vSegment;
+flat out float vHalfWidth;
+flat out vec4 vColor;
+
+void main()
+{
+    vec2 corner = vec2((gl_VertexID & 1) * 2 - 1, (gl_VertexID >> 1) * 2 - 1);
+    vec2 a = aSegment.xy, b = aSegment.zw;
+    float len = length(b - a);
+    vec2 u = len > 0.0 ? (b - a) / len : vec2(1.0, 0.0);
+    vec2 n = vec2(-u.y, u.x);
+    float ext = aHalfWidth + 1.0;
+    vec2 p = (corner.x < 0.0 ? a - u * ext : b + u * ext) + n * (corner.y * ext);
+    vPos = p;
+    vSegment = aSegment;
+    vHalfWidth = aHalfWidth;
+    vColor = aColor;
+    gl_Position = vec4(p.x / uViewport.x * 2.0 - 1.0, 1.0 - p.y / uViewport.y * 2.0, 0.0, 1.0);
+}
+)";
+
+static const char kCapsuleFragment[] = R"(#version 330 core
+in vec2 vPos;
+flat in vec4 vSegment;
+flat in float vHalfWidth;
+flat in vec4 vColor;
+out vec4 fragColor;
+
+void main()
+{
+    vec2 a = vSegment.xy, ab = vSegment.zw - vSegment.xy;
+    float t = clamp(dot(vPos - a, ab) / max(dot(ab, ab), 1e-6), 0.0, 1.0);
+    float coverage = clamp(vHalfWidth + 0.5 - length(vPos - a - ab * t), 0.0, 1.0);
+    if (coverage <= 0.0)
+        discard;
+    fragColor = vec4(vColor.rgb, vColor.a * coverage);
+}
+)";
+
+// Vertex gl_VertexID of the instance's triangle
+static const char kTriangleVertex[] = R"(#version 330 core
+layout(location = 0) in vec4 aP0P1;
+layout(location = 1) in vec2 aP2;
+layout(location = 2) in vec4 aColor;
+uniform vec2 uViewport;
+flat out vec4 vColor;
+
+void main()
+{
+    vec2 p = gl_VertexID == 0 ? aP0P1.xy : gl_VertexID == 1 ? aP0P1.zw : aP2;
+    vColor = aColor;
+    gl_Position = vec4(p.x / uViewport.x * 2.0 - 1.0, 1.0 - p.y / uViewport.y * 2.0, 0.0, 1.0);
+}
+)";
+
+static const char kTriangleFragment[] = R"(#version 330 core
+flat in vec4 vColor;
+out vec4 fragColor;
+
+void main()
+{
+    fragColor = vColor;
+}
+)";
+
+/**
+ * @brief Appends a colour as four floats (0..1)
+ */
+static void appendColor(QVector<float> &out, const QColor &color)
+{
+    out << float(color.redF()) << float(color.greenF())
+        << float(color.blueF()) << float(color.alphaF());
+}
+
+// ===== TSAGLWidget =====
+
+/**
+ * @brief Constructor - starts the simulation; GL setup waits for initializeGL()
+ * @param scenario Own ship, contacts and sensor line to display
+ * @param parent Parent widget (optional)
+ */
+TSAGLWidget::TSAGLWidget(const Scenario &scenario, QWidget *parent)
+    : QOpenGLWidget(parent),
+      sim(new SimHost(scenario, this)),
+      perf_overlay_enabled(false),
+      gl_ready(false),
+      disc_buffer(QOpenGLBuffer::VertexBuffer),
+      capsule_buffer(QOpenGLBuffer::VertexBuffer),
+      triangle_buffer(QOpenGLBuffer::VertexBuffer)
+{
+    setFormat(requiredFormat());
+    renderer.setBackgroundCacheEnabled(false);
+    renderer.setSensorLine(scenario.sensor_start, scenario.sensor_end);
+
+    // Repaint when a new snapshot is available (queued to the GUI thread)
+    connect(sim, &SimHost::snapshotPublished, this, &TSAGLWidget::onSnapshotPublished);
+}
+
+/**
+ * @brief Destructor - releases the GL resources in the widget's context
+ */
+TSAGLWidget::~TSAGLWidget()
+{
+    if (!gl_ready)
+        return;
+    makeCurrent();
+    disc_buffer.destroy();
+    capsule_buffer.destroy();
+    triangle_buffer.destroy();
+    background_vao.destroy();
+    disc_vao.destroy();
+    capsule_vao.destroy();
+    triangle_vao.destroy();
+    background_program.removeAllShaders();
+    disc_program.removeAllShaders();
+    capsule_program.removeAllShaders();
+    triangle_program.removeAllShaders();
+    doneCurrent();
+}
+
+/**
+ * @brief Surface format the widget needs (OpenGL 3.3 core)
+ */
+QSurfaceFormat TSAGLWidget::requiredFormat()
+{
+    QSurfaceFormat format;
+    format.setRenderableType(QSurfaceFormat::OpenGL);
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    format.setSwapInterval(0);          // frame times, not vsync
+    return format;
+}
+
+/**
+ * @brief true if an OpenGL context of requiredFormat() can be created
+ */
+bool TSAGLWidget::isSupported()
+{
+    QOpenGLContext context;
+    context.setFormat(requiredFormat());
+    if (!context.create())
+        return false;
+    const QSurfaceFormat format = context.format();
+    return format.version() >= qMakePair(3, 3);
+}
+
+void TSAGLWidget::setSimulationStep(double step_sec)
+{
+    sim->setStep(step_sec);
+}
+
+void TSAGLWidget::setSensorLine(const QPointF &start, const QPointF &end)
+{
+    renderer.setSensorLine(start, end);
+    update();
+}
+
+void TSAGLWidget::setHatchStyle(const HatchStyle &style)
+{
+    renderer.setHatchStyle(style);
+    update();
+}
+
+void TSAGLWidget::setConfig(const DisplayConfig &config)
+{
+    const unsigned changes = renderer.setConfig(config);
+    if (changes & DisplayConfig::SimStep)
+        sim->setStep(config.step_sec);
+    if (changes & ~DisplayConfig::SimStep)
+        update();
+}
+
+void TSAGLWidget::setPerfOverlayEnabled(bool enabled)
+{
+    perf_overlay_enabled = enabled;
+    update();
+}
+
+void TSAGLWidget::startRecording(const QString &path)
+{
+    sim->startRecording(path);
+}
+
+void TSAGLWidget::startReplay(const QString &path)
+{
+    sim->startReplay(path);
+}
+
+/**
+ * @brief Takes the new snapshot and schedules a repaint
+ *
+ * QOpenGLWidget always repaints completely, so there is no damage to
+ * compute.
+ */
+void TSAGLWidget::onSnapshotPublished()
+{
+    if (sim->takeSnapshot())
+        update();
+}
+
+/**
+ * @brief Compiles and links one shader program
+ * @return false (with a warning) on a compile or link error
+ */
+bool TSAGLWidget::buildProgram(QOpenGLShaderProgram &program, const char *vertex,
+                               const char *fragment)
+{
+    if (!program.addShaderFromSourceCode(QOpenGLShader::Vertex, vertex)
+            || !program.addShaderFromSourceCode(QOpenGLShader::Fragment, fragment)
+            || !program.link()) {
+        qWarning().noquote() << "TSAGLWidget: shader error:" << program.log();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Binds an instance buffer to a vertex array
+ *
+ * Attributes are tightly packed floats at locations 0, 1, ... and
+ * advance once per instance. The buffer is re-filled every frame with
+ * allocate(), which keeps its name, so the vertex array stays valid.
+ */
+void TSAGLWidget::setupInstanceArray(QOpenGLVertexArrayObject &vao, QOpenGLBuffer &buffer,
+                                     std::initializer_list<int> sizes)
+{
+    int stride = 0;
+    for (int size : sizes)
+        stride += size;
+
+    vao.create();
+    vao.bind();
+    buffer.create();
+    buffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    buffer.bind();
+    GLuint location = 0;
+    int offset = 0;
+    for (int size : sizes) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, stride * sizeof(float),
+                              reinterpret_cast<const void *>(offset * sizeof(float)));
+        glVertexAttribDivisor(location, 1);
+        offset += size;
+        ++location;
+    }
+    vao.release();
+    buffer.release();
+}
+
+/**
+ * @brief Compiles the shaders and sets up buffers and vertex arrays
+ */
+void TSAGLWidget::initializeGL()
+{
+    initializeOpenGLFunctions();
+    qInfo().noquote() << "TSAGLWidget: OpenGL"
+                      << reinterpret_cast<const char *>(glGetString(GL_VERSION))
+                      << "on" << reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+
+    gl_ready = buildProgram(background_program, kBackgroundVertex, kBackgroundFragment)
+               && buildProgram(disc_program, kDiscVertex, kDiscFragment)
+               && buildProgram(capsule_program, kCapsuleVertex, kCapsuleFragment)
+               && buildProgram(triangle_program, kTriangleVertex, kTriangleFragment);
+    if (!gl_ready)
+        return;
+
+    background_vao.create();
+    setupInstanceArray(disc_vao, disc_buffer, { 3, 4 });
+    setupInstanceArray(capsule_vao, capsule_buffer, { 4, 1, 4 });
+    setupInstanceArray(triangle_vao, triangle_buffer, { 4, 2, 4 });
+}
+
+/**
+ * @brief Fills the instance arrays from the renderer's layout
+ *
+ * Contact dots and markers become discs. Every arrow becomes a capsule
+ * for its shaft, a triangle for its head and three capsules outlining
+ * the head with the shaft pen, as the raster path strokes its head
+ * polygons.
+ */
+void TSAGLWidget::buildInstances(const TSARenderer::DynamicLayer &layer)
+{
+    discs.resize(0);
+    capsules.resize(0);
+    triangles.resize(0);
+
+    const QColor contactColor(TSARenderer::kContactColor);
+    const QColor shadedColor(TSARenderer::kShadedContactColor);
+    for (int k = 0; k < layer.contacts.size(); ++k) {
+        const QPointF &c = layer.contacts[k];
+        discs << float(c.x()) << float(c.y()) << float(TSARenderer::kContactRadius);
+        appendColor(discs, k < layer.shaded_begin ? contactColor : shadedColor);
+    }
+    for (const TSARenderer::MarkerItem &m : layer.markers) {
+        discs << float(m.center.x()) << float(m.center.y()) << float(m.radius);
+        appendColor(discs, m.color);
+    }
+
+    const ArrowBatch &arrows = layer.arrows;
+    for (int g = 0; g < arrows.groupCount(); ++g) {
+        const QColor color = arrows.groupColor(g);
+        const float halfWidth = arrows.groupWidth(g) * 0.5f;
+        for (const QLineF &shaft : arrows.groupShafts(g)) {
+            capsules << float(shaft.x1()) << float(shaft.y1())
+                     << float(shaft.x2()) << float(shaft.y2()) << halfWidth;
+            appendColor(capsules, color);
+        }
+        const QVector<QPointF> &heads = arrows.groupHeads(g);
+        for (int v = 0; v + 2 < heads.size(); v += 3) {
+            for (int k = 0; k < 3; ++k) {
+                triangles << float(heads[v + k].x()) << float(heads[v + k].y());
+                const QPointF &a = heads[v + k];
+                const QPointF &b = heads[v + (k + 1) % 3];
+                capsules << float(a.x()) << float(a.y()) << float(b.x()) << float(b.y())
+                         << halfWidth;
+                appendColor(capsules, color);
+            }
+            appendColor(triangles, color);
+        }
+    }
+}
+
+/**
+ * @brief Draws the current snapshot
+ *
+ * One full-screen pass for the static layer, then one instanced draw
+ * each for discs, capsules and head triangles. The timing overlay is
+ * drawn with QPainter over the GL content.
+ */
+void TSAGLWidget::paintGL()
+{
+    if (!gl_ready)
+        return;
+
+    PERF_SCOPE(PerfSection::Frame);
+    const qreal dpr = devicePixelRatioF();
+    const QSize logical = size();
+
+    {
+        PERF_SCOPE(PerfSection::GlUpload);
+        buildInstances(renderer.layout(logical, dpr, sim->snapshot()));
+        disc_buffer.bind();
+        disc_buffer.allocate(discs.constData(), discs.size() * int(sizeof(float)));
+        capsule_buffer.bind();
+        capsule_buffer.allocate(capsules.constData(), capsules.size() * int(sizeof(float)));
+        triangle_buffer.bind();
+        triangle_buffer.allocate(triangles.constData(), triangles.size() * int(sizeof(float)));
+        triangle_buffer.release();
+    }
+
+    {
+        PERF_SCOPE(PerfSection::GlDraw);
+        const TSARenderer::BeamGeometry &geom = renderer.beamGeometry();
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_BLEND);
+
+        background_program.bind();
+        background_program.setUniformValue("uDpr", GLfloat(dpr));
+        background_program.setUniformValue("uFramebufferHeight", GLfloat(logical.height() * dpr));
+        background_program.setUniformValue("uOutlineP1", geom.outlineP1);
+        background_program.setUniformValue("uOutlineP2", geom.outlineP2);
+        background_program.setUniformValue("uNormal", geom.normal);
+        background_program.setUniformValue("uFarEnd", geom.farEnd);
+        background_program.setUniformValue("uShipPos", geom.shipPos);
+        const HatchStyle &hatch = renderer.hatchStyle();
+        const qreal hatchAngle = qDegreesToRadians(hatch.angle_deg);
+        background_program.setUniformValue("uHatchNormal", QPointF(qSin(hatchAngle), qCos(hatchAngle)));
+        background_program.setUniformValue("uHatchSpacing", GLfloat(qMax(1.0, hatch.spacing * dpr)));
+        background_program.setUniformValue("uHatchHalfWidth", GLfloat(0.5 * qMax(0.5, hatch.line_width * dpr)));
+        background_program.setUniformValue("uHatchColor", hatch.color);
+        background_vao.bind();
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        background_vao.release();
+
+        glEnable(GL_BLEND);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        const QSizeF viewport(logical);
+
+        disc_program.bind();
+        disc_program.setUniformValue("uViewport", viewport);
+        disc_vao.bind();
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, discs.size() / kDiscFloats);
+        disc_vao.release();
+
+        capsule_program.bind();
+        capsule_program.setUniformValue("uViewport", viewport);
+        capsule_vao.bind();
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, capsules.size() / kCapsuleFloats);
+        capsule_vao.release();
+
+        triangle_program.bind();
+        triangle_program.setUniformValue("uViewport", viewport);
+        triangle_vao.bind();
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 3, triangles.size() / kTriangleFloats);
+        triangle_vao.release();
+        triangle_program.release();
+    }
+
+    if (perf_overlay_enabled) {
+        QPainter p(this);
+        TSARenderer::drawPerfOverlay(p);
+    }
+}
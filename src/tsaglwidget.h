@@ -0,0 +1,145 @@
+#ifndef TSAGLWIDGET_H
+#define TSAGLWIDGET_H
+
+#include <QOpenGLBuffer>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QOpenGLWidget>
+#include <QSurfaceFormat>
+#include <QVector>
+#include <initializer_list>
+#include "simulation.h"
+#include "tsarenderer.h"
+
+class SimHost;
+
+/**
+ * @brief TSAGLWidget - OpenGL variant of TSAWidget
+ *
+ * Shows the same display as TSAWidget but draws it with OpenGL 3.3 core
+ * instead of QPainter's raster engine:
+ * - the black background, the hatched half-space, the white outline and
+ *   the green beam are one full-screen triangle whose fragment shader
+ *   tests the half-plane and the line distances per pixel;
+ * - markers and contact dots are instanced discs, arrow shafts and head
+ *   outlines instanced capsules, arrow heads instanced triangles, all
+ *   antialiased in the fragment shaders.
+ *
+ * The layout (positions, vectors, colours) comes from the same
+ * TSARenderer as the raster path, so both show identical content. Needs
+ * no GPU: Mesa's llvmpipe rasterizer provides OpenGL 3.3 core. The
+ * replay timeline slider is raster-only; replays play through here.
+ */
+class TSAGLWidget : public QOpenGLWidget, protected QOpenGLExtraFunctions
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the OpenGL display for a scenario
+     * @param scenario Own ship, contacts and sensor line to display
+     * @param parent Parent widget (optional)
+     */
+    explicit TSAGLWidget(const Scenario &scenario, QWidget *parent = nullptr);
+
+    /**
+     * @brief Releases the GL resources and stops the simulation thread
+     */
+    ~TSAGLWidget() override;
+
+    /**
+     * @brief Surface format the widget needs (OpenGL 3.3 core)
+     *
+     * Set as the default format before the application object is created.
+     */
+    static QSurfaceFormat requiredFormat();
+
+    /**
+     * @brief true if an OpenGL context of requiredFormat() can be created
+     *
+     * Call after the application object exists; when it fails the caller
+     * falls back to the raster TSAWidget.
+     */
+    static bool isSupported();
+
+    void setSimulationStep(double step_sec);                    ///< Fixed simulation step (seconds)
+    void setSensorLine(const QPointF &start, const QPointF &end);  ///< Moves the sensor beam line
+    void setHatchStyle(const HatchStyle &style);                ///< Hatch spacing, angle, width and colour
+    void setConfig(const DisplayConfig &config);                ///< Display and simulation parameters
+    void setPerfOverlayEnabled(bool enabled);                   ///< Shows or hides the timing overlay
+    void startRecording(const QString &path);                   ///< Records every step to a file
+    void startReplay(const QString &path);                      ///< Shows a recording instead
+
+protected:
+    /**
+     * @brief Compiles the shaders and sets up buffers and vertex arrays
+     */
+    void initializeGL() override;
+
+    /**
+     * @brief Draws the current snapshot
+     */
+    void paintGL() override;
+
+private slots:
+    /**
+     * @brief Takes the new snapshot and schedules a repaint
+     */
+    void onSnapshotPublished();
+
+private:
+    /**
+     * @brief Fills the instance arrays from the renderer's layout
+     * @param layer Dynamic layer of the frame
+     */
+    void buildInstances(const TSARenderer::DynamicLayer &layer);
+
+    /**
+     * @brief Compiles and links one shader program
+     * @return false (with a warning) on a compile or link error
+     */
+    static bool buildProgram(QOpenGLShaderProgram &program, const char *vertex,
+                             const char *fragment);
+
+    /**
+     * @brief Binds an instance buffer to a vertex array
+     * @param vao Vertex array to set up
+     * @param buffer Instance buffer
+     * @param sizes Float count of each attribute, locations 0, 1, ...
+     */
+    void setupInstanceArray(QOpenGLVertexArrayObject &vao, QOpenGLBuffer &buffer,
+                            std::initializer_list<int> sizes);
+
+    // ===== SIMULATION =====
+
+    SimHost *sim;                     ///< Simulation thread and snapshot handoff (child object)
+
+    // ===== LAYOUT =====
+
+    TSARenderer renderer;             ///< Layout only (static layer cache disabled)
+    bool perf_overlay_enabled;        ///< Draw the timing overlay with QPainter on top
+
+    // ===== GL RESOURCES =====
+
+    bool gl_ready;                    ///< initializeGL() succeeded
+    QOpenGLShaderProgram background_program;  ///< Full-screen hatch, outline and beam
+    QOpenGLShaderProgram disc_program;        ///< Instanced antialiased discs
+    QOpenGLShaderProgram capsule_program;     ///< Instanced round-capped segments
+    QOpenGLShaderProgram triangle_program;    ///< Instanced filled triangles
+    QOpenGLVertexArrayObject background_vao;  ///< Empty: the triangle comes from gl_VertexID
+    QOpenGLVertexArrayObject disc_vao;
+    QOpenGLVertexArrayObject capsule_vao;
+    QOpenGLVertexArrayObject triangle_vao;
+    QOpenGLBuffer disc_buffer;        ///< Per disc: centre x, y, radius, r, g, b, a
+    QOpenGLBuffer capsule_buffer;     ///< Per capsule: x1, y1, x2, y2, half width, r, g, b, a
+    QOpenGLBuffer triangle_buffer;    ///< Per triangle: x0, y0, x1, y1, x2, y2, r, g, b, a
+
+    // ===== INSTANCE STAGING (reused every frame) =====
+
+    QVector<float> discs;             ///< kDiscFloats per instance
+    QVector<float> capsules;          ///< kCapsuleFloats per instance
+    QVector<float> triangles;         ///< kTriangleFloats per instance
+};
+
+#endif // TSAGLWIDGET_H
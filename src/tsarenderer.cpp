@@ -0,0 +1,590 @@
+#include "tsarenderer.h"
+#include "geometry.h"
+#include "halfplanekernel.h"
+#include "perfstats.h"
+#include <QFont>
+#include <QFontMetrics>
+#include <QPainterPath>
+#include <QStringList>
+#include <QtMath>
+#include <cmath>
+
+/**
+ * @brief Constructor - sets the default sensor beam line
+ */
+TSARenderer::TSARenderer()
+    : background_valid(false),
+      background_cache_enabled(true),
+      background_dpr(1.0),
+      hatch_tile_dpr(0.0),
+      sensor_line_start(80, 480),   // Sensor beam start point
+      sensor_line_end(720, 80),     // Sensor beam end point
+      perf_overlay_enabled(false)
+{
+}
+
+/**
+ * @brief Gets own ship position on the display
+ * @return QPointF representing ship position in widget coordinates
+ */
+QPointF TSARenderer::getShipPosition() const
+{
+    return sensor_line_start + config.ship_fraction * (sensor_line_end - sensor_line_start);
+}
+
+
+
+/**
+ * @brief Gets sensor position on the display
+ * @return QPointF representing sensor position in widget coordinates
+ */
+QPointF TSARenderer::getSensorPosition() const
+{
+    return sensor_line_start + config.sensor_fraction * (sensor_line_end - sensor_line_start);
+}
+
+const QRgb TSARenderer::kContactColor = qRgb(255, 165, 0);
+const QRgb TSARenderer::kShadedContactColor = qRgb(128, 96, 48);
+const qreal TSARenderer::kContactRadius = 2.5;
+const QRgb TSARenderer::kEstimateColor = qRgb(255, 0, 255);
+
+/**
+ * @brief Own ship vector of a snapshot: own_vector_px_per_knot along the
+ * course (screen Y points down)
+ */
+QPointF TSARenderer::shipVectorFor(const SimSnapshot &snap) const
+{
+    const double S_own = snap.own_speed * config.own_vector_px_per_knot;
+    const double C_own = qDegreesToRadians(snap.own_course);
+    return QPointF(S_own * qSin(C_own), -S_own * qCos(C_own));
+}
+
+/**
+ * @brief Lays out markers and vectors for a snapshot
+ *
+ * Every contact is classified against the shaded region (beyond the
+ * outline, on the side away from the own ship vector) in one batch; the
+ * contacts in view are then partitioned so the ones outside come first
+ * and each group is drawn in one call with its own colour.
+ *
+ * @param snap Simulation state to draw
+ * @param shipVector Own ship vector in widget coordinates
+ * @param layer Receives the items and their bounds
+ */
+void TSARenderer::layoutDynamicLayer(const SimSnapshot &snap, const QPointF &shipVector,
+                                     DynamicLayer &layer) const
+{
+    const BeamGeometry &geom = background_geometry;
+    layer.contacts.resize(0);
+    layer.contact_tracks.resize(0);
+    layer.shaded_begin = 0;
+    layer.markers.resize(0);
+    layer.arrows.clear();
+
+    // Contacts around own ship (north up), each with a velocity leader
+    QRectF bounds;
+    const int n = snap.trackCount();
+    if (n > 0) {
+        const double *rx = snap.rel_x.constData();
+        const double *ry = snap.rel_y.constData();
+        const double *course = snap.course.constData();
+        const double *speed = snap.speed.constData();
+        const QColor contactColor(kContactColor);
+        const QColor shadedColor(kShadedContactColor);
+        const qreal pxPerNm = config.contact_px_per_nm;
+        const qreal leaderPxPerKnot = config.leader_px_per_knot;
+
+        // Cull contacts whose dot and leader cannot reach the target: the
+        // view rectangle in relative nm, widened by the longest leader
+        QVector<int> &visible = layer.culled;
+        if (pxPerNm > 0.0 && snap.grid.size() == n) {
+            const qreal reach = (kContactRadius + 2.0 + snap.max_speed * leaderPxPerKnot) / pxPerNm;
+            const QPointF ship = geom.shipPos;
+            snap.grid.queryRect(-ship.x() / pxPerNm - reach,
+                                (ship.y() - background_size.height()) / pxPerNm - reach,
+                                (background_size.width() - ship.x()) / pxPerNm + reach,
+                                ship.y() / pxPerNm + reach, visible);
+        } else {
+            visible.resize(n);
+            for (int i = 0; i < n; ++i)
+                visible[i] = i;
+        }
+
+        // Shaded region in relative nm (Y north): normal . (x, -y) beyond
+        // the outline gap, i.e. left of the line (0,0) -> (-normal.y, -normal.x)
+        layer.shaded_mask.resize(halfPlaneMaskWords(n));
+        if (pxPerNm > 0.0)
+            classifyHalfPlaneBatch(rx, ry, n, 0.0, 0.0, -geom.normal.y(), -geom.normal.x(),
+                                   config.outline_gap / pxPerNm, layer.shaded_mask.data());
+        else
+            layer.shaded_mask.fill(0);
+        const quint64 *shaded = layer.shaded_mask.constData();
+
+        // Partition without branching: each track is written to both open
+        // ends and only the cursor of its group moves
+        const int shown = visible.size();
+        layer.contact_tracks.resize(shown);
+        int *order = layer.contact_tracks.data();
+        int front = 0, back = shown;
+        for (int k = 0; k < shown; ++k) {
+            const int i = visible[k];
+            const int s = halfPlaneBit(shaded, i);
+            order[front] = i;
+            order[back - 1] = i;
+            front += 1 - s;
+            back -= s;
+        }
+        layer.shaded_begin = front;
+
+        layer.contacts.resize(shown);
+        qreal min_x = geom.shipPos.x(), max_x = min_x;
+        qreal min_y = geom.shipPos.y(), max_y = min_y;
+        for (int k = 0; k < shown; ++k) {
+            const int i = order[k];
+            const QPointF pos(geom.shipPos.x() + rx[i] * pxPerNm,
+                              geom.shipPos.y() - ry[i] * pxPerNm);
+            layer.contacts[k] = pos;
+            min_x = qMin(min_x, pos.x()); max_x = qMax(max_x, pos.x());
+            min_y = qMin(min_y, pos.y()); max_y = qMax(max_y, pos.y());
+            if (speed[i] > 0)
+                layer.arrows.addCourse(pos, course[i], speed[i] * leaderPxPerKnot, 5, 25,
+                                       k < front ? contactColor : shadedColor, 1);
+        }
+        const qreal margin = kContactRadius + 2.0;
+        bounds = QRectF(QPointF(min_x, min_y), QPointF(max_x, max_y))
+                     .adjusted(-margin, -margin, margin, margin);
+    }
+
+    // Markers
+    const MarkerItem ship = { geom.shipPos, 6, Qt::yellow };
+    const MarkerItem sensor = { geom.sensorPos, 6, Qt::red };
+    layer.markers.append(ship);
+    layer.markers.append(sensor);
+
+    // Own ship vector
+    layer.arrows.add(geom.shipPos, geom.shipPos + shipVector, 12, 25, Qt::cyan, 3);
+
+    // FIXED: Target vector - reverse direction
+    const QPointF targetStart = geom.sensorPos;
+    const QPointF targetEnd = targetStart + (-geom.normal) * config.target_vector_px; // Flip direction with -normal
+    layer.arrows.add(targetStart, targetEnd, 12, 25, Qt::red, 3);
+
+    // Kalman filter course and speed of the adopted track, from the same
+    // origin and on the own ship vector's scale
+    const int adopted = snap.adopted_track;
+    if (adopted >= 0 && adopted < snap.ekf_valid.size() && snap.ekf_valid[adopted]
+            && snap.ekf_speed[adopted] > 0)
+        layer.arrows.addCourse(targetStart, snap.ekf_course[adopted],
+                               snap.ekf_speed[adopted] * config.own_vector_px_per_knot,
+                               12, 25, QColor(kEstimateColor), 3);
+
+    for (const MarkerItem &m : layer.markers) {
+        const qreal r = m.radius + 2.0;
+        bounds |= QRectF(m.center.x() - r, m.center.y() - r, 2 * r, 2 * r);
+    }
+    bounds |= layer.arrows.bounds();
+    layer.bounds = bounds;
+}
+
+/**
+ * @brief Track under a point of the display
+ * @param snap Snapshot on screen
+ * @param pos Point in target coordinates
+ * @param radius_px Pick tolerance (pixels)
+ * @return Track index, -1 if no contact is within the tolerance
+ */
+int TSARenderer::pickTrack(const SimSnapshot &snap, const QPointF &pos, qreal radius_px) const
+{
+    const qreal pxPerNm = config.contact_px_per_nm;
+    if (!(pxPerNm > 0.0) || snap.grid.size() != snap.trackCount())
+        return -1;
+    const QPointF ship = background_geometry.shipPos;
+    return snap.grid.nearest((pos.x() - ship.x()) / pxPerNm, (ship.y() - pos.y()) / pxPerNm,
+                             radius_px / pxPerNm);
+}
+
+/**
+ * @brief Computes the beam, outline and shaded half-space geometry
+ * 
+ * Depends only on the widget bounds, the sensor line and the own ship
+ * vector direction, so the result is cached together with the background.
+ * 
+ * @param bounds Widget rectangle
+ * @param shipVector Own ship vector in widget coordinates
+ * @return Geometry of the static layer
+ */
+TSARenderer::BeamGeometry TSARenderer::computeBeamGeometry(const QRectF &bounds,
+                                                       const QPointF &shipVector) const
+{
+    BeamGeometry geom;
+    geom.sensorPos = getSensorPosition();
+    geom.shipPos = getShipPosition();
+    const QPointF &shipPos = geom.shipPos;
+    
+    // Get full-screen line 
+    const ClippedLine full = computeFullLine(geom.sensorPos, shipPos, bounds);
+    QPointF P1 = full.p1, P2 = full.p2;
+    
+    // Find far end
+    double dist1 = std::hypot(P1.x() - shipPos.x(), P1.y() - shipPos.y());
+    QPointF farEnd = (dist1 > std::hypot(P2.x() - shipPos.x(), P2.y() - shipPos.y())) ? P1 : P2;
+    geom.farEnd = farEnd;
+    
+    // Create normal vector
+    QPointF dir = shipPos - farEnd;
+    QPointF normal(-dir.y(), dir.x());
+    normal /= std::hypot(normal.x(), normal.y());
+    
+    // FIXED: Check which side the ship vector points to, then shade OPPOSITE side
+    QPointF testPoint = shipPos + shipVector;
+    
+    bool shipVectorLeft = sideOfLine(farEnd, shipPos, testPoint) > 0;
+    if (shipVectorLeft) {
+        // Ship vector on LEFT, so shade RIGHT (flip normal)
+        normal = -normal;
+    }
+    // If ship vector on RIGHT, shade LEFT (keep normal)
+    geom.normal = normal;
+    
+    // FIXED: Create a proper polygon that covers the entire shaded half-space
+    const qreal gap = config.outline_gap;
+    QPointF offsetStart = farEnd + normal * gap;
+    QPointF offsetEnd = shipPos + normal * gap;
+    
+    // Get full-screen line for the white outline (extended to boundaries)
+    const ClippedLine fullOutline = computeFullLine(offsetStart, offsetEnd, bounds);
+    geom.outlineP1 = fullOutline.p1;
+    geom.outlineP2 = fullOutline.p2;
+    
+    // Build polygon with screen corners on the shaded side
+    QVector<QPointF> corners = {bounds.topLeft(), bounds.topRight(), 
+                                bounds.bottomRight(), bounds.bottomLeft()};
+    
+    // Add corners that are on the shaded side
+    for (auto &corner : corners) {
+        bool cornerOnShadedSide = (sideOfLine(farEnd, shipPos, corner) > 0) == !shipVectorLeft;
+        if (cornerOnShadedSide) {
+            geom.shadedRegion << corner;
+        }
+    }
+    
+    // Add the extended outline line points
+    geom.shadedRegion << geom.outlineP2 << geom.outlineP1;
+    return geom;
+}
+
+/**
+ * @brief Draws the static layer: background, hatch, outline and beam
+ * @param p QPainter reference for drawing
+ * @param geom Geometry from computeBeamGeometry()
+ * @param bounds Area to clear to black
+ */
+void TSARenderer::drawStaticLayer(QPainter &p, const BeamGeometry &geom, const QRect &bounds)
+{
+    p.setRenderHint(QPainter::Antialiasing);
+    p.fillRect(bounds, Qt::black);
+
+    // Fill with hatching (tile anchored at the screen origin)
+    p.setBrush(hatchBrush(p.device()->devicePixelRatioF()));
+    p.setBrushOrigin(0, 0);
+    p.setPen(Qt::NoPen);
+    p.drawPolygon(geom.shadedRegion);
+    
+    // Add white outline (extended to screen boundaries)
+    p.setPen(QPen(Qt::white, 2, Qt::SolidLine));
+    p.drawLine(geom.outlineP1, geom.outlineP2);
+    
+    // Draw green bearing line
+    p.setPen(QPen(Qt::green, 4, Qt::SolidLine, Qt::RoundCap));
+    p.drawLine(geom.farEnd, geom.shipPos);
+}
+
+/**
+ * @brief Brush for the shaded half-space on a target with this DPR
+ * @param dpr Device pixel ratio of the painter's device
+ * @return Tile texture brush, or the Qt::BDiagPattern brush
+ */
+QBrush TSARenderer::hatchBrush(qreal dpr)
+{
+    const HatchStyle &hatch = config.hatch;
+    if (hatch.fill == HatchStyle::Fill::Pattern)
+        return QBrush(hatch.color, Qt::BDiagPattern);
+
+    if (hatch_tile.isNull() || hatch_tile_dpr != dpr) {
+        hatch_tile = QPixmap::fromImage(renderHatchTile(hatch, dpr).image);
+        hatch_tile_dpr = dpr;
+    }
+    return QBrush(hatch_tile);
+}
+
+/**
+ * @brief Sets how the shaded half-space is hatched and invalidates the static layer
+ * @param style Fill method, spacing, angle, width and colour
+ */
+void TSARenderer::setHatchStyle(const HatchStyle &style)
+{
+    DisplayConfig display = config;
+    display.hatch = style;
+    setConfig(display);
+}
+
+/**
+ * @brief Applies display parameters, invalidating only what depends on them
+ *
+ * Values are copied into the existing members; the static layer pixmap
+ * is rebuilt in place at the next frame and the tile only when a hatch
+ * line parameter changed.
+ *
+ * @param display New parameters
+ * @return DisplayConfig::Change bits of what differed
+ */
+unsigned TSARenderer::setConfig(const DisplayConfig &display)
+{
+    const unsigned changes = display.changesFrom(config);
+    config = display;
+    if (changes & DisplayConfig::HatchTile)
+        hatch_tile = QPixmap();
+    if (changes & DisplayConfig::StaticLayer)
+        background_valid = false;
+    return changes;
+}
+
+/**
+ * @brief Rebuilds the cached static layer if its inputs changed
+ * 
+ * The cache is keyed on widget size, device pixel ratio, sensor line and
+ * own ship vector; everything else in the frame is drawn on top of it.
+ * 
+ * @param size Target size in device-independent pixels
+ * @param dpr Device pixel ratio of the target
+ * @param shipVector Own ship vector in widget coordinates
+ */
+void TSARenderer::ensureBackground(const QSize &size, qreal dpr, const QPointF &shipVector)
+{
+    if (!backgroundStale(size, dpr, shipVector))
+        return;
+
+    const QRect bounds(QPoint(0, 0), size);
+    background_geometry = computeBeamGeometry(bounds, shipVector);
+    background_size = size;
+    background_dpr = dpr;
+    background_ship_vector = shipVector;
+    background_valid = true;
+
+    if (!background_cache_enabled)
+        return;
+
+    PERF_SCOPE(PerfSection::RasterRebuild);
+    background_cache = QPixmap(size * dpr);
+    background_cache.setDevicePixelRatio(dpr);
+    QPainter p(&background_cache);
+    drawStaticLayer(p, background_geometry, bounds);
+}
+
+/**
+ * @brief true if the static layer must be rebuilt for these inputs
+ */
+bool TSARenderer::backgroundStale(const QSize &size, qreal dpr, const QPointF &shipVector) const
+{
+    return !background_valid || background_size != size || background_dpr != dpr
+           || background_ship_vector != shipVector;
+}
+
+/**
+ * @brief Moves the sensor beam line and invalidates the cached static layer
+ * @param start Start point of the beam (widget coordinates)
+ * @param end End point of the beam (widget coordinates)
+ */
+void TSARenderer::setSensorLine(const QPointF &start, const QPointF &end)
+{
+    sensor_line_start = start;
+    sensor_line_end = end;
+    background_valid = false;
+}
+
+/**
+ * @brief Enables or disables the cached static layer
+ * 
+ * With the cache disabled the static layer is rasterized on every
+ * repaint, as before; useful for measuring the gain.
+ * 
+ * @param enabled true to blit the cached pixmap
+ */
+void TSARenderer::setBackgroundCacheEnabled(bool enabled)
+{
+    background_cache_enabled = enabled;
+    background_valid = false;
+    background_cache = QPixmap();
+}
+
+/**
+ * @brief Area the dynamic layer of a snapshot will cover
+ *
+ * Lays the snapshot out against the current static layer without
+ * drawing; the overlay box of the last frame is included while the
+ * overlay is on.
+ *
+ * @param size Target size in device-independent pixels
+ * @param dpr Device pixel ratio of the target
+ * @param snap Simulation state about to be drawn
+ * @return Damage rectangle in target coordinates
+ */
+QRect TSARenderer::damageRect(const QSize &size, qreal dpr, const SimSnapshot &snap)
+{
+    const QRect full(QPoint(0, 0), size);
+    const QPointF shipVector = shipVectorFor(snap);
+    if (backgroundStale(size, dpr, shipVector))
+        return full;
+
+    layoutDynamicLayer(snap, shipVector, damage_layer);
+    QRect damage = damage_layer.bounds.toAlignedRect();
+    if (perf_overlay_enabled)
+        damage |= perf_overlay_rect;
+    return damage & full;
+}
+
+/**
+ * @brief Lays out one frame without drawing it, for other backends
+ * @param size Target size in device-independent pixels
+ * @param dpr Device pixel ratio of the target
+ * @param snap Simulation state to lay out
+ * @return Dynamic layer of the frame, valid until the next call
+ */
+const TSARenderer::DynamicLayer &TSARenderer::layout(const QSize &size, qreal dpr,
+                                                     const SimSnapshot &snap)
+{
+    const QPointF shipVector = shipVectorFor(snap);
+    ensureBackground(size, dpr, shipVector);
+    layoutDynamicLayer(snap, shipVector, dynamic_layer);
+    dynamic_bounds = dynamic_layer.bounds.toAlignedRect();
+    return dynamic_layer;
+}
+
+/**
+ * @brief Renders the tactical display for one snapshot
+ * 
+ * This method draws all visual elements in the correct order:
+ * 1. Static layer (black background, hatched half-space, white outline,
+ *    green beam), blitted from the cached pixmap
+ * 2. Contacts (dimmed inside the shaded region), ship and sensor markers
+ * 3. Contact velocity leaders, own ship and target vectors on top,
+ *    batched by style
+ * 
+ * With a dirty rectangle only that part of the static layer is blitted
+ * (or redrawn) and everything else is clipped to it, so the fill cost
+ * follows the damage instead of the target size.
+ * 
+ * @param p Active painter on the target device
+ * @param size Target size in device-independent pixels
+ * @param dpr Device pixel ratio of the target
+ * @param snap Simulation state to draw
+ * @param dirty Area to repaint; a null rectangle repaints everything
+ */
+void TSARenderer::render(QPainter &p, const QSize &size, qreal dpr, const SimSnapshot &snap,
+                         const QRect &dirty)
+{
+    const QPointF shipVector = shipVectorFor(snap);
+
+    PERF_SCOPE(PerfSection::Frame);
+
+    const QRect full(QPoint(0, 0), size);
+    const QRect area = dirty.isNull() ? full : (dirty & full);
+    ensureBackground(size, dpr, shipVector);
+    const BeamGeometry &geom = background_geometry;
+
+    p.save();
+    if (area != full)
+        p.setClipRect(area);
+
+    {
+        PERF_SCOPE(PerfSection::RasterStatic);
+        if (background_cache_enabled)
+            p.drawPixmap(QRectF(area), background_cache,
+                         QRectF(area.x() * dpr, area.y() * dpr,
+                                area.width() * dpr, area.height() * dpr));
+        else
+            drawStaticLayer(p, geom, area);
+    }
+
+    PERF_SCOPE(PerfSection::RasterDynamic);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    layoutDynamicLayer(snap, shipVector, dynamic_layer);
+    const int shadedBegin = dynamic_layer.shaded_begin;
+    const int contactCount = dynamic_layer.contacts.size();
+    if (shadedBegin > 0) {
+        p.setPen(QPen(QColor(kContactColor), 2 * kContactRadius, Qt::SolidLine, Qt::RoundCap));
+        p.drawPoints(dynamic_layer.contacts.constData(), shadedBegin);
+    }
+    if (contactCount > shadedBegin) {
+        p.setPen(QPen(QColor(kShadedContactColor), 2 * kContactRadius, Qt::SolidLine,
+                      Qt::RoundCap));
+        p.drawPoints(dynamic_layer.contacts.constData() + shadedBegin, contactCount - shadedBegin);
+    }
+    p.setPen(Qt::NoPen);
+    for (const MarkerItem &m : dynamic_layer.markers) {
+        p.setBrush(m.color);
+        p.drawEllipse(m.center, m.radius, m.radius);
+    }
+    dynamic_layer.arrows.draw(p);
+
+    dynamic_bounds = dynamic_layer.bounds.toAlignedRect();
+    if (perf_overlay_enabled) {
+        perf_overlay_rect = drawPerfOverlay(p);
+        dynamic_bounds |= perf_overlay_rect;
+    }
+    p.restore();
+}
+
+/**
+ * @brief Draws p50/p99/max of every recorded PerfSection
+ * 
+ * One line per section that has samples, in microseconds, on a
+ * translucent box. Values cover the current dump interval (or the whole
+ * run when no dumper resets the histograms). The overlay itself is
+ * counted in the RasterDynamic section. The box is sized for every
+ * section, so its damage does not grow when a section gets its first
+ * sample.
+ * 
+ * @param p QPainter reference for drawing
+ * @return Area of the overlay box
+ */
+QRect TSARenderer::drawPerfOverlay(QPainter &p)
+{
+    PerfStats &stats = PerfStats::instance();
+    QStringList lines;
+    lines << QStringLiteral("section          p50us   p99us   maxus");
+    for (int i = 0; i < static_cast<int>(PerfSection::Count); ++i) {
+        const PerfSection section = static_cast<PerfSection>(i);
+        const LatencyHistogram &h = stats.histogram(section);
+        if (h.count() == 0)
+            continue;
+        lines << QString("%1%2%3%4")
+                     .arg(QLatin1String(perfSectionName(section)), -15)
+                     .arg(h.percentile(0.50) / 1000.0, 8, 'f', 1)
+                     .arg(h.percentile(0.99) / 1000.0, 8, 'f', 1)
+                     .arg(h.max() / 1000.0, 8, 'f', 1);
+    }
+
+    p.save();
+    QFont font(QStringLiteral("monospace"));
+    font.setStyleHint(QFont::Monospace);
+    font.setPointSize(8);
+    p.setFont(font);
+    const QFontMetrics metrics(font);
+    const int lineHeight = metrics.height();
+    int width = 0;
+    for (const QString &line : lines)
+        width = qMax(width, metrics.horizontalAdvance(line));
+
+    const int maxLines = 1 + static_cast<int>(PerfSection::Count);
+    const QRect box(8, 8, width + 12, maxLines * lineHeight + 8);
+    p.setPen(Qt::NoPen);
+    p.setBrush(QColor(0, 0, 0, 180));
+    p.drawRect(box);
+    p.setPen(Qt::white);
+    for (int i = 0; i < lines.size(); ++i)
+        p.drawText(box.left() + 6, box.top() + 4 + metrics.ascent() + i * lineHeight, lines[i]);
+    p.restore();
+    return box;
+}
@@ -0,0 +1,302 @@
+#ifndef TSARENDERER_H
+#define TSARENDERER_H
+
+#include <QColor>
+#include <QPainter>
+#include <QPixmap>
+#include <QPointF>
+#include <QPolygonF>
+#include <QRectF>
+#include <QSize>
+#include "arrowbatch.h"
+#include "displayconfig.h"
+#include "hatchtile.h"
+#include "simulation.h"
+
+/**
+ * @brief TSARenderer - Draws a SimSnapshot as a tactical display
+ *
+ * Holds everything needed to paint a frame: the display geometry, the
+ * cached static layer and the drawing helpers. It paints onto any
+ * QPainter, so the same code renders TSAWidget and headless frames into
+ * a QImage. Must be used from the GUI thread (the cache is a QPixmap).
+ */
+class TSARenderer
+{
+public:
+    /**
+     * @brief Geometry of the static layer (beam, outline, shaded region)
+     */
+    struct BeamGeometry
+    {
+        QPointF sensorPos;            ///< Sensor marker position
+        QPointF shipPos;              ///< Own ship marker position
+        QPointF farEnd;               ///< Far end of the beam on the widget edge
+        QPointF normal;               ///< Unit normal pointing into the shaded side
+        QPointF outlineP1;            ///< White outline start (widget edge)
+        QPointF outlineP2;            ///< White outline end (widget edge)
+        QPolygonF shadedRegion;       ///< Hatched half-space polygon
+    };
+
+    /**
+     * @brief Filled circle of the dynamic layer
+     */
+    struct MarkerItem
+    {
+        QPointF center;               ///< Centre
+        qreal radius;                 ///< Radius
+        QColor color;                 ///< Fill colour
+    };
+
+    /**
+     * @brief Everything drawn over the static layer for one snapshot
+     *
+     * Laid out before drawing so the damage of a frame is known without
+     * painting it. Containers keep their capacity between frames.
+     */
+    struct DynamicLayer
+    {
+        QVector<QPointF> contacts;    ///< Positions of the contacts in view, drawn first as dots
+        QVector<int> contact_tracks;  ///< Track index of each entry in contacts
+        int shaded_begin = 0;         ///< contacts from here on lie in the shaded region
+        QVector<quint64> shaded_mask; ///< Bit per track, set inside the shaded region (halfplanekernel.h)
+        QVector<int> culled;          ///< Scratch: tracks in view before the shaded partition
+        QVector<MarkerItem> markers;  ///< Drawn over the contacts
+        ArrowBatch arrows;            ///< Contact leaders, then own and target vectors
+        QRectF bounds;                ///< Union of the item bounds (incl. pen and antialiasing)
+    };
+
+    static const QRgb kContactColor;      ///< Contact dots and velocity leaders
+    static const QRgb kShadedContactColor; ///< Contacts inside the shaded region
+    static const qreal kContactRadius;    ///< Contact dot radius
+    static const QRgb kEstimateColor;     ///< Filtered vector of the adopted track
+
+    /**
+     * @brief Constructs a renderer with the default sensor line
+     */
+    TSARenderer();
+
+    /**
+     * @brief Renders one frame, or the part of it inside a dirty rectangle
+     * @param p Active painter on the target device
+     * @param size Target size in device-independent pixels
+     * @param dpr Device pixel ratio of the target
+     * @param snap Simulation state to draw
+     * @param dirty Area to repaint; a null rectangle repaints everything
+     */
+    void render(QPainter &p, const QSize &size, qreal dpr, const SimSnapshot &snap,
+                const QRect &dirty = QRect());
+
+    /**
+     * @brief Area the dynamic layer of a snapshot will cover
+     *
+     * Bounding box of the markers, vectors and overlay that render()
+     * would draw for the snapshot, or the whole target if the static
+     * layer would have to be rebuilt first. Repainting the union of this
+     * and dynamicBounds() of the previous frame updates the display.
+     *
+     * @param size Target size in device-independent pixels
+     * @param dpr Device pixel ratio of the target
+     * @param snap Simulation state about to be drawn
+     * @return Damage rectangle in target coordinates
+     */
+    QRect damageRect(const QSize &size, qreal dpr, const SimSnapshot &snap);
+
+    /**
+     * @brief Lays out one frame without drawing it, for other backends
+     *
+     * Updates the static-layer geometry (and the cached pixmap, unless
+     * the cache is disabled) and returns the markers and vectors render()
+     * would draw; valid until the next call.
+     *
+     * @param size Target size in device-independent pixels
+     * @param dpr Device pixel ratio of the target
+     * @param snap Simulation state to lay out
+     * @return Dynamic layer of the frame
+     */
+    const DynamicLayer &layout(const QSize &size, qreal dpr, const SimSnapshot &snap);
+
+    /**
+     * @brief Track under a point of the display
+     *
+     * Maps the point into the snapshot's relative nautical-mile frame
+     * around the own ship marker of the last render() or layout() and
+     * asks the snapshot's spatial index for the nearest contact.
+     *
+     * @param snap Snapshot on screen
+     * @param pos Point in target coordinates
+     * @param radius_px Pick tolerance (pixels)
+     * @return Track index, -1 if no contact is within the tolerance
+     */
+    int pickTrack(const SimSnapshot &snap, const QPointF &pos, qreal radius_px) const;
+
+    /**
+     * @brief Static-layer geometry of the last render() or layout()
+     */
+    const BeamGeometry &beamGeometry() const { return background_geometry; }
+
+    /**
+     * @brief Draws p50/p99/max of every recorded PerfSection
+     * @param p QPainter reference for drawing
+     * @return Area of the overlay box
+     */
+    static QRect drawPerfOverlay(QPainter &p);
+
+    /**
+     * @brief Area covered by the dynamic layer of the last render()
+     */
+    QRect dynamicBounds() const { return dynamic_bounds; }
+
+    /**
+     * @brief Moves the sensor beam line and invalidates the static layer
+     * @param start Start point of the beam (widget coordinates)
+     * @param end End point of the beam (widget coordinates)
+     */
+    void setSensorLine(const QPointF &start, const QPointF &end);
+
+    /**
+     * @brief Enables or disables the cached static layer (default on)
+     * @param enabled true to blit the cached pixmap, false to redraw it
+     */
+    void setBackgroundCacheEnabled(bool enabled);
+
+    /**
+     * @brief Sets how the shaded half-space is hatched and invalidates the static layer
+     * @param style Fill method, spacing, angle, width and colour
+     */
+    void setHatchStyle(const HatchStyle &style);
+
+    /**
+     * @brief Current hatch style
+     */
+    const HatchStyle &hatchStyle() const { return config.hatch; }
+
+    /**
+     * @brief Applies display parameters, invalidating only what depends on them
+     *
+     * Beam changes invalidate the static layer, hatch line changes the
+     * tile as well; vector scales take effect at the next layout. The
+     * simulation step is not used here.
+     *
+     * @param display New parameters
+     * @return DisplayConfig::Change bits of what differed
+     */
+    unsigned setConfig(const DisplayConfig &display);
+
+    /**
+     * @brief Display parameters in use
+     */
+    const DisplayConfig &displayConfig() const { return config; }
+
+    /**
+     * @brief Forces the static layer to be rebuilt on the next frame
+     */
+    void invalidateBackground() { background_valid = false; }
+
+    /**
+     * @brief Shows or hides the timing overlay (PerfStats percentiles)
+     * @param enabled true to draw the overlay in the top-left corner
+     */
+    void setPerfOverlayEnabled(bool enabled) { perf_overlay_enabled = enabled; }
+
+    /**
+     * @brief Gets the current own ship position on display
+     * @return QPointF representing ship position in widget coordinates
+     */
+    QPointF getShipPosition() const;
+
+    /**
+     * @brief Gets the current sensor position on the display
+     * @return QPointF representing sensor position in widget coordinates
+     */
+    QPointF getSensorPosition() const;
+
+private:
+    // ===== DRAWING HELPER METHODS =====
+
+    /**
+     * @brief Own ship vector of a snapshot in widget coordinates
+     */
+    QPointF shipVectorFor(const SimSnapshot &snap) const;
+
+    /**
+     * @brief Lays out markers and vectors for a snapshot
+     *
+     * Uses the current static-layer geometry; call ensureBackground() (or
+     * check backgroundStale()) first. Contacts whose dot and leader
+     * cannot reach the target are culled with the snapshot's spatial
+     * index.
+     *
+     * @param snap Simulation state to draw
+     * @param shipVector Own ship vector in widget coordinates
+     * @param layer Receives the items and their bounds
+     */
+    void layoutDynamicLayer(const SimSnapshot &snap, const QPointF &shipVector,
+                            DynamicLayer &layer) const;
+
+    /**
+     * @brief true if the static layer must be rebuilt for these inputs
+     */
+    bool backgroundStale(const QSize &size, qreal dpr, const QPointF &shipVector) const;
+
+    /**
+     * @brief Computes the beam, outline and shaded half-space geometry
+     * @param bounds Target rectangle
+     * @param shipVector Own ship vector in widget coordinates
+     * @return Geometry of the static layer
+     */
+    BeamGeometry computeBeamGeometry(const QRectF &bounds, const QPointF &shipVector) const;
+
+    /**
+     * @brief Draws the static layer: background, hatch, outline and beam
+     * @param p QPainter reference for drawing
+     * @param geom Geometry from computeBeamGeometry()
+     * @param bounds Area to clear to black
+     */
+    void drawStaticLayer(QPainter &p, const BeamGeometry &geom, const QRect &bounds);
+
+    /**
+     * @brief Brush for the shaded half-space on a target with this DPR
+     *
+     * Renders the hatch tile on first use and whenever the DPR changes.
+     */
+    QBrush hatchBrush(qreal dpr);
+
+    /**
+     * @brief Rebuilds the cached static layer if its inputs changed
+     * @param size Target size in device-independent pixels
+     * @param dpr Device pixel ratio of the target
+     * @param shipVector Own ship vector in widget coordinates
+     */
+    void ensureBackground(const QSize &size, qreal dpr, const QPointF &shipVector);
+
+    // ===== STATIC LAYER CACHE =====
+
+    QPixmap background_cache;         ///< Rasterized static layer
+    BeamGeometry background_geometry; ///< Geometry the cache was built from
+    bool background_valid;            ///< false after resize or beam change
+    bool background_cache_enabled;    ///< Blit the cache instead of redrawing
+    QSize background_size;            ///< Target size the cache was built for
+    qreal background_dpr;             ///< Device pixel ratio of the cache
+    QPointF background_ship_vector;   ///< Own ship vector the cache was built for
+
+    // ===== HATCH =====
+
+    QPixmap hatch_tile;               ///< Rendered tile, null until first use
+    qreal hatch_tile_dpr;             ///< DPR the tile was rendered for
+
+    // ===== DYNAMIC LAYER =====
+
+    DynamicLayer dynamic_layer;       ///< Layout of the frame being drawn
+    DynamicLayer damage_layer;        ///< Layout used by damageRect()
+    QRect dynamic_bounds;             ///< Damage of the last render()
+    QRect perf_overlay_rect;          ///< Box of the last drawn overlay
+
+    // ===== DISPLAY GEOMETRY =====
+    DisplayConfig config;             ///< Beam fractions, gap, vector scales and hatch
+    QPointF sensor_line_start;        ///< Start point of sensor beam line
+    QPointF sensor_line_end;          ///< End point of sensor beam line
+    bool perf_overlay_enabled;        ///< Draw the timing overlay
+};
+
+#endif // TSARENDERER_H